@@ -15,6 +15,50 @@
 #include <cctype>    // Para toupper
 #include <numeric>   // Para std::accumulate
 #include <functional> // Para std::function
+#include <array>     // Para las listas de campos del esquema de registros
+#include <string_view> // Para parámetros y campos CSV sin copias
+#include <charconv>  // Para from_chars (conversión numérica sin excepciones)
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h> // Intrínsecos SIMD para la suma de series
+#endif
+#include <cstdio>    // Para fopen/fwrite en escritura con buffer grande
+#include <cstring>   // Para memcpy/strlen
+#include <cstdint>   // Para enteros de ancho fijo
+#include <cmath>     // Para pow
+#include <thread>    // Para generar tablas en paralelo
+#include <filesystem> // Para crear directorios y consultar tamaños de archivo
+#include <atomic>    // Para contadores de metricas sin candados
+#include <mutex>     // Para el registro de bloques de metricas por hilo
+#include <memory>    // Para unique_ptr
+#include <new>       // Para bad_alloc (conteo de asignaciones)
+#include <cstdlib>   // Para malloc/free
+#include <unordered_map> // Totales por vendedor en el motor de ventas
+#include <map>       // Acumulados de ingresos ordenados por año
+#include <condition_variable> // Para despertar al agregador de ventas concurrentes
+#include <deque>     // Colas de consultas del servidor
+#include <csignal>   // Para detener el servidor con Ctrl+C
+#include <cerrno>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // LockFileEx para los candados entre procesos
+#include <io.h>      // _commit para la barrera de durabilidad del escritor
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <process.h> // _getpid para los temporales
+#include <malloc.h>  // _aligned_malloc para el conteo de asignaciones alineadas
+#else
+#include <unistd.h>  // fsync para la barrera de durabilidad del escritor
+#include <fcntl.h>
+#include <sys/file.h> // flock para los candados entre procesos
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>   // Ciclo de eventos del servidor de consultas
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
 
 using namespace std;
 
@@ -57,17 +101,46 @@ struct DatosEmpresa {
 	int anioInicio; // Se añade para el cálculo de años trabajando
 };
 
-// NUEVA ESTRUCTURA para manejar registros del Método Burbuja (ingresos_camiones.csv)
+// ======================= ESTRUCTURAS DE DATOS PARA LISTAS (CASE 6) =======================
+
+// Montos de dinero en centavos (entero exacto): $1234.50 se guarda como 123450
+using Centavos = int64_t;
+
+// 1. Método Burbuja (ingresos_camiones.csv)
 struct IngresoRecord {
 	string camion;
 	string chofer;
-	vector<double> ingresos; // Siempre 7 ingresos (Días 1-7)
+	vector<Centavos> ingresos; // Días 1-7
+	Centavos total;
+	string semana;             // Semana ISO "AAAA-Www"; vacía en registros anteriores
+};
+const string NOMBRE_ARCHIVO_INGRESOS = "ingresos_camiones.csv";
+
+// 2. Método Selección (taller_camiones.csv)
+struct TallerRecord {
+	string camion;
+	string encargado;
+	string taller;
+	vector<Centavos> costos; // Visitas
+	Centavos total;
+};
+const string NOMBRE_ARCHIVO_TALLER = "taller_camiones.csv";
+
+// 3. Método Inserción (kilometraje_camiones.csv)
+struct KilometrajeRecord {
+	string camion;
+	string chofer;
+	vector<double> km; // Días
 	double total;
 };
+const string NOMBRE_ARCHIVO_KM = "kilometraje_camiones.csv";
 
 
 // ======================= VARIABLES GLOBALES =======================
 
+// Primer inicializador del programa: el perfil de arranque mide desde aquí
+const chrono::steady_clock::time_point INICIO_PROGRAMA = chrono::steady_clock::now();
+
 // Pila para simular los camiones que están actualmente dentro del patio.
 stack<RegistroCamion> camionesEnPatio;
 const int MAX_CAMIONES = 5; // Límite de camiones en el patio
@@ -82,6 +155,675 @@ DatosEmpresa datosDefault = {
 	2020 // Ejemplo de año de inicio
 };
 
+// ======================= DECLARACIONES ADELANTADAS =======================
+// Los métodos de captura regresan al menú de listas y el menú de listas regresa a los
+// métodos, por eso se declaran aquí.
+
+void metodoBurbuja();
+void metodoSeleccion();
+void metodoInsercion();
+
+// Avisos del CRUD de ingresos a los acumulados por semana, mes y año (ver ROLLUPS DE INGRESOS)
+void registroAgregado(const IngresoRecord& record);
+void registroRetirado(const IngresoRecord& record);
+void tablaGuardada(const IngresoRecord*);
+void tablaNoGuardada(const IngresoRecord*);
+
+// Taller y kilometraje avisan a la detección de anomalías (ver ANOMALÍAS DE TALLER Y KILOMETRAJE)
+void registroAgregado(const TallerRecord& record);
+void tablaGuardada(const TallerRecord*);
+void tablaNoGuardada(const TallerRecord*);
+void registroAgregado(const KilometrajeRecord& record);
+void tablaGuardada(const KilometrajeRecord*);
+void tablaNoGuardada(const KilometrajeRecord*);
+
+// Módulos que se inician al primer uso o en la precarga (ver ARRANQUE)
+enum class Modulo { Ventas, Registros, Ingresos, Taller, Kilometraje, Total };
+bool asegurarModulo(Modulo modulo);  // Lo inicia si falta (o espera a que la precarga lo termine); false si falló
+void reclamarModulo(Modulo modulo);  // El menú lo va a usar: la precarga ya no lo toca
+void mostrarPerfilArranque();
+
+// ======================= METRICAS E INSTRUMENTACION =======================
+// Temporizadores RAII y contadores siempre activos alrededor de las rutas calientes
+// (cargar, guardar, buscar, ordenar, patio). Cada hilo escribe solo en su propio bloque,
+// asi que el registro no usa candados; el menu de Diagnosticos suma todos los bloques.
+// Compilar con /DMETRICAS_HABILITADAS=0 (o -DMETRICAS_HABILITADAS=0) para eliminarlas.
+// El conteo de asignaciones reemplaza el operator new global; con -DCONTAR_ASIGNACIONES=0
+// se quita solo eso (por ejemplo, al enlazar con otro asignador) y se conservan las métricas.
+
+#ifndef METRICAS_HABILITADAS
+#define METRICAS_HABILITADAS 1
+#endif
+#if !METRICAS_HABILITADAS
+#undef CONTAR_ASIGNACIONES
+#define CONTAR_ASIGNACIONES 0
+#elif !defined(CONTAR_ASIGNACIONES)
+#define CONTAR_ASIGNACIONES 1
+#endif
+
+enum class OperacionMetrica {
+	CargarIngresos, CargarTaller, CargarKm,
+	GuardarIngresos, GuardarTaller, GuardarKm, GuardarMovimiento,
+	BuscarRegistro, OrdenarRegistros,
+	RegistrarEntrada, RegistrarSalida,
+	ProcesarLoteVentas,
+	CargarNomina, CalcularNomina,
+	ReporteCruzado,
+	ConsultaServidor,
+	SeriesKm,
+	DeteccionAnomalias,
+	Total
+};
+
+const char* const NOMBRES_OPERACION_METRICA[] = {
+	"cargarIngresosCSV", "cargarTallerCSV", "cargarKmCSV",
+	"guardarIngresosCSV", "guardarTallerCSV", "guardarKmCSV", "guardarMovimientoCSV",
+	"buscarRegistro", "ordenarRegistros",
+	"registrarEntrada", "registrarSalida",
+	"procesarLoteVentas",
+	"cargarNomina", "acumularNomina",
+	"reporteCruzado",
+	"consultaServidor",
+	"sumarSeriesKm",
+	"detectarAnomalias"
+};
+
+enum class ContadorMetrica {
+	FilasLeidas, BytesLeidos, BytesEscritos, ErroresParseo, AsignacionesCarga,
+	VentasRegistradas,
+	BloquesDescartados,
+	Total
+};
+
+const char* const NOMBRES_CONTADOR_METRICA[] = {
+	"Filas leidas", "Bytes leidos", "Bytes escritos", "Errores de parseo (catch)", "Asignaciones en cargas",
+	"Boletos vendidos", "Bloques descartados (indice)"
+};
+
+const size_t NUM_OPERACIONES_METRICA = static_cast<size_t>(OperacionMetrica::Total);
+const size_t NUM_CONTADORES_METRICA = static_cast<size_t>(ContadorMetrica::Total);
+const size_t NUM_CUBETAS_METRICA = 48; // Cubeta i: duraciones en [2^(i-1), 2^i) nanosegundos
+
+// Época de reinicio de las métricas. Reiniciar solo la avanza: cada hilo pone en cero su
+// propio bloque la próxima vez que registra algo, y al leer se ignoran los bloques que
+// todavía están en una época anterior. Así nadie escribe en el bloque de otro hilo.
+atomic<uint64_t> epocaReinicioMetricas{ 0 };
+
+// Bloque de un hilo. Un solo escritor por bloque: basta load+store relajados (sin lock).
+struct alignas(64) BloqueMetricasHilo {
+	atomic<uint64_t> llamadas[NUM_OPERACIONES_METRICA] = {};
+	atomic<uint64_t> nanosTotales[NUM_OPERACIONES_METRICA] = {};
+	atomic<uint64_t> nanosMaximo[NUM_OPERACIONES_METRICA] = {};
+	atomic<uint64_t> histograma[NUM_OPERACIONES_METRICA][NUM_CUBETAS_METRICA] = {};
+	atomic<uint64_t> contadores[NUM_CONTADORES_METRICA] = {};
+	atomic<uint64_t> epoca{ 0 };      // Época de reinicio a la que corresponden los valores
+
+	// Solo desde el hilo dueño: deja el bloque en cero si hubo un reinicio desde su último uso
+	void alcanzarEpoca() {
+		uint64_t vigente = epocaReinicioMetricas.load(memory_order_acquire);
+		if (epoca.load(memory_order_relaxed) == vigente) return;
+		for (size_t op = 0; op < NUM_OPERACIONES_METRICA; ++op) {
+			llamadas[op].store(0, memory_order_relaxed);
+			nanosTotales[op].store(0, memory_order_relaxed);
+			nanosMaximo[op].store(0, memory_order_relaxed);
+			for (auto& cubeta : histograma[op]) cubeta.store(0, memory_order_relaxed);
+		}
+		for (auto& c : contadores) c.store(0, memory_order_relaxed);
+		epoca.store(vigente, memory_order_release);
+	}
+};
+
+inline void sumarRelajado(atomic<uint64_t>& celda, uint64_t valor) {
+	celda.store(celda.load(memory_order_relaxed) + valor, memory_order_relaxed);
+}
+
+// Registro global de bloques: solo se toca al crear el bloque de un hilo nuevo o al leer.
+class RegistroMetricas {
+	mutex candado;
+	vector<unique_ptr<BloqueMetricasHilo>> bloques; // Se conservan aunque el hilo termine
+public:
+	static RegistroMetricas& instancia() {
+		static RegistroMetricas registro;
+		return registro;
+	}
+	BloqueMetricasHilo* nuevoBloque() {
+		lock_guard<mutex> guardia(candado);
+		bloques.push_back(make_unique<BloqueMetricasHilo>());
+		return bloques.back().get();
+	}
+	// Suma de todos los hilos (lecturas relajadas: es una foto aproximada, no bloquea a nadie)
+	void acumular(uint64_t llamadas[], uint64_t nanos[], uint64_t maximo[],
+		uint64_t histograma[][NUM_CUBETAS_METRICA], uint64_t contadores[]) {
+		lock_guard<mutex> guardia(candado);
+		const uint64_t vigente = epocaReinicioMetricas.load(memory_order_acquire);
+		for (const auto& b : bloques) {
+			if (b->epoca.load(memory_order_acquire) != vigente) continue; // Aún no se pone en cero
+			for (size_t op = 0; op < NUM_OPERACIONES_METRICA; ++op) {
+				llamadas[op] += b->llamadas[op].load(memory_order_relaxed);
+				nanos[op] += b->nanosTotales[op].load(memory_order_relaxed);
+				maximo[op] = max(maximo[op], b->nanosMaximo[op].load(memory_order_relaxed));
+				for (size_t c = 0; c < NUM_CUBETAS_METRICA; ++c) {
+					histograma[op][c] += b->histograma[op][c].load(memory_order_relaxed);
+				}
+			}
+			for (size_t c = 0; c < NUM_CONTADORES_METRICA; ++c) {
+				contadores[c] += b->contadores[c].load(memory_order_relaxed);
+			}
+		}
+	}
+	// No toca los bloques (sus hilos pueden estar escribiendo): cada uno se pone en cero solo
+	void reiniciar() { epocaReinicioMetricas.fetch_add(1, memory_order_acq_rel); }
+};
+
+inline BloqueMetricasHilo& metricasDelHilo() {
+	thread_local BloqueMetricasHilo* bloque = RegistroMetricas::instancia().nuevoBloque();
+	bloque->alcanzarEpoca();
+	return *bloque;
+}
+
+inline size_t cubetaMetrica(uint64_t nanos) {
+	size_t cubeta = 0;
+	while (nanos > 0 && cubeta < NUM_CUBETAS_METRICA - 1) { nanos >>= 1; ++cubeta; }
+	return cubeta;
+}
+
+inline void registrarDuracionMetrica(OperacionMetrica op, uint64_t nanos) {
+	BloqueMetricasHilo& b = metricasDelHilo();
+	size_t i = static_cast<size_t>(op);
+	sumarRelajado(b.llamadas[i], 1);
+	sumarRelajado(b.nanosTotales[i], nanos);
+	if (nanos > b.nanosMaximo[i].load(memory_order_relaxed)) b.nanosMaximo[i].store(nanos, memory_order_relaxed);
+	sumarRelajado(b.histograma[i][cubetaMetrica(nanos)], 1);
+}
+
+inline void sumarContadorMetrica(ContadorMetrica c, uint64_t valor) {
+	sumarRelajado(metricasDelHilo().contadores[static_cast<size_t>(c)], valor);
+}
+
+// Mide el tiempo de vida del objeto y lo registra al salir del alcance
+class TemporizadorMetrica {
+	OperacionMetrica operacion;
+	chrono::steady_clock::time_point inicio;
+public:
+	explicit TemporizadorMetrica(OperacionMetrica op) : operacion(op), inicio(chrono::steady_clock::now()) {}
+	~TemporizadorMetrica() {
+		auto nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+		registrarDuracionMetrica(operacion, static_cast<uint64_t>(nanos));
+	}
+	TemporizadorMetrica(const TemporizadorMetrica&) = delete;
+	TemporizadorMetrica& operator=(const TemporizadorMetrica&) = delete;
+};
+
+// Asignaciones de memoria hechas por el hilo. Es un entero thread_local sin inicialización
+// dinámica, así que operator new puede incrementarlo sin riesgo de recursión.
+thread_local uint64_t asignacionesDelHilo = 0;
+
+// Suma al contador las asignaciones hechas mientras el objeto está vivo
+class MedidorAsignaciones {
+	ContadorMetrica contador;
+	uint64_t inicio;
+public:
+	explicit MedidorAsignaciones(ContadorMetrica c) : contador(c), inicio(asignacionesDelHilo) {}
+	~MedidorAsignaciones() { sumarContadorMetrica(contador, asignacionesDelHilo - inicio); }
+	MedidorAsignaciones(const MedidorAsignaciones&) = delete;
+	MedidorAsignaciones& operator=(const MedidorAsignaciones&) = delete;
+};
+
+#if METRICAS_HABILITADAS
+#define MEDIR_OPERACION_VALOR(op) TemporizadorMetrica temporizadorMetrica_(op)
+#define MEDIR_OPERACION(op) MEDIR_OPERACION_VALOR(OperacionMetrica::op)
+#define CONTAR_METRICA(contador, valor) sumarContadorMetrica(ContadorMetrica::contador, static_cast<uint64_t>(valor))
+#else
+#define MEDIR_OPERACION_VALOR(op) ((void)0)
+#define MEDIR_OPERACION(op) ((void)0)
+#define CONTAR_METRICA(contador, valor) ((void)sizeof(valor)) // Sin evaluar: solo evita avisos de variables sin usar
+#endif
+
+#if CONTAR_ASIGNACIONES
+#define MEDIR_ASIGNACIONES(contador) MedidorAsignaciones medidorAsignaciones_(ContadorMetrica::contador)
+
+// Reemplazo global de new solo para contar asignaciones (el diagnóstico reporta
+// asignaciones por fila cargada). Todas las formas de delete se reemplazan junto con él y
+// liberan con free (así lo exigen también los verificadores de memoria, que marcan un malloc
+// liberado por el delete de la biblioteca). Ninguno se deja expandir en línea: expandidos,
+// el compilador ve un malloc liberado con delete o con free y avisa en falso.
+#if defined(_MSC_VER)
+#define NO_EN_LINEA __declspec(noinline)
+#else
+#define NO_EN_LINEA __attribute__((noinline))
+#endif
+NO_EN_LINEA void* operator new(size_t tam) {
+	++asignacionesDelHilo;
+	if (void* p = malloc(tam ? tam : 1)) return p;
+	throw bad_alloc();
+}
+void* operator new[](size_t tam) { return ::operator new(tam); }
+NO_EN_LINEA void operator delete(void* p) noexcept { free(p); }
+NO_EN_LINEA void operator delete[](void* p) noexcept { free(p); }
+NO_EN_LINEA void operator delete(void* p, size_t) noexcept { free(p); }
+NO_EN_LINEA void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// Las formas alineadas (tipos con alignas mayor al de malloc, como los bloques de métricas)
+// también cuentan. Su delete se reemplaza junto con ellas: en MSVC la memoria de
+// _aligned_malloc solo se puede liberar con _aligned_free.
+NO_EN_LINEA void* operator new(size_t tam, align_val_t alineacion) {
+	++asignacionesDelHilo;
+	const size_t a = max(static_cast<size_t>(alineacion), sizeof(void*));
+#ifdef _WIN32
+	if (void* p = _aligned_malloc(tam ? tam : 1, a)) return p;
+#else
+	void* p = nullptr;
+	if (posix_memalign(&p, a, tam ? tam : 1) == 0) return p;
+#endif
+	throw bad_alloc();
+}
+void* operator new[](size_t tam, align_val_t alineacion) { return ::operator new(tam, alineacion); }
+void operator delete(void* p, align_val_t) noexcept {
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+void operator delete[](void* p, align_val_t alineacion) noexcept { ::operator delete(p, alineacion); }
+void operator delete(void* p, size_t, align_val_t alineacion) noexcept { ::operator delete(p, alineacion); }
+void operator delete[](void* p, size_t, align_val_t alineacion) noexcept { ::operator delete(p, alineacion); }
+#undef NO_EN_LINEA
+#else
+#define MEDIR_ASIGNACIONES(contador) ((void)0)
+#endif
+
+// ======================= CANDADOS DE ARCHIVO (VARIOS PROCESOS) =======================
+// Varias instancias del programa (taquillas, reportes, el servidor) pueden compartir el mismo
+// directorio de datos. Cada tabla tiene un candado consultivo en '<archivo>.lock' (flock, o
+// LockFileEx en Windows): las lecturas lo toman compartido y las escrituras exclusivo, pero
+// solo el instante del rename o del write() (el contenido se prepara antes, sin candado).
+// Un reemplazo se arma con lo que se leyó antes: con el candado tomado se compara la firma
+// (tamaño y fecha) del archivo con la de esa lectura y, si otro proceso lo cambió, no se
+// renombra (ver FirmaArchivo).
+// El candado va en un archivo aparte porque el rename cambia el archivo de datos.
+
+enum class ModoCandado { Compartido, Exclusivo };
+
+class CandadoArchivo {
+#ifdef _WIN32
+	HANDLE archivo = INVALID_HANDLE_VALUE;
+#else
+	int fd = -1;
+#endif
+
+public:
+	// Bloquea hasta obtener el candado; si no se puede crear el .lock se sigue sin candado
+	CandadoArchivo(const string& ruta, ModoCandado modo) {
+		const string rutaCandado = ruta + ".lock";
+#ifdef _WIN32
+		archivo = CreateFileA(rutaCandado.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		OVERLAPPED inicio{};
+		if (archivo != INVALID_HANDLE_VALUE &&
+			!LockFileEx(archivo, modo == ModoCandado::Exclusivo ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD, &inicio)) {
+			CloseHandle(archivo);
+			archivo = INVALID_HANDLE_VALUE;
+		}
+#else
+		fd = open(rutaCandado.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (fd < 0) return;
+		int resultado;
+		while ((resultado = flock(fd, modo == ModoCandado::Exclusivo ? LOCK_EX : LOCK_SH)) < 0 && errno == EINTR) {}
+		if (resultado < 0) { close(fd); fd = -1; }
+#endif
+	}
+	~CandadoArchivo() {
+#ifdef _WIN32
+		if (archivo != INVALID_HANDLE_VALUE) {
+			OVERLAPPED inicio{};
+			UnlockFileEx(archivo, 0, MAXDWORD, MAXDWORD, &inicio);
+			CloseHandle(archivo);
+		}
+#else
+		if (fd >= 0) { flock(fd, LOCK_UN); close(fd); }
+#endif
+	}
+	CandadoArchivo(const CandadoArchivo&) = delete;
+	CandadoArchivo& operator=(const CandadoArchivo&) = delete;
+};
+
+// Temporal propio del proceso para reemplazar 'ruta' con un rename
+string rutaTemporal(const string& ruta) {
+#ifdef _WIN32
+	return ruta + ".tmp." + to_string(_getpid());
+#else
+	return ruta + ".tmp." + to_string(getpid());
+#endif
+}
+
+// Tamaño y fecha de modificación de un archivo: si cambian, alguien escribió en él
+struct FirmaArchivo {
+	bool existe = false;
+	uint64_t tamano = 0;
+	int64_t modificado = 0;
+
+	bool operator==(const FirmaArchivo& otra) const {
+		return existe == otra.existe && tamano == otra.tamano && modificado == otra.modificado;
+	}
+	bool operator!=(const FirmaArchivo& otra) const { return !(*this == otra); }
+};
+
+FirmaArchivo firmaArchivo(const string& ruta) {
+	FirmaArchivo firma;
+	error_code ec;
+	uintmax_t tam = filesystem::file_size(ruta, ec);
+	if (ec) return firma;
+	auto fecha = filesystem::last_write_time(ruta, ec);
+	firma.existe = true;
+	firma.tamano = static_cast<uint64_t>(tam);
+	firma.modificado = ec ? 0 : static_cast<int64_t>(fecha.time_since_epoch().count());
+	return firma;
+}
+
+enum class ResultadoEscritura { Escrita, Fallida, Conflicto };
+
+/**
+ * @brief Agrega 'datos' al final de 'ruta' con un solo write() en modo O_APPEND, con el candado
+ * exclusivo tomado: otro proceso nunca ve ni intercala una fila a medias. Si el archivo está
+ * vacío se escribe antes 'encabezadoSiVacio' (en el mismo write()).
+ * 'conocida' (si no es nullptr) es la firma que este proceso tiene del archivo: si aún
+ * coincide antes de escribir, se actualiza con la nueva; si no, se deja como está para que el
+ * siguiente reemplazo detecte lo que agregó el otro proceso.
+ */
+bool agregarEnArchivo(const string& ruta, string_view encabezadoSiVacio, string& datos, FirmaArchivo* conocida = nullptr) {
+	CandadoArchivo candado(ruta, ModoCandado::Exclusivo);
+	const bool vigente = conocida && firmaArchivo(ruta) == *conocida;
+	bool exito;
+#ifdef _WIN32
+	int fd = _open(ruta.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_TEXT, _S_IREAD | _S_IWRITE);
+	if (fd < 0) return false;
+	if (_filelength(fd) == 0) datos.insert(0, encabezadoSiVacio);
+	exito = _write(fd, datos.data(), static_cast<unsigned>(datos.size())) == static_cast<int>(datos.size());
+	exito = (_close(fd) == 0) && exito;
+#else
+	int fd = open(ruta.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0) return false;
+	struct stat info {};
+	if (fstat(fd, &info) == 0 && info.st_size == 0) datos.insert(0, encabezadoSiVacio);
+	size_t escrito = 0;
+	while (escrito < datos.size()) {
+		ssize_t n = write(fd, datos.data() + escrito, datos.size() - escrito);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) break;
+		escrito += static_cast<size_t>(n);
+	}
+	exito = (close(fd) == 0) && escrito == datos.size();
+#endif
+	if (vigente) *conocida = firmaArchivo(ruta);
+	return exito;
+}
+
+/**
+ * @brief Reemplaza 'ruta' por 'contenido': se escribe un temporal y se renombra con el candado
+ * exclusivo. Si 'conocida' no es nullptr y el archivo ya no tiene esa firma (otro proceso lo
+ * modificó después de leerlo), no se renombra: Conflicto. Al escribir, 'conocida' pasa a ser
+ * la firma nueva.
+ */
+ResultadoEscritura reemplazarArchivo(const string& ruta, const string& contenido, FirmaArchivo* conocida = nullptr) {
+	const string temporal = rutaTemporal(ruta);
+	FILE* f = fopen(temporal.c_str(), "w");
+	if (!f) return ResultadoEscritura::Fallida;
+	bool exito = fwrite(contenido.data(), 1, contenido.size(), f) == contenido.size();
+	exito = (fclose(f) == 0) && exito;
+	error_code ec;
+	ResultadoEscritura resultado = exito ? ResultadoEscritura::Escrita : ResultadoEscritura::Fallida;
+	if (exito) {
+		CandadoArchivo candado(ruta, ModoCandado::Exclusivo);
+		if (conocida && firmaArchivo(ruta) != *conocida) resultado = ResultadoEscritura::Conflicto;
+		else {
+			filesystem::rename(temporal, ruta, ec);
+			if (ec) resultado = ResultadoEscritura::Fallida;
+			else if (conocida) *conocida = firmaArchivo(ruta);
+		}
+	}
+	if (resultado != ResultadoEscritura::Escrita) filesystem::remove(temporal, ec);
+	return resultado;
+}
+
+// ======================= ESCRITURA ASÍNCRONA DE ARCHIVOS =======================
+// Los guardados del CRUD y del patio no esperan al disco: el contenido se arma en memoria y
+// un hilo escritor lo pasa al archivo. Cada archivo tiene dos buffers: en uno se acumula lo
+// que llega (las ediciones seguidas se juntan: un reemplazo descarta lo anterior y los
+// agregados se concatenan) y el otro es el que el hilo está escribiendo.
+// Quien lee un archivo espera antes a que se escriba lo pendiente de ese archivo (y luego toma
+// su candado compartido: ver abrirLectura), y tamanoArchivo() ya da el tamaño que tendrá.
+// sincronizar() es la barrera de durabilidad: espera todo lo pendiente y hace fsync de lo escrito.
+
+class EscritorArchivos {
+	struct Pendiente {
+		string datos;                 // Buffer de llegada
+		string encabezado;            // Para los agregados, si el archivo está vacío al escribir
+		bool reemplazar = false;      // true: 'datos' es el archivo completo
+		bool enCola = false;
+		bool enCurso = false;         // El hilo escritor tiene este archivo en su buffer
+		uint64_t tamanoFinal = 0;     // Tamaño que tendrá cuando se escriba todo
+	};
+
+	mutex candado;
+	condition_variable hayTrabajo, escrito;
+	unordered_map<string, Pendiente> archivos;
+	deque<string> cola;
+	vector<string> sinSincronizar;    // Escritos desde la última barrera
+	vector<pair<string, ResultadoEscritura>> fallidas; // Sin reportar (ver reportarFallosEscritura)
+	unordered_map<string, FirmaArchivo> firmas; // Firma de la última carga completa o escritura propia
+	uint64_t fallos = 0;
+	uint64_t escrituras = 0;          // Escrituras físicas (menos que los guardados si se juntaron)
+	bool detenido = false;
+	thread hilo;
+
+	static uint64_t tamanoEnDisco(const string& ruta) {
+		error_code ec;
+		uintmax_t tam = filesystem::file_size(ruta, ec);
+		return ec ? 0 : static_cast<uint64_t>(tam);
+	}
+
+	// Con el candado tomado: registra el archivo la primera vez y lo forma en la cola
+	Pendiente& entrada(const string& ruta) {
+		auto [it, nuevo] = archivos.try_emplace(ruta);
+		if (nuevo) it->second.tamanoFinal = tamanoEnDisco(ruta);
+		if (!it->second.enCola) {
+			it->second.enCola = true;
+			cola.push_back(ruta);
+		}
+		return it->second;
+	}
+
+	void escribir() {
+		string buffer;                // Segundo buffer: se intercambia con el de llegada
+		unique_lock<mutex> guardia(candado);
+		while (true) {
+			hayTrabajo.wait(guardia, [this]() { return detenido || !cola.empty(); });
+			if (cola.empty()) return;
+			string ruta = move(cola.front());
+			cola.pop_front();
+			Pendiente& p = archivos[ruta];
+			p.enCola = false;
+			p.enCurso = true;
+			swap(buffer, p.datos);
+			p.datos.clear();
+			const bool reemplazar = p.reemplazar;
+			p.reemplazar = false;
+			string encabezado = move(p.encabezado);
+			p.encabezado.clear();
+			auto firma = firmas.find(ruta);
+			const bool conFirma = firma != firmas.end();
+			FirmaArchivo conocida = conFirma ? firma->second : FirmaArchivo{};
+			guardia.unlock();
+
+			ResultadoEscritura resultado = reemplazar ? reemplazarArchivo(ruta, buffer, conFirma ? &conocida : nullptr)
+				: agregarEnArchivo(ruta, encabezado, buffer, conFirma ? &conocida : nullptr) ? ResultadoEscritura::Escrita : ResultadoEscritura::Fallida;
+			const bool exito = resultado == ResultadoEscritura::Escrita;
+			CONTAR_METRICA(BytesEscritos, exito ? buffer.size() : 0);
+			buffer.clear();
+
+			guardia.lock();
+			if (conFirma) firmas[ruta] = conocida;
+			if (!exito) {
+				++fallos;
+				fallidas.emplace_back(ruta, resultado);
+			}
+			++escrituras;
+			if (find(sinSincronizar.begin(), sinSincronizar.end(), ruta) == sinSincronizar.end()) sinSincronizar.push_back(ruta);
+			p.enCurso = false;
+			if (!p.enCola) archivos.erase(ruta);
+			escrito.notify_all();
+		}
+	}
+
+public:
+	EscritorArchivos() : hilo([this]() { escribir(); }) {}
+	~EscritorArchivos() {
+		{
+			lock_guard<mutex> guardia(candado);
+			detenido = true;              // El hilo vacía la cola antes de salir
+		}
+		hayTrabajo.notify_one();
+		hilo.join();
+	}
+	EscritorArchivos(const EscritorArchivos&) = delete;
+	EscritorArchivos& operator=(const EscritorArchivos&) = delete;
+
+	// El archivo queda con 'contenido' (las escrituras pendientes anteriores se descartan)
+	void reemplazar(const string& ruta, string&& contenido) {
+		{
+			lock_guard<mutex> guardia(candado);
+			Pendiente& p = entrada(ruta);
+			p.datos = move(contenido);
+			p.encabezado.clear();
+			p.reemplazar = true;
+			p.tamanoFinal = p.datos.size();
+		}
+		hayTrabajo.notify_one();
+	}
+
+	// Agrega 'datos' al final; si el archivo está vacío al escribir, primero 'encabezadoSiVacio'
+	// (lo decide el hilo escritor con el candado tomado: otro proceso pudo crearlo mientras)
+	void agregar(const string& ruta, string_view datos, string_view encabezadoSiVacio = {}) {
+		{
+			lock_guard<mutex> guardia(candado);
+			Pendiente& p = entrada(ruta);
+			if (p.tamanoFinal == 0) {
+				if (p.reemplazar) p.datos.append(encabezadoSiVacio);
+				else p.encabezado.assign(encabezadoSiVacio);
+				p.tamanoFinal += encabezadoSiVacio.size();
+			}
+			p.datos.append(datos);
+			p.tamanoFinal += datos.size();
+		}
+		hayTrabajo.notify_one();
+	}
+
+	// Tamaño que tendrá el archivo con lo pendiente; false si no hay nada pendiente
+	bool tamanoPendiente(const string& ruta, uint64_t& tam) {
+		lock_guard<mutex> guardia(candado);
+		auto it = archivos.find(ruta);
+		if (it == archivos.end()) return false;
+		tam = it->second.tamanoFinal;
+		return true;
+	}
+
+	uint64_t escriturasRealizadas() {
+		lock_guard<mutex> guardia(candado);
+		return escrituras;
+	}
+
+	// Una escritura hecha por fuera del escritor (el libro de ventas) que el disco rechazó
+	void anotarFallo(const string& ruta) {
+		lock_guard<mutex> guardia(candado);
+		++fallos;
+		fallidas.emplace_back(ruta, ResultadoEscritura::Fallida);
+	}
+
+	// Escrituras que fallaron desde la consulta anterior (no espera lo pendiente)
+	vector<pair<string, ResultadoEscritura>> tomarFallidas() {
+		lock_guard<mutex> guardia(candado);
+		vector<pair<string, ResultadoEscritura>> rutas;
+		swap(rutas, fallidas);
+		return rutas;
+	}
+
+	// Firma de 'ruta' al cargar la tabla completa: un reemplazo posterior solo se escribe si
+	// nadie más la cambió (ver reemplazarArchivo)
+	void anotarFirma(const string& ruta, const FirmaArchivo& firma) {
+		lock_guard<mutex> guardia(candado);
+		firmas[ruta] = firma;
+	}
+
+	// Antes de leer 'ruta': espera a que lo pendiente de ese archivo esté escrito
+	void esperar(const string& ruta) {
+		unique_lock<mutex> guardia(candado);
+		escrito.wait(guardia, [&]() { return archivos.find(ruta) == archivos.end(); });
+	}
+
+	/**
+	 * @brief Barrera de durabilidad: espera todas las escrituras pendientes y hace fsync de
+	 * los archivos escritos desde la barrera anterior.
+	 * @return false si alguna escritura o fsync falló desde la barrera anterior.
+	 */
+	bool sincronizar() {
+		vector<string> rutas;
+		uint64_t fallosPrevios;
+		{
+			unique_lock<mutex> guardia(candado);
+			escrito.wait(guardia, [this]() { return archivos.empty(); });
+			swap(rutas, sinSincronizar);
+			fallosPrevios = fallos;
+			fallos = 0;
+		}
+		bool exito = fallosPrevios == 0;
+		for (const string& ruta : rutas) {
+#ifdef _WIN32
+			int fd = _open(ruta.c_str(), _O_RDWR);
+			exito = fd >= 0 && _commit(fd) == 0 && exito;
+			if (fd >= 0) _close(fd);
+#else
+			int fd = open(ruta.c_str(), O_RDONLY);
+			exito = fd >= 0 && fsync(fd) == 0 && exito;
+			if (fd >= 0) close(fd);
+#endif
+		}
+		return exito;
+	}
+};
+
+EscritorArchivos escritorArchivos;
+
+// Los guardados solo se encolan: los menús avisan al volver a mostrarse si alguno no se escribió
+// @return true si había algún fallo que avisar
+bool reportarFallosEscritura() {
+	auto fallidas = escritorArchivos.tomarFallidas();
+	for (const auto& [ruta, resultado] : fallidas) {
+		if (resultado == ResultadoEscritura::Conflicto) {
+			cout << "!!! ERROR: Otro proceso modifico '" << ruta << "' despues de cargarlo; no se sobrescribio para no perder sus filas.\n"
+				<< "    Vuelva a abrir la lista y repita el cambio.\n";
+		}
+		else cout << "!!! ERROR: No se pudo escribir '" << ruta << "'; los ultimos cambios de ese archivo no quedaron en disco.\n";
+	}
+	return !fallidas.empty();
+}
+
+// Tamaño actual de un archivo (0 si no existe), contando lo que el escritor tiene pendiente
+uint64_t tamanoArchivo(const string& nombreArchivo) {
+	uint64_t pendiente;
+	if (escritorArchivos.tamanoPendiente(nombreArchivo, pendiente)) return pendiente;
+	error_code ec;
+	uintmax_t tam = filesystem::file_size(nombreArchivo, ec);
+	return ec ? 0 : static_cast<uint64_t>(tam);
+}
+
+// Antes de leer una tabla: lo pendiente de este proceso ya escrito y el candado compartido
+// tomado (en ese orden; esperar con el candado tomado bloquearía al escritor)
+CandadoArchivo abrirLectura(const string& ruta) {
+	escritorArchivos.esperar(ruta);
+	return CandadoArchivo(ruta, ModoCandado::Compartido);
+}
+
 // ======================= FUNCIONES GENERALES =======================
 void limpiarBuffer() {
 	cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -109,7 +851,22 @@ void pausaYLimpiar() {
 #endif
 }
 
-int pedirEntero(string mensaje) {
+// Guarda el formato numérico del flujo (fixed, precisión) y lo restaura al salir del alcance
+class FormatoFlujo {
+	ostream& flujo;
+	ios::fmtflags banderas;
+	streamsize precision;
+public:
+	explicit FormatoFlujo(ostream& f) : flujo(f), banderas(f.flags()), precision(f.precision()) {}
+	~FormatoFlujo() {
+		flujo.flags(banderas);
+		flujo.precision(precision);
+	}
+	FormatoFlujo(const FormatoFlujo&) = delete;
+	FormatoFlujo& operator=(const FormatoFlujo&) = delete;
+};
+
+int pedirEntero(string_view mensaje) {
 	int valor;
 	cout << mensaje;
 	if (!(cin >> valor)) {
@@ -121,18 +878,229 @@ int pedirEntero(string mensaje) {
 	return valor;
 }
 
-string pedirTexto(string mensaje) {
+string pedirTexto(string_view mensaje) {
 	string valor;
 	cout << mensaje;
 	getline(cin, valor);
 	return valor;
 }
 
+double pedirDouble(string_view mensaje) {
+	double valor;
+	cout << mensaje;
+	if (!(cin >> valor)) {
+		cin.clear();
+		limpiarBuffer();
+		return 0.0;
+	}
+	limpiarBuffer();
+	return valor;
+}
+
+// ---------------------- MONTOS EN CENTAVOS ----------------------
+
+/**
+ * @brief Convierte "1234.5", "-0.75" o "80" a centavos sin pasar por double.
+ * Los decimales después del segundo se redondean (mitades lejos de cero).
+ * @return false si el texto (sin espacios a los lados) no es todo un número o no cabe en 64 bits.
+ */
+bool convertirCentavos(string_view texto, Centavos& valor) {
+	while (!texto.empty() && (texto.front() == ' ' || texto.front() == '+')) texto.remove_prefix(1);
+	while (!texto.empty() && texto.back() == ' ') texto.remove_suffix(1);
+	bool negativo = !texto.empty() && texto.front() == '-';
+	if (negativo) texto.remove_prefix(1);
+
+	size_t i = 0;
+	uint64_t entero = 0;
+	int digitosEnteros = 0;
+	for (; i < texto.size() && texto[i] >= '0' && texto[i] <= '9'; ++i, ++digitosEnteros) {
+		if (digitosEnteros == 16) return false; // Mas de 10^16 pesos: fuera de rango
+		entero = entero * 10 + static_cast<uint64_t>(texto[i] - '0');
+	}
+	uint64_t fraccion = 0;
+	int digitosFraccion = 0;
+	bool redondearArriba = false;
+	if (i < texto.size() && texto[i] == '.') {
+		for (++i; i < texto.size() && texto[i] >= '0' && texto[i] <= '9'; ++i, ++digitosFraccion) {
+			if (digitosFraccion < 2) fraccion = fraccion * 10 + static_cast<uint64_t>(texto[i] - '0');
+			else if (digitosFraccion == 2) redondearArriba = texto[i] >= '5';
+		}
+	}
+	if (digitosEnteros == 0 && digitosFraccion == 0) return false;
+	if (i != texto.size()) return false; // "12abc" o "1e5": no se toma solo el principio
+	if (digitosFraccion == 1) fraccion *= 10;
+
+	int64_t centavos = static_cast<int64_t>(entero * 100 + fraccion + (redondearArriba ? 1 : 0));
+	valor = negativo ? -centavos : centavos;
+	return true;
+}
+
+// Escribe 'valor' como "-1234.50" en 'destino' (al menos 24 bytes); devuelve la longitud
+size_t formatearCentavos(char* destino, Centavos valor) {
+	char buffer[24];
+	char* p = buffer + sizeof(buffer);
+	uint64_t magnitud = valor < 0 ? 0 - static_cast<uint64_t>(valor) : static_cast<uint64_t>(valor);
+	*--p = static_cast<char>('0' + magnitud % 10); magnitud /= 10;
+	*--p = static_cast<char>('0' + magnitud % 10); magnitud /= 10;
+	*--p = '.';
+	do { *--p = static_cast<char>('0' + magnitud % 10); magnitud /= 10; } while (magnitud);
+	if (valor < 0) *--p = '-';
+	size_t longitud = static_cast<size_t>(buffer + sizeof(buffer) - p);
+	memcpy(destino, p, longitud);
+	return longitud;
+}
+
+string textoCentavos(Centavos valor) {
+	char buffer[24];
+	return string(buffer, formatearCentavos(buffer, valor));
+}
+
+// Envoltura para imprimir centavos con '<<' (respeta setw/left/right como cualquier texto)
+struct Monto { Centavos centavos; };
+
+ostream& operator<<(ostream& os, Monto m) {
+	char buffer[24];
+	return os << string_view(buffer, formatearCentavos(buffer, m.centavos));
+}
+
+/**
+ * @brief Porcentaje de un monto, redondeado al centavo (mitades hacia arriba).
+ * El porcentaje va en centésimas (5000 = 50.00%), el mismo formato de dos decimales que los montos.
+ */
+Centavos aplicarPorcentaje(Centavos monto, int64_t centesimasPorcentaje) {
+	// Se separa el monto para que el producto no se desborde con montos grandes
+	Centavos alto = monto / 10000, bajo = monto % 10000;
+	return alto * centesimasPorcentaje + (bajo * centesimasPorcentaje + 5000) / 10000;
+}
+
+// Un porcentaje de descuento en centésimas debe quedar entre 0% y 100%
+inline bool porcentajeValido(int64_t centesimasPorcentaje) {
+	return centesimasPorcentaje >= 0 && centesimasPorcentaje <= 10000;
+}
+
+// Igual que pedirDouble, pero el monto se lee directo a centavos
+Centavos pedirMonto(string_view mensaje) {
+	string texto;
+	cout << mensaje;
+	if (!(cin >> texto)) {
+		cin.clear();
+		limpiarBuffer();
+		return 0;
+	}
+	limpiarBuffer();
+	Centavos valor = 0;
+	return convertirCentavos(texto, valor) ? valor : 0;
+}
+
+// ---------------------- SUMA DE SERIES (TOTALES) ----------------------
+// Todos los totales del programa pasan por aquí. Los montos son enteros (centavos) y
+// su suma es exacta. La suma de double (kilometraje) es compensada (Neumaier) para que
+// las series largas no acumulen error de redondeo. Ambas se calculan en varios carriles
+// a la vez con AVX/AVX2 o SSE2 cuando están disponibles.
+// Nota: no compilar con /fp:fast o -ffast-math, que eliminan la compensación.
+
+// Un paso de Neumaier: 'c' guarda lo que se perdió al redondear s + x
+inline void acumularNeumaier(double& s, double& c, double x) {
+	double t = s + x;
+	c += (fabs(s) >= fabs(x)) ? (s - t) + x : (x - t) + s;
+	s = t;
+}
+
+#if defined(__AVX__)
+#define SUMA_CARRILES 8
+inline void acumularNeumaierSimd(__m256d& s, __m256d& c, __m256d x) {
+	const __m256d sinSigno = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	__m256d t = _mm256_add_pd(s, x);
+	__m256d sMayor = _mm256_cmp_pd(_mm256_and_pd(s, sinSigno), _mm256_and_pd(x, sinSigno), _CMP_GE_OQ);
+	__m256d a = _mm256_add_pd(_mm256_sub_pd(s, t), x);
+	__m256d b = _mm256_add_pd(_mm256_sub_pd(x, t), s);
+	c = _mm256_add_pd(c, _mm256_blendv_pd(b, a, sMayor));
+	s = t;
+}
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMA_CARRILES 4
+inline void acumularNeumaierSimd(__m128d& s, __m128d& c, __m128d x) {
+	const __m128d sinSigno = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	__m128d t = _mm_add_pd(s, x);
+	__m128d sMayor = _mm_cmpge_pd(_mm_and_pd(s, sinSigno), _mm_and_pd(x, sinSigno));
+	__m128d a = _mm_add_pd(_mm_sub_pd(s, t), x);
+	__m128d b = _mm_add_pd(_mm_sub_pd(x, t), s);
+	c = _mm_add_pd(c, _mm_or_pd(_mm_and_pd(sMayor, a), _mm_andnot_pd(sMayor, b)));
+	s = t;
+}
+#else
+#define SUMA_CARRILES 4
+#endif
+
+// Suma compensada de 'n' valores
+double sumaCompensada(const double* valores, size_t n) {
+	double s[SUMA_CARRILES] = {}, c[SUMA_CARRILES] = {};
+	size_t i = 0;
+#if defined(__AVX__)
+	__m256d s0 = _mm256_setzero_pd(), s1 = s0, c0 = s0, c1 = s0;
+	for (; i + 8 <= n; i += 8) {
+		acumularNeumaierSimd(s0, c0, _mm256_loadu_pd(valores + i));
+		acumularNeumaierSimd(s1, c1, _mm256_loadu_pd(valores + i + 4));
+	}
+	_mm256_storeu_pd(s, s0); _mm256_storeu_pd(s + 4, s1);
+	_mm256_storeu_pd(c, c0); _mm256_storeu_pd(c + 4, c1);
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	__m128d s0 = _mm_setzero_pd(), s1 = s0, c0 = s0, c1 = s0;
+	for (; i + 4 <= n; i += 4) {
+		acumularNeumaierSimd(s0, c0, _mm_loadu_pd(valores + i));
+		acumularNeumaierSimd(s1, c1, _mm_loadu_pd(valores + i + 2));
+	}
+	_mm_storeu_pd(s, s0); _mm_storeu_pd(s + 2, s1);
+	_mm_storeu_pd(c, c0); _mm_storeu_pd(c + 2, c1);
+#else
+	for (; i + 4 <= n; i += 4) {
+		for (size_t k = 0; k < 4; ++k) acumularNeumaier(s[k], c[k], valores[i + k]);
+	}
+#endif
+	// Se combinan los carriles y el residuo con el mismo algoritmo
+	double suma = 0.0, compensacion = 0.0;
+	for (size_t k = 0; k < SUMA_CARRILES; ++k) {
+		acumularNeumaier(suma, compensacion, s[k]);
+		compensacion += c[k];
+	}
+	for (; i < n; ++i) acumularNeumaier(suma, compensacion, valores[i]);
+	return suma + compensacion;
+}
+
 // Calcula la suma de todos los valores de un vector
 double sumaValores(const vector<double>& valores) {
-	double suma = 0;
-	for (double val : valores) suma += val;
-	return suma;
+	return sumaCompensada(valores.data(), valores.size());
+}
+
+// Suma exacta de 'n' montos en centavos
+Centavos sumaCentavos(const Centavos* valores, size_t n) {
+	Centavos total = 0;
+	size_t i = 0;
+#if defined(__AVX2__)
+	__m256i a0 = _mm256_setzero_si256(), a1 = a0;
+	for (; i + 8 <= n; i += 8) {
+		a0 = _mm256_add_epi64(a0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valores + i)));
+		a1 = _mm256_add_epi64(a1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valores + i + 4)));
+	}
+	int64_t carriles[4];
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), _mm256_add_epi64(a0, a1));
+	total = carriles[0] + carriles[1] + carriles[2] + carriles[3];
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	__m128i a0 = _mm_setzero_si128(), a1 = a0;
+	for (; i + 4 <= n; i += 4) {
+		a0 = _mm_add_epi64(a0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(valores + i)));
+		a1 = _mm_add_epi64(a1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(valores + i + 2)));
+	}
+	int64_t carriles[2];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(carriles), _mm_add_epi64(a0, a1));
+	total = carriles[0] + carriles[1];
+#endif
+	for (; i < n; ++i) total += valores[i];
+	return total;
+}
+
+Centavos sumaMontos(const vector<Centavos>& montos) {
+	return sumaCentavos(montos.data(), montos.size());
 }
 
 // ======================= UTILERÍAS DE TIEMPO Y CSV (C4996 fix) =======================
@@ -147,173 +1115,5092 @@ string obtenerHoraActual() {
 	return string(buffer);
 }
 
-// Se mantiene la función de pila original (no usada en el Case 6)
-void guardarMovimientoCSV(const RegistroCamion& registro, bool esNuevoArchivo) {
-	ofstream archivo("registro_camiones_pila.csv", ios::app);
-	if (esNuevoArchivo) {
-		archivo << "Fecha_Hora,Camion,Conductor,Movimiento\n";
-	}
-	archivo << registro.hora << ","
-		<< registro.numeroCamion << ","
-		<< registro.conductor << ","
-		<< registro.tipoMovimiento << "\n";
-	archivo.close();
+// --- Semanas ISO 8601 ("AAAA-Www") ---
+// Fechas como días desde 1970-01-01 (algoritmo civil de H. Hinnant). La semana ISO empieza
+// en lunes y pertenece al año y al mes de su jueves, así que cada semana cae en un solo mes.
+
+struct SemanaISO {
+	int anio = 0;
+	int semana = 0; // 1..53; 0 = sin semana
+	bool valida() const { return semana > 0; }
+};
+
+int64_t diasDesdeCivil(int64_t anio, unsigned mes, unsigned dia) {
+	anio -= mes <= 2;
+	const int64_t era = (anio >= 0 ? anio : anio - 399) / 400;
+	const unsigned aa = static_cast<unsigned>(anio - era * 400);
+	const unsigned dd = (153 * (mes > 2 ? mes - 3 : mes + 9) + 2) / 5 + dia - 1;
+	const unsigned de = aa * 365 + aa / 4 - aa / 100 + dd;
+	return era * 146097 + static_cast<int64_t>(de) - 719468;
 }
 
+void civilDesdeDias(int64_t dias, int& anio, unsigned& mes, unsigned& dia) {
+	dias += 719468;
+	const int64_t era = (dias >= 0 ? dias : dias - 146096) / 146097;
+	const unsigned de = static_cast<unsigned>(dias - era * 146097);
+	const unsigned aa = (de - de / 1460 + de / 36524 - de / 146096) / 365;
+	const unsigned da = de - (365 * aa + aa / 4 - aa / 100);
+	const unsigned mp = (5 * da + 2) / 153;
+	dia = da - (153 * mp + 2) / 5 + 1;
+	mes = mp < 10 ? mp + 3 : mp - 9;
+	anio = static_cast<int>(aa + era * 400 + (mes <= 2));
+}
 
-// ======================= LÓGICA DEL SUBMENU 7 (PILA) =======================
+// 0 = lunes ... 6 = domingo (1970-01-01 fue jueves)
+inline int64_t diaSemanaISO(int64_t dias) { return ((dias % 7) + 10) % 7; }
 
-void registrarEntrada() {
-	cout << "\n======= REGISTRO DE ENTRADA (PUSH) =======\n";
-	if (camionesEnPatio.size() >= MAX_CAMIONES) {
-		cout << "!!! LIMITE ALCANZADO: El patio ya tiene el maximo de " << MAX_CAMIONES << " camiones." << endl;
-		return;
-	}
+// Lunes de la semana 1: la semana que contiene el 4 de enero
+int64_t lunesSemanaUno(int anio) {
+	int64_t cuatroEnero = diasDesdeCivil(anio, 1, 4);
+	return cuatroEnero - diaSemanaISO(cuatroEnero);
+}
 
-	RegistroCamion nuevoRegistro;
+int semanasEnAnio(int anio) {
+	return static_cast<int>((lunesSemanaUno(anio + 1) - lunesSemanaUno(anio)) / 7);
+}
+
+SemanaISO semanaDeFecha(int64_t dias) {
+	int64_t jueves = dias - diaSemanaISO(dias) + 3;
+	int anio; unsigned mes, dia;
+	civilDesdeDias(jueves, anio, mes, dia);
+	return SemanaISO{ anio, static_cast<int>((jueves - lunesSemanaUno(anio)) / 7 + 1) };
+}
+
+// Mes (1..12) al que se asigna la semana completa: el de su jueves
+int mesDeSemana(SemanaISO s) {
+	int anio; unsigned mes, dia;
+	civilDesdeDias(lunesSemanaUno(s.anio) + (s.semana - 1) * 7 + 3, anio, mes, dia);
+	return static_cast<int>(mes);
+}
+
+SemanaISO semanaActual() {
+	time_t t = time(nullptr);
+	tm* ltm = localtime(&t);
+	return semanaDeFecha(diasDesdeCivil(ltm->tm_year + 1900, ltm->tm_mon + 1, ltm->tm_mday));
+}
+
+// Acepta "2025-W07" (o "2025-w7"); false si el texto está vacío o la semana no existe
+bool convertirSemana(string_view texto, SemanaISO& s) {
+	s = SemanaISO{};
+	if (texto.size() < 7 || texto[4] != '-' || (texto[5] != 'W' && texto[5] != 'w')) return false;
+	int anio = 0, semana = 0;
+	if (from_chars(texto.data(), texto.data() + 4, anio).ec != errc()) return false;
+	auto fin = texto.data() + texto.size();
+	auto r = from_chars(texto.data() + 6, fin, semana);
+	if (r.ec != errc() || r.ptr != fin || semana < 1 || semana > semanasEnAnio(anio)) return false;
+	s = SemanaISO{ anio, semana };
+	return true;
+}
+
+string textoSemana(SemanaISO s) {
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%04d-W%02d", s.anio, s.semana);
+	return buffer;
+}
+
+/**
+ * @brief Toma el siguiente campo separado por comas de 'resto' sin copiar (como getline(ss, campo, ',')).
+ * @return false si ya no quedan campos.
+ */
+bool siguienteCampoCSV(string_view& resto, string_view& campo) {
+	if (resto.empty()) return false;
+	size_t coma = resto.find(',');
+	campo = resto.substr(0, coma);
+	resto = (coma == string_view::npos) ? string_view() : resto.substr(coma + 1);
+	return true;
+}
+
+// Convierte un campo numérico sin excepciones ni copias; false si el campo (sin espacios a los
+// lados) no es todo un número finito: "12abc", "nan" e "inf" se rechazan
+bool convertirDouble(string_view texto, double& valor) {
+	while (!texto.empty() && (texto.front() == ' ' || texto.front() == '+')) texto.remove_prefix(1);
+	while (!texto.empty() && texto.back() == ' ') texto.remove_suffix(1);
+	double leido = 0.0;
+	auto r = from_chars(texto.data(), texto.data() + texto.size(), leido);
+	if (r.ec != errc() || r.ptr != texto.data() + texto.size() || !isfinite(leido)) return false;
+	valor = leido;
+	return true;
+}
+
+/**
+ * @brief Lector de CSV por bloques, sin excepciones y sin getline.
+ * Lee el archivo en bloques de 1 MB y entrega un registro a la vez como vista de campos.
+ * Soporta campos entre comillas (con comas, saltos de línea y "" escapadas), fin de línea
+ * \n o \r\n y líneas en blanco. Las filas sin comillas (el caso normal) se cortan con memchr.
+ * Las vistas de campos() valen hasta la siguiente llamada a siguiente().
+ * Una comilla sin cerrar no se lleva el resto del archivo: ese registro se reporta como la
+ * sola línea donde empieza y la lectura sigue en la línea siguiente. Tampoco se acepta un
+ * registro de más de MAX_BYTES_REGISTRO_CSV: se reporta y se salta hasta el siguiente salto.
+ */
+const size_t MAX_BYTES_REGISTRO_CSV = 1 << 20;
+
+class LectorCSV {
+	FILE* archivo = nullptr;
+	vector<char> buffer;
+	size_t inicio = 0, fin = 0;   // Datos sin consumir: [inicio, fin)
+	bool finArchivo = false;
+	uint64_t lineaActual = 0;     // Línea física donde empieza el último registro
+	uint64_t lineasConsumidas = 0;
+	uint64_t bytesConsumidos = 0;
+	string_view registro;         // Texto crudo del último registro (sin el salto de línea)
+	vector<string_view> vistas;
+	string desescapado;           // Destino de los campos con comillas
+	vector<pair<size_t, size_t>> rangos; // Campos dentro de 'desescapado' (inicio, longitud)
+	bool descartando = false;     // Saltando el resto de un registro demasiado largo
+	string inicioDescartado;      // Primeros bytes del registro descartado (para el rechazo)
+
+	// Mueve lo pendiente al inicio y lee otro bloque (duplica el buffer si un registro no cabe)
+	bool rellenar() {
+		if (finArchivo) return false;
+		if (inicio > 0) {
+			memmove(buffer.data(), buffer.data() + inicio, fin - inicio);
+			fin -= inicio;
+			inicio = 0;
+		}
+		if (fin == buffer.size()) buffer.resize(buffer.size() * 2);
+		size_t leidos = fread(buffer.data() + fin, 1, buffer.size() - fin, archivo);
+		fin += leidos;
+		if (leidos == 0) finArchivo = true;
+		return leidos > 0;
+	}
+
+	void cortarSinComillas(const char* p, const char* e) {
+		while (true) {
+			const char* coma = static_cast<const char*>(memchr(p, ',', static_cast<size_t>(e - p)));
+			if (!coma) { vistas.emplace_back(p, static_cast<size_t>(e - p)); return; }
+			vistas.emplace_back(p, static_cast<size_t>(coma - p));
+			p = coma + 1;
+		}
+	}
+
+	/**
+	 * Registro con comillas: máquina de estados sobre [p, e). Regresa la posición del salto de
+	 * línea que lo termina (o e si se acabó el buffer) y deja 'cerrado' en false si quedó
+	 * una comilla abierta.
+	 */
+	const char* cortarConComillas(const char* p, const char* e, bool& cerrado, uint64_t& saltos) {
+		if (desescapado.size() < static_cast<size_t>(e - p)) desescapado.resize(static_cast<size_t>(e - p));
+		char* destino = desescapado.data();
+		rangos.clear();
+		size_t inicioCampo = 0, escrito = 0;
+		bool entreComillas = false;
+		cerrado = true;
+		saltos = 0;
+		for (; p < e; ++p) {
+			char c = *p;
+			if (entreComillas) {
+				if (c == '"') {
+					if (p + 1 < e && p[1] == '"') { destino[escrito++] = '"'; ++p; }
+					else entreComillas = false;
+				}
+				else {
+					if (c == '\n') ++saltos;
+					destino[escrito++] = c;
+				}
+			}
+			else if (c == '"') entreComillas = true;
+			else if (c == ',') { rangos.emplace_back(inicioCampo, escrito - inicioCampo); inicioCampo = escrito; }
+			else if (c == '\n') break;
+			else if (c != '\r' || (p + 1 < e && p[1] != '\n')) destino[escrito++] = c;
+		}
+		cerrado = !entreComillas;
+		rangos.emplace_back(inicioCampo, escrito - inicioCampo);
+		for (const auto& r : rangos) vistas.emplace_back(destino + r.first, r.second);
+		return p;
+	}
+
+public:
+	explicit LectorCSV(const string& ruta, size_t capacidad = 1 << 20)
+		: archivo(fopen(ruta.c_str(), "rb")), buffer(capacidad) {}
+	~LectorCSV() { if (archivo) fclose(archivo); }
+	LectorCSV(const LectorCSV&) = delete;
+	LectorCSV& operator=(const LectorCSV&) = delete;
+
+	bool abierto() const { return archivo != nullptr; }
+	const vector<string_view>& campos() const { return vistas; }
+	string_view textoRegistro() const { return registro; }
+	uint64_t numeroLinea() const { return lineaActual; }
+	uint64_t bytesLeidos() const { return bytesConsumidos; }
+
+	/**
+	 * @brief Avanza al siguiente registro no vacío.
+	 * @param error Queda en nullptr, o con el motivo si el registro está mal formado.
+	 * @return false cuando ya no hay registros.
+	 */
+	bool siguiente(const char*& error) {
+		error = nullptr;
+		if (!archivo) return false;
+		while (true) {
+			const char* p = buffer.data() + inicio;
+			const char* e = buffer.data() + fin;
+			const char* salto = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(e - p)));
+			if (descartando) {
+				// Resto de un registro demasiado largo: se tira hasta el siguiente salto de línea
+				size_t consumidos = static_cast<size_t>((salto ? salto + 1 : e) - p);
+				inicio += consumidos;
+				bytesConsumidos += consumidos;
+				if (salto) { descartando = false; ++lineasConsumidas; }
+				else if (!rellenar()) descartando = false;
+				continue;
+			}
+			if (!salto && !finArchivo && static_cast<size_t>(e - p) < MAX_BYTES_REGISTRO_CSV) { rellenar(); continue; }
+			if (p == e) return false;
+			vistas.clear();
+			lineaActual = lineasConsumidas + 1;
+			if (!salto && !finArchivo) {
+				inicioDescartado.assign(p, min<size_t>(static_cast<size_t>(e - p), 200));
+				registro = inicioDescartado;
+				inicio = fin;
+				bytesConsumidos += static_cast<size_t>(e - p);
+				descartando = true;
+				error = "registro demasiado largo";
+				return true;
+			}
+			const char* finLinea = salto ? salto : e;
+
+			if (!memchr(p, '"', static_cast<size_t>(finLinea - p))) {
+				const char* finTexto = (finLinea > p && finLinea[-1] == '\r') ? finLinea - 1 : finLinea;
+				registro = string_view(p, static_cast<size_t>(finTexto - p));
+				size_t consumidos = static_cast<size_t>(finLinea - p) + (salto ? 1 : 0);
+				inicio += consumidos;
+				bytesConsumidos += consumidos;
+				++lineasConsumidas;
+				if (registro.empty()) continue; // Línea en blanco
+				cortarSinComillas(p, finTexto);
+				return true;
+			}
+
+			// Con comillas el registro puede seguir en las líneas siguientes
+			bool cerrado = true;
+			uint64_t saltos = 0;
+			const char* finRegistro = cortarConComillas(p, e, cerrado, saltos);
+			if (finRegistro == e && !finArchivo && static_cast<size_t>(e - p) < MAX_BYTES_REGISTRO_CSV) { rellenar(); continue; }
+			if (!cerrado || (finRegistro == e && !finArchivo)) {
+				// Comilla sin cerrar (o un campo entre comillas que no termina dentro del límite):
+				// se rechaza solo la primera línea y se vuelve a sincronizar en la siguiente
+				vistas.clear();
+				cortarSinComillas(p, finLinea);
+				finRegistro = finLinea;
+				saltos = 0;
+				cerrado = false;
+			}
+			const char* finTexto = finRegistro;
+			while (finTexto > p && (finTexto[-1] == '\r' || finTexto[-1] == '\n')) --finTexto;
+			registro = string_view(p, static_cast<size_t>(finTexto - p));
+			size_t consumidos = static_cast<size_t>(finRegistro - p) + (finRegistro < e ? 1 : 0);
+			inicio += consumidos;
+			bytesConsumidos += consumidos;
+			lineasConsumidas += saltos + 1;
+			if (!cerrado) error = "comillas sin cerrar";
+			return true;
+		}
+	}
+};
+
+// Agrega un campo de texto; va entre comillas solo si trae comas, comillas o saltos de línea
+void agregarCampoCSV(string& destino, string_view campo) {
+	if (campo.find_first_of(",\"\r\n") == string_view::npos) { destino.append(campo); return; }
+	destino += '"';
+	for (char c : campo) {
+		if (c == '"') destino += '"';
+		destino += c;
+	}
+	destino += '"';
+}
+
+void escribirCampoCSV(ostream& salida, string_view campo) {
+	if (campo.find_first_of(",\"\r\n") == string_view::npos) { salida << campo; return; }
+	string texto;
+	agregarCampoCSV(texto, campo);
+	salida << texto;
+}
+
+// ======================= ALMACENAMIENTO COMPRIMIDO POR BLOQUES (.bloq) =======================
+// Los CSV históricos se pueden compactar en '<archivo>.bloq': bloques de hasta 64K filas,
+// codificados por columna, con un índice al final del archivo. Las filas nuevas se siguen
+// agregando al CSV; al compactar pasan a bloques nuevos y el CSV queda solo con su encabezado.
+// Cada columna de un bloque se codifica según lo que contiene:
+//   - enteros y montos con dos decimales: diferencia con el valor anterior (zigzag + varint)
+//   - fechas "AAAA-MM-DD HH:MM:SS": segundos, también como diferencias
+//   - cualquier otro texto: diccionario del bloque + un índice varint por fila
+//   - la serie final de cada fila (Km_Dia_1..N,Total y parecidas): por fila, ver SERIES POR FILA
+// Un valor solo se codifica como número si al volver a formatearlo queda el mismo texto,
+// así que cada campo se recupera idéntico. Los bloques se decodifican en paralelo y el
+// índice guarda el mínimo y el máximo de la primera columna (camion o fecha) para saltar
+// bloques que no pueden contener lo que se busca; desde la versión 3 también un filtro de
+// Bloom por bloque de las columnas de nombres (camion, chofer, encargado, taller), así que una
+// búsqueda por igualdad descarta casi todos los bloques que no tienen el valor sin leerlos.
+
+const char FIRMA_BLOQUES[4] = { 'P', 'M', 'B', 'Q' };
+const char FIRMA_PIE_BLOQUES[4] = { 'F', 'I', 'N', 'Q' };
+const uint32_t VERSION_BLOQUES = 3;     // 2: columnas con serie por fila; 3: filtros de Bloom en el índice
+const size_t FILAS_POR_BLOQUE = 65536;
+
+inline string rutaBloques(const string& rutaCSV) { return rutaCSV + ".bloq"; }
+
+inline void escribirVarint(string& destino, uint64_t valor) {
+	while (valor >= 0x80) {
+		destino += static_cast<char>(valor | 0x80);
+		valor >>= 7;
+	}
+	destino += static_cast<char>(valor);
+}
+
+inline bool leerVarint(const char*& p, const char* fin, uint64_t& valor) {
+	valor = 0;
+	for (int desplazamiento = 0; p < fin && desplazamiento < 64; desplazamiento += 7) {
+		uint8_t byte = static_cast<uint8_t>(*p++);
+		valor |= static_cast<uint64_t>(byte & 0x7F) << desplazamiento;
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+// Zigzag: los negativos chicos también quedan en pocos bytes (0, -1, 1, -2 -> 0, 1, 2, 3)
+inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t deshacerZigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+uint32_t sumaFNV(string_view datos) {
+	uint32_t h = 2166136261u;
+	for (char c : datos) { h ^= static_cast<uint8_t>(c); h *= 16777619u; }
+	return h;
+}
+
+// "AAAA-MM-DD HH:MM:SS" (mismo formato que obtenerHoraActual); regresa 19
+size_t formatearFechaHora(char* destino, int64_t segundosEpoch) {
+	int64_t dias = segundosEpoch >= 0 ? segundosEpoch / 86400 : (segundosEpoch - 86399) / 86400;
+	int64_t seg = segundosEpoch - dias * 86400;
+	int anio; unsigned mes, dia;
+	civilDesdeDias(dias, anio, mes, dia);
+	auto dos = [](char* p, unsigned v) { p[0] = static_cast<char>('0' + v / 10); p[1] = static_cast<char>('0' + v % 10); };
+	unsigned a = static_cast<unsigned>(anio) % 10000;
+	dos(destino, a / 100); dos(destino + 2, a % 100); destino[4] = '-';
+	dos(destino + 5, mes); destino[7] = '-'; dos(destino + 8, dia); destino[10] = ' ';
+	dos(destino + 11, static_cast<unsigned>(seg / 3600)); destino[13] = ':';
+	dos(destino + 14, static_cast<unsigned>(seg / 60 % 60)); destino[16] = ':';
+	dos(destino + 17, static_cast<unsigned>(seg % 60));
+	return 19;
+}
+
+// Conversiones que solo aceptan el texto exactamente como lo volvería a escribir el programa
+bool enteroCanonico(string_view texto, int64_t& valor) {
+	char buffer[24];
+	if (texto.empty() || from_chars(texto.data(), texto.data() + texto.size(), valor).ec != errc()) return false;
+	auto r = to_chars(buffer, buffer + sizeof(buffer), valor);
+	return string_view(buffer, static_cast<size_t>(r.ptr - buffer)) == texto;
+}
+
+bool montoCanonico(string_view texto, int64_t& valor) {
+	char buffer[24];
+	Centavos centavos = 0;
+	if (texto.empty() || !convertirCentavos(texto, centavos)) return false;
+	valor = centavos;
+	return string_view(buffer, formatearCentavos(buffer, centavos)) == texto;
+}
+
+bool fechaHoraCanonica(string_view texto, int64_t& valor) {
+	if (texto.size() != 19) return false;
+	int partes[6];
+	const size_t posiciones[6] = { 0, 5, 8, 11, 14, 17 };
+	for (int i = 0; i < 6; ++i) {
+		size_t largo = i == 0 ? 4 : 2;
+		auto r = from_chars(texto.data() + posiciones[i], texto.data() + posiciones[i] + largo, partes[i]);
+		if (r.ec != errc() || r.ptr != texto.data() + posiciones[i] + largo) return false;
+	}
+	valor = diasDesdeCivil(partes[0], static_cast<unsigned>(partes[1]), static_cast<unsigned>(partes[2])) * 86400
+		+ partes[3] * 3600 + partes[4] * 60 + partes[5];
+	char buffer[24];
+	return string_view(buffer, formatearFechaHora(buffer, valor)) == texto;
+}
+
+enum class CodificacionColumna : uint8_t { Diccionario = 0, Enteros = 1, Montos = 2, FechaHora = 3, SerieFilas = 4 };
+
+// Filas de un bloque en construcción: todos los campos seguidos en un solo texto (con
+// --agrupar son las de todo el CSV, que puede pasar de 4 GB: posiciones de 64 bits)
+struct FilasBloque {
+	string texto;
+	vector<size_t> finCampo;             // Fin (exclusivo) de cada campo dentro de 'texto'
+	vector<size_t> inicioFila = { 0 };   // Primer campo de cada fila (índice en finCampo)
+
+	size_t filas() const { return inicioFila.size() - 1; }
+	size_t numCampos(size_t f) const { return inicioFila[f + 1] - inicioFila[f]; }
+	string_view campo(size_t f, size_t k) const {
+		size_t i = inicioFila[f] + k;
+		size_t desde = i ? finCampo[i - 1] : 0;
+		return string_view(texto.data() + desde, finCampo[i] - desde);
+	}
+	void agregar(const string_view* campos, size_t n) {
+		for (size_t k = 0; k < n; ++k) {
+			texto.append(campos[k]);
+			finCampo.push_back(texto.size());
+		}
+		inicioFila.push_back(finCampo.size());
+	}
+	void limpiar() { texto.clear(); finCampo.clear(); inicioFila.assign(1, 0); }
+};
+
+// ---------------------- SERIES POR FILA (KILOMETRAJE) ----------------------
+// Las columnas finales de una tabla de series (Km_Dia_1..N,Total y parecidas) se codifican por
+// fila y no por columna: el primer valor de cada fila va como diferencia con el primero de la
+// fila anterior, cada uno de los demás se predice con los anteriores de su fila y el Total se
+// guarda como diferencia con la suma de la serie (casi siempre 0). Hay tres predicciones y el
+// bloque usa la que deja los números más chicos:
+//   - Ascendente: diferencia con el anterior, sin signo (las series capturadas con el método
+//     de inserción ya vienen ordenadas de menor a mayor)
+//   - Diferencias: diferencia con el anterior (zigzag)
+//   - DiferenciaDeDiferencias: cambio de la diferencia (zigzag), para lecturas tipo odómetro
+// Todas las predicciones del bloque se empacan con el mismo ancho de bits, así que se
+// desempacan de 4 en 4 con AVX2. Quien solo suma (--series) recibe los enteros de la serie
+// sin pasar por texto.
+
+enum class ModoSerie : uint8_t { Ascendente = 1, Diferencias = 2, DiferenciaDeDiferencias = 3 };
+const unsigned MAX_BITS_SERIE = 57; // Un valor empacado cabe en una lectura de 8 bytes
+
+// Valor a empacar para 'x'; en cada fila 'anterior' empieza en su primer valor y 'deltaAnterior' en 0
+inline uint64_t predecirSerie(ModoSerie modo, int64_t x, int64_t& anterior, int64_t& deltaAnterior) {
+	int64_t delta = static_cast<int64_t>(static_cast<uint64_t>(x) - static_cast<uint64_t>(anterior));
+	uint64_t v = modo == ModoSerie::Ascendente ? static_cast<uint64_t>(delta)
+		: modo == ModoSerie::Diferencias ? zigzag(delta)
+		: zigzag(static_cast<int64_t>(static_cast<uint64_t>(delta) - static_cast<uint64_t>(deltaAnterior)));
+	anterior = x;
+	deltaAnterior = delta;
+	return v;
+}
+
+// Inverso de predecirSerie: la fila 'valores' (n >= 1) a partir de su primer valor y n - 1 predicciones
+inline void reconstruirSerie(ModoSerie modo, int64_t primero, const uint64_t* predicciones, int64_t* valores, size_t n) {
+	uint64_t anterior = static_cast<uint64_t>(primero), deltaAnterior = 0;
+	valores[0] = primero;
+	for (size_t j = 1; j < n; ++j) {
+		uint64_t v = predicciones[j - 1];
+		uint64_t delta = modo == ModoSerie::Ascendente ? v
+			: modo == ModoSerie::Diferencias ? static_cast<uint64_t>(deshacerZigzag(v))
+			: deltaAnterior + static_cast<uint64_t>(deshacerZigzag(v));
+		anterior += delta;
+		deltaAnterior = delta;
+		valores[j] = static_cast<int64_t>(anterior);
+	}
+}
+
+inline unsigned bitsNecesarios(uint64_t v) {
+	unsigned bits = 0;
+	for (; v; v >>= 1) ++bits;
+	return bits;
+}
+
+// Desempaca 'n' valores de 'bits' bits (LSB primero); 'datos' debe tener 8 bytes legibles de más
+void desempacarBits(const char* datos, size_t n, unsigned bits, uint64_t* salida) {
+	const uint64_t mascara = bits == 0 ? 0 : ~0ULL >> (64 - bits);
+	size_t j = 0;
+#if defined(__AVX2__)
+	const __m256i vMascara = _mm256_set1_epi64x(static_cast<long long>(mascara));
+	const __m256i siete = _mm256_set1_epi64x(7);
+	const __m256i paso = _mm256_set1_epi64x(4LL * bits);
+	__m256i posicion = _mm256_setr_epi64x(0, bits, 2LL * bits, 3LL * bits); // En bits
+	for (; j + 4 <= n; j += 4) {
+		__m256i palabras = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(datos), _mm256_srli_epi64(posicion, 3), 1);
+		__m256i v = _mm256_and_si256(_mm256_srlv_epi64(palabras, _mm256_and_si256(posicion, siete)), vMascara);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + j), v);
+		posicion = _mm256_add_epi64(posicion, paso);
+	}
+#endif
+	for (; j < n; ++j) {
+		uint64_t bit = static_cast<uint64_t>(j) * bits, palabra;
+		memcpy(&palabra, datos + (bit >> 3), 8);
+		salida[j] = (palabra >> (bit & 7)) & mascara;
+	}
+}
+
+/**
+ * @brief Si todas las filas [desde, hasta) terminan en montos a partir de una misma columna
+ * 'inicio' (>= 1), codifica esas columnas por fila en 'salida'.
+ * @return 'inicio', o 0 si el bloque no tiene serie (o no conviene).
+ */
+size_t codificarSerieFilas(const FilasBloque& filas, const vector<size_t>& orden, size_t desde, size_t hasta, string& salida) {
+	auto fila = [&](size_t i) -> size_t { return orden.empty() ? i : orden[i]; };
+	size_t inicio = 1;
+	int64_t numero = 0;
+	for (size_t i = desde; i < hasta; ++i) {
+		size_t f = fila(i), s = filas.numCampos(f);
+		while (s > 0 && montoCanonico(filas.campo(f, s - 1), numero)) --s;
+		inicio = max(inicio, s);
+	}
+	vector<int64_t> serie;
+	vector<int64_t> totales;
+	vector<uint32_t> largos;
+	for (size_t i = desde; i < hasta; ++i) {
+		size_t f = fila(i), n = filas.numCampos(f);
+		if (n <= inicio) return 0; // Fila sin Total
+		for (size_t k = inicio; k + 1 < n; ++k) {
+			montoCanonico(filas.campo(f, k), numero);
+			serie.push_back(numero);
+		}
+		montoCanonico(filas.campo(f, n - 1), numero);
+		totales.push_back(numero);
+		largos.push_back(static_cast<uint32_t>(n - inicio - 1));
+	}
+	if (serie.size() < largos.size()) return 0; // Menos de un valor por fila: mejor por columna
+
+	// Ancho de bits de cada predicción; la ascendente solo vale si ninguna diferencia es negativa
+	size_t empacadas = 0;
+	for (uint32_t largo : largos) empacadas += largo ? largo - 1 : 0;
+	ModoSerie mejor = ModoSerie::Ascendente;
+	unsigned bitsMejor = 64 + 1;
+	for (ModoSerie modo : { ModoSerie::Ascendente, ModoSerie::Diferencias, ModoSerie::DiferenciaDeDiferencias }) {
+		uint64_t todos = 0;
+		bool valido = true;
+		for (size_t r = 0, j = 0; r < largos.size() && valido; j += largos[r], ++r) {
+			int64_t anterior = largos[r] ? serie[j] : 0, deltaAnterior = 0;
+			for (uint32_t d = 1; d < largos[r]; ++d) {
+				if (modo == ModoSerie::Ascendente && serie[j + d] < anterior) { valido = false; break; }
+				todos |= predecirSerie(modo, serie[j + d], anterior, deltaAnterior);
+			}
+		}
+		if (valido && bitsNecesarios(todos) < bitsMejor) { mejor = modo; bitsMejor = bitsNecesarios(todos); }
+	}
+	if (bitsMejor > MAX_BITS_SERIE) return 0;
+
+	string empacados((empacadas * bitsMejor + 7) / 8 + 8, '\0');
+	for (size_t r = 0, j = 0, e = 0; r < largos.size(); j += largos[r], ++r) {
+		int64_t anterior = largos[r] ? serie[j] : 0, deltaAnterior = 0;
+		for (uint32_t d = 1; d < largos[r]; ++d, ++e) {
+			uint64_t v = predecirSerie(mejor, serie[j + d], anterior, deltaAnterior), bit = e * bitsMejor, palabra;
+			memcpy(&palabra, empacados.data() + (bit >> 3), 8);
+			palabra |= v << (bit & 7);
+			memcpy(empacados.data() + (bit >> 3), &palabra, 8);
+		}
+	}
+	empacados.resize(empacados.size() - 8);
+
+	salida += static_cast<char>(CodificacionColumna::SerieFilas);
+	salida += static_cast<char>(mejor);
+	salida += static_cast<char>(bitsMejor);
+	escribirVarint(salida, empacados.size());
+	salida += empacados;
+	// Por fila: su primer valor (si tiene serie) y el residuo del Total
+	int64_t primeroAnterior = 0;
+	for (size_t r = 0, j = 0; r < largos.size(); j += largos[r], ++r) {
+		if (largos[r]) {
+			escribirVarint(salida, zigzag(serie[j] - primeroAnterior));
+			primeroAnterior = serie[j];
+		}
+		escribirVarint(salida, zigzag(totales[r] - sumaCentavos(serie.data() + j, largos[r])));
+	}
+	return inicio;
+}
+
+/**
+ * @brief Codifica las filas [desde, hasta) del orden dado (o todas en su orden si 'orden' está vacío).
+ * Formato: filas, campos por fila (uno común o uno por fila), número de columnas y luego cada
+ * columna con su codificación.
+ */
+string codificarBloque(const FilasBloque& filas, const vector<size_t>& orden, size_t desde, size_t hasta, bool serieFilas = true) {
+	auto fila = [&](size_t i) -> size_t { return orden.empty() ? i : orden[i]; };
+	string salida;
+	size_t n = hasta - desde;
+	escribirVarint(salida, n);
+	size_t maxCampos = 0, comun = filas.numCampos(fila(desde));
+	for (size_t i = desde; i < hasta; ++i) {
+		maxCampos = max(maxCampos, filas.numCampos(fila(i)));
+		if (filas.numCampos(fila(i)) != comun) comun = 0;
+	}
+	escribirVarint(salida, comun);
+	if (comun == 0) for (size_t i = desde; i < hasta; ++i) escribirVarint(salida, filas.numCampos(fila(i)) + 1);
+	escribirVarint(salida, maxCampos);
+
+	// Las columnas desde 'columnas' (si hay serie) van al final, codificadas por fila
+	string serie;
+	size_t columnas = maxCampos;
+	if (serieFilas) {
+		size_t inicio = codificarSerieFilas(filas, orden, desde, hasta, serie);
+		if (inicio) columnas = inicio;
+	}
+
+	vector<string_view> valores;
+	vector<int64_t> numeros;
+	for (size_t k = 0; k < columnas; ++k) {
+		valores.clear();
+		for (size_t i = desde; i < hasta; ++i) {
+			if (filas.numCampos(fila(i)) > k) valores.push_back(filas.campo(fila(i), k));
+		}
+		// Se prueba cada codificación numérica; la primera que acepta todos los valores gana
+		CodificacionColumna tipo = CodificacionColumna::Diccionario;
+		for (CodificacionColumna prueba : { CodificacionColumna::Enteros, CodificacionColumna::Montos, CodificacionColumna::FechaHora }) {
+			numeros.resize(valores.size());
+			bool acepta = true;
+			for (size_t j = 0; j < valores.size() && acepta; ++j) {
+				acepta = prueba == CodificacionColumna::Enteros ? enteroCanonico(valores[j], numeros[j])
+					: prueba == CodificacionColumna::Montos ? montoCanonico(valores[j], numeros[j])
+					: fechaHoraCanonica(valores[j], numeros[j]);
+			}
+			if (acepta) { tipo = prueba; break; }
+		}
+		salida += static_cast<char>(tipo);
+
+		if (tipo != CodificacionColumna::Diccionario) {
+			int64_t anterior = 0;
+			for (int64_t v : numeros) {
+				escribirVarint(salida, zigzag(v - anterior));
+				anterior = v;
+			}
+			continue;
+		}
+		unordered_map<string_view, uint32_t> ids;
+		vector<string_view> diccionario;
+		vector<uint32_t> indices;
+		indices.reserve(valores.size());
+		for (string_view v : valores) {
+			auto it = ids.try_emplace(v, static_cast<uint32_t>(diccionario.size())).first;
+			if (it->second == diccionario.size()) diccionario.push_back(v);
+			indices.push_back(it->second);
+		}
+		escribirVarint(salida, diccionario.size());
+		for (string_view v : diccionario) {
+			escribirVarint(salida, v.size());
+			salida.append(v);
+		}
+		for (uint32_t id : indices) escribirVarint(salida, id);
+	}
+	salida += serie;
+	return salida;
+}
+
+// Bloque ya decodificado: las vistas apuntan a 'arena' (montos, fechas y diccionarios)
+struct BloqueDecodificado {
+	string arena;
+	vector<string_view> campos;     // Todos los campos, fila tras fila
+	vector<uint32_t> inicioFila;    // filas()+1 entradas
+	size_t filas() const { return inicioFila.empty() ? 0 : inicioFila.size() - 1; }
+
+	// Serie por fila (columnas desde 'inicioSerie'), en centésimas; sin texto si así se pidió
+	size_t inicioSerie = 0;         // 0: el bloque no tiene serie por fila
+	bool serieAscendente = false;   // Cada fila de la serie ya está ordenada de menor a mayor
+	vector<int64_t> serie;          // Valores de la serie, fila tras fila (sin el Total)
+	vector<uint32_t> inicioFilaSerie;
+	vector<int64_t> totalSerie;     // Última columna de cada fila
+};
+
+// Lee el grupo SerieFilas (columnas desde 'inicio' de cada fila) a los enteros de 'salida'
+bool leerSerieFilas(const char*& p, const char* fin, const vector<uint32_t>& numCampos, size_t inicio, BloqueDecodificado& salida) {
+	if (fin - p < 2) return false;
+	auto modo = static_cast<ModoSerie>(*p++);
+	unsigned bits = static_cast<uint8_t>(*p++);
+	uint64_t largo = 0;
+	if (modo < ModoSerie::Ascendente || modo > ModoSerie::DiferenciaDeDiferencias || bits > MAX_BITS_SERIE
+		|| !leerVarint(p, fin, largo) || largo > static_cast<uint64_t>(fin - p)) return false;
+	salida.inicioSerie = inicio;
+	salida.serieAscendente = modo == ModoSerie::Ascendente;
+	salida.inicioFilaSerie.assign(1, 0);
+	for (uint32_t c : numCampos) {
+		if (c <= inicio) return false;
+		salida.inicioFilaSerie.push_back(salida.inicioFilaSerie.back() + c - static_cast<uint32_t>(inicio) - 1);
+	}
+	size_t empacadas = 0;
+	for (size_t f = 0; f < numCampos.size(); ++f) {
+		size_t cuantos = salida.inicioFilaSerie[f + 1] - salida.inicioFilaSerie[f];
+		empacadas += cuantos ? cuantos - 1 : 0;
+	}
+	if ((static_cast<uint64_t>(empacadas) * bits + 7) / 8 != largo) return false;
+	string empacados(p, largo);
+	empacados.append(8, '\0'); // Margen para las lecturas de 8 bytes
+	p += largo;
+	vector<uint64_t> predicciones(empacadas);
+	desempacarBits(empacados.data(), empacadas, bits, predicciones.data());
+
+	salida.serie.resize(salida.inicioFilaSerie.back());
+	salida.totalSerie.resize(numCampos.size());
+	const uint64_t* prediccion = predicciones.data();
+	int64_t primero = 0;
+	for (size_t f = 0; f < numCampos.size(); ++f) {
+		int64_t* fila = salida.serie.data() + salida.inicioFilaSerie[f];
+		size_t cuantos = salida.inicioFilaSerie[f + 1] - salida.inicioFilaSerie[f];
+		uint64_t v = 0;
+		if (cuantos) {
+			if (!leerVarint(p, fin, v)) return false;
+			primero += deshacerZigzag(v);
+			reconstruirSerie(modo, primero, prediccion, fila, cuantos);
+			prediccion += cuantos - 1;
+		}
+		if (!leerVarint(p, fin, v)) return false;
+		salida.totalSerie[f] = sumaCentavos(fila, cuantos) + deshacerZigzag(v);
+	}
+	return true;
+}
+
+/**
+ * @brief Decodifica un bloque. Con 'serieComoTexto' en false la serie por fila (si la hay)
+ * queda solo como enteros y 'campos' trae de cada fila las columnas anteriores a ella.
+ */
+bool decodificarBloque(string_view datos, BloqueDecodificado& salida, bool serieComoTexto = true) {
+	const char* p = datos.data();
+	const char* fin = p + datos.size();
+	uint64_t n = 0, comun = 0, maxCampos = 0;
+	if (!leerVarint(p, fin, n) || !leerVarint(p, fin, comun)) return false;
+	vector<uint32_t> numCampos(n, static_cast<uint32_t>(comun));
+	if (comun == 0) {
+		for (auto& c : numCampos) {
+			uint64_t v = 0;
+			if (!leerVarint(p, fin, v) || v == 0) return false;
+			c = static_cast<uint32_t>(v - 1);
+		}
+	}
+	if (!leerVarint(p, fin, maxCampos)) return false;
+
+	// Primero posiciones (inicio, largo) dentro de la arena: la arena puede crecer mientras tanto
+	salida.arena.clear();
+	salida.inicioSerie = 0;
+	vector<vector<pair<uint32_t, uint32_t>>> columnas(maxCampos);
+	vector<pair<uint32_t, uint32_t>> diccionario;
+	char buffer[24];
+	for (size_t k = 0; k < maxCampos; ++k) {
+		size_t cuantos = 0;
+		for (uint32_t c : numCampos) cuantos += c > k;
+		if (p >= fin) return false;
+		auto tipo = static_cast<CodificacionColumna>(*p++);
+		auto& columna = columnas[k];
+		columna.reserve(cuantos);
+		if (tipo == CodificacionColumna::Diccionario) {
+			uint64_t tam = 0;
+			if (!leerVarint(p, fin, tam)) return false;
+			diccionario.clear();
+			for (uint64_t d = 0; d < tam; ++d) {
+				uint64_t largo = 0;
+				if (!leerVarint(p, fin, largo) || largo > static_cast<uint64_t>(fin - p)) return false;
+				diccionario.emplace_back(static_cast<uint32_t>(salida.arena.size()), static_cast<uint32_t>(largo));
+				salida.arena.append(p, largo);
+				p += largo;
+			}
+			for (size_t j = 0; j < cuantos; ++j) {
+				uint64_t id = 0;
+				if (!leerVarint(p, fin, id) || id >= diccionario.size()) return false;
+				columna.push_back(diccionario[id]);
+			}
+			continue;
+		}
+		if (tipo == CodificacionColumna::SerieFilas) {
+			if (k == 0 || !leerSerieFilas(p, fin, numCampos, k, salida)) return false;
+			if (!serieComoTexto) break;
+			for (size_t f = 0; f < n; ++f) {
+				for (uint32_t j = salida.inicioFilaSerie[f]; j <= salida.inicioFilaSerie[f + 1]; ++j) {
+					// La última posición de la fila es su Total
+					int64_t v = j < salida.inicioFilaSerie[f + 1] ? salida.serie[j] : salida.totalSerie[f];
+					size_t largo = formatearCentavos(buffer, v);
+					columnas[k + j - salida.inicioFilaSerie[f]].emplace_back(static_cast<uint32_t>(salida.arena.size()), static_cast<uint32_t>(largo));
+					salida.arena.append(buffer, largo);
+				}
+			}
+			break; // La serie llega hasta la última columna
+		}
+		if (tipo > CodificacionColumna::FechaHora) return false;
+		int64_t valor = 0;
+		for (size_t j = 0; j < cuantos; ++j) {
+			uint64_t delta = 0;
+			if (!leerVarint(p, fin, delta)) return false;
+			valor += deshacerZigzag(delta);
+			size_t largo = tipo == CodificacionColumna::Enteros ? static_cast<size_t>(to_chars(buffer, buffer + sizeof(buffer), valor).ptr - buffer)
+				: tipo == CodificacionColumna::Montos ? formatearCentavos(buffer, valor)
+				: formatearFechaHora(buffer, valor);
+			columna.emplace_back(static_cast<uint32_t>(salida.arena.size()), static_cast<uint32_t>(largo));
+			salida.arena.append(buffer, largo);
+		}
+	}
+
+	salida.campos.clear();
+	salida.inicioFila.assign(1, 0);
+	vector<size_t> siguiente(maxCampos, 0);
+	const size_t limite = serieComoTexto || salida.inicioSerie == 0 ? maxCampos : salida.inicioSerie;
+	for (uint64_t f = 0; f < n; ++f) {
+		for (size_t k = 0; k < numCampos[f] && k < limite; ++k) {
+			auto pos = columnas[k][siguiente[k]++];
+			salida.campos.emplace_back(salida.arena.data() + pos.first, pos.second);
+		}
+		salida.inicioFila.push_back(static_cast<uint32_t>(salida.campos.size()));
+	}
+	return p == fin;
+}
+
+// ---------------------- FILTROS DE BLOOM POR BLOQUE ----------------------
+// Cada bloque lleva en el índice un filtro con los pares (columna, valor) de las columnas cuyo
+// nombre está en COLUMNAS_CON_FILTRO. Un "no" del filtro es seguro; un "sí" falla alrededor
+// del 1% de las veces (10 bits por valor distinto y 7 funciones). Las columnas que no están en
+// el filtro, o los bloques de versiones anteriores (sin filtro), siempre se leen.
+
+const char* const COLUMNAS_CON_FILTRO[] = { "Camion", "Chofer", "Encargado", "Taller", "Conductor" };
+const size_t BITS_POR_VALOR_FILTRO = 10;
+const uint8_t FUNCIONES_FILTRO = 7;
+
+// Posiciones (en el encabezado) de las columnas que llevan filtro; a lo más las primeras 32 columnas
+vector<size_t> columnasConFiltro(string_view encabezadoCSV) {
+	vector<size_t> columnas;
+	string_view campo;
+	for (size_t k = 0; k < 32 && siguienteCampoCSV(encabezadoCSV, campo); ++k) {
+		for (const char* nombre : COLUMNAS_CON_FILTRO) if (campo == nombre) columnas.push_back(k);
+	}
+	return columnas;
+}
+
+// FNV-1a de 64 bits de la columna y el valor, con una mezcla final para repartir los bits altos
+inline uint64_t hashValorFiltro(size_t columna, string_view valor) {
+	uint64_t h = 14695981039346656037ull;
+	h = (h ^ static_cast<uint8_t>(columna)) * 1099511628211ull;
+	for (char c : valor) h = (h ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+	h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+	return h ^ (h >> 33);
+}
+
+struct FiltroBloom {
+	uint32_t columnas = 0;    // Bit k: la columna k está en el filtro
+	uint8_t funciones = 0;
+	string bits;              // Vacío: sin filtro (el bloque siempre se lee)
+
+	// Las posiciones salen de dos mitades del hash (h1 + i * h2)
+	template<typename Funcion>
+	void posiciones(uint64_t h, Funcion f) const {
+		const uint64_t m = bits.size() * 8ull, h1 = h & 0xFFFFFFFFu, h2 = (h >> 32) | 1;
+		for (uint64_t i = 0; i < funciones; ++i) f((h1 + i * h2) % m);
+	}
+
+	// 'hashes' ya sin repetidos
+	void armar(uint32_t columnasFiltro, const vector<uint64_t>& hashes) {
+		columnas = columnasFiltro;
+		funciones = FUNCIONES_FILTRO;
+		bits.assign(max<size_t>(8, (hashes.size() * BITS_POR_VALOR_FILTRO + 7) / 8), '\0');
+		for (uint64_t h : hashes) posiciones(h, [this](uint64_t b) { bits[b / 8] |= static_cast<char>(1u << (b % 8)); });
+	}
+
+	// false solo si el bloque seguro no tiene 'valor' en 'columna'
+	bool puedeContener(size_t columna, string_view valor) const {
+		if (bits.empty() || columna >= 32 || !(columnas >> columna & 1u)) return true;
+		bool todos = true;
+		posiciones(hashValorFiltro(columna, valor), [&](uint64_t b) { todos = todos && (bits[b / 8] >> (b % 8) & 1); });
+		return todos;
+	}
+};
+
+struct EntradaIndiceBloque {
+	uint64_t desplazamiento = 0;
+	uint32_t bytes = 0;       // Comprimidos
+	uint32_t bytesTexto = 0;  // Lo que ocuparían como CSV
+	uint32_t filas = 0;
+	uint32_t suma = 0;        // FNV-1a de los bytes comprimidos
+	string minimo, maximo;    // Primera columna
+	FiltroBloom filtro;       // Versión 3 en adelante
+};
+
+struct PieBloques {
+	uint64_t desplazamientoIndice;
+	uint32_t numBloques;
+	char firma[4];
+};
+
+/**
+ * @brief Archivo .bloq: cabecera (firma, versión, encabezado del CSV), bloques y al final el
+ * índice y el pie. Al agregar bloques se escriben después del pie anterior y luego un índice
+ * y un pie nuevos; si algo falla se recorta el archivo a su tamaño original.
+ * La versión de la cabecera dice el formato del índice: un archivo de una versión anterior no
+ * se cambia en su lugar (la cabecera y el índice nuevo no se pueden escribir juntos), se copia
+ * completo a un temporal con la versión actual y se renombra.
+ */
+class ArchivoBloques {
+	string ruta;
+	string encabezadoCSV;
+	uint32_t version = VERSION_BLOQUES;
+	vector<EntradaIndiceBloque> entradas;
+
+	template<typename V>
+	static bool leerValor(istream& in, V& valor) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&valor), sizeof(V))); }
+	template<typename V>
+	static void escribirValor(ostream& out, const V& valor) { out.write(reinterpret_cast<const char*>(&valor), sizeof(V)); }
+
+	static void escribirCabecera(ostream& out, string_view encabezado) {
+		uint32_t version = VERSION_BLOQUES, largo = static_cast<uint32_t>(encabezado.size());
+		out.write(FIRMA_BLOQUES, 4);
+		escribirValor(out, version);
+		escribirValor(out, largo);
+		out.write(encabezado.data(), encabezado.size());
+	}
+
+	// Índice (en el formato de la versión actual) y pie; 'posicion' es donde empieza el índice
+	void escribirIndice(ostream& out, uint64_t posicion) const {
+		PieBloques pie{ posicion, static_cast<uint32_t>(entradas.size()), {} };
+		memcpy(pie.firma, FIRMA_PIE_BLOQUES, 4);
+		for (const auto& e : entradas) {
+			uint16_t largoMin = static_cast<uint16_t>(min<size_t>(e.minimo.size(), 65535));
+			uint16_t largoMax = static_cast<uint16_t>(min<size_t>(e.maximo.size(), 65535));
+			escribirValor(out, e.desplazamiento); escribirValor(out, e.bytes); escribirValor(out, e.bytesTexto);
+			escribirValor(out, e.filas); escribirValor(out, e.suma); escribirValor(out, largoMin); escribirValor(out, largoMax);
+			out.write(e.minimo.data(), largoMin);
+			out.write(e.maximo.data(), largoMax);
+			uint32_t largoFiltro = static_cast<uint32_t>(e.filtro.bits.size());
+			escribirValor(out, e.filtro.columnas); escribirValor(out, e.filtro.funciones); escribirValor(out, largoFiltro);
+			out.write(e.filtro.bits.data(), largoFiltro);
+		}
+		escribirValor(out, pie);
+	}
+
+	/**
+	 * @brief Agregar a un archivo de una versión anterior: cabecera actual, los bloques viejos
+	 * copiados tal cual (con filtro vacío), los nuevos y el índice, en un temporal que se
+	 * renombra. Si algo falla el archivo original no se tocó.
+	 */
+	bool agregarActualizando(vector<pair<string, EntradaIndiceBloque>>& nuevos) {
+		const string temporal = rutaTemporal(ruta);
+		const vector<EntradaIndiceBloque> anteriores = entradas;
+		bool exito;
+		uint64_t escritos = 0;
+		{
+			ifstream in(ruta, ios::binary);
+			ofstream out(temporal, ios::binary | ios::trunc);
+			escribirCabecera(out, encabezadoCSV);
+			uint64_t posicion = static_cast<uint64_t>(out.tellp());
+			string datos;
+			for (auto& e : entradas) {
+				datos.resize(e.bytes);
+				in.seekg(static_cast<streamoff>(e.desplazamiento));
+				in.read(datos.data(), e.bytes);
+				e.desplazamiento = posicion;
+				out.write(datos.data(), e.bytes);
+				posicion += e.bytes;
+			}
+			for (auto& par : nuevos) {
+				par.second.desplazamiento = posicion;
+				out.write(par.first.data(), static_cast<streamsize>(par.first.size()));
+				posicion += par.first.size();
+				entradas.push_back(par.second);
+			}
+			escribirIndice(out, posicion);
+			out.flush();
+			exito = in && out;
+			if (exito) escritos = static_cast<uint64_t>(out.tellp());
+		}
+		error_code ec;
+		if (exito) {
+			filesystem::rename(temporal, ruta, ec);
+			exito = !ec;
+		}
+		if (!exito) {
+			filesystem::remove(temporal, ec);
+			entradas = anteriores;
+			return false;
+		}
+		version = VERSION_BLOQUES;
+		CONTAR_METRICA(BytesEscritos, escritos);
+		return true;
+	}
+
+public:
+	const string& encabezado() const { return encabezadoCSV; }
+	const vector<EntradaIndiceBloque>& indice() const { return entradas; }
+	const string& rutaArchivo() const { return ruta; }
+	uint32_t versionArchivo() const { return version; }
+
+	uint64_t filas() const {
+		uint64_t total = 0;
+		for (const auto& e : entradas) total += e.filas;
+		return total;
+	}
+
+	bool abrir(const string& rutaArchivo, string& error) {
+		ruta = rutaArchivo;
+		entradas.clear();
+		ifstream in(ruta, ios::binary);
+		char firma[4];
+		uint32_t largo = 0;
+		if (!in.read(firma, 4) || memcmp(firma, FIRMA_BLOQUES, 4) != 0 || !leerValor(in, version) || version == 0 || version > VERSION_BLOQUES
+			|| !leerValor(in, largo)) {
+			error = "cabecera invalida";
+			return false;
+		}
+		encabezadoCSV.resize(largo);
+		in.read(encabezadoCSV.data(), largo);
+		PieBloques pie{};
+		in.seekg(-static_cast<streamoff>(sizeof(PieBloques)), ios::end);
+		if (!leerValor(in, pie) || memcmp(pie.firma, FIRMA_PIE_BLOQUES, 4) != 0) {
+			error = "pie invalido (archivo incompleto)";
+			return false;
+		}
+		auto leerIndice = [&](bool conFiltros) {
+			in.clear();
+			in.seekg(static_cast<streamoff>(pie.desplazamientoIndice));
+			entradas.assign(pie.numBloques, EntradaIndiceBloque{});
+			for (auto& e : entradas) {
+				uint16_t largoMin = 0, largoMax = 0;
+				if (!leerValor(in, e.desplazamiento) || !leerValor(in, e.bytes) || !leerValor(in, e.bytesTexto) || !leerValor(in, e.filas)
+					|| !leerValor(in, e.suma) || !leerValor(in, largoMin) || !leerValor(in, largoMax)) return false;
+				e.minimo.resize(largoMin);
+				e.maximo.resize(largoMax);
+				in.read(e.minimo.data(), largoMin);
+				in.read(e.maximo.data(), largoMax);
+				uint32_t largoFiltro = 0;
+				if (conFiltros && (!leerValor(in, e.filtro.columnas) || !leerValor(in, e.filtro.funciones) || !leerValor(in, largoFiltro))) return false;
+				e.filtro.bits.resize(largoFiltro);
+				in.read(e.filtro.bits.data(), largoFiltro);
+			}
+			// El índice termina justo donde empieza el pie
+			return in && static_cast<uint64_t>(in.tellg()) + sizeof(PieBloques) == tamanoArchivo(ruta);
+		};
+		// Un programa anterior actualizaba la versión después de escribir el índice nuevo: si se
+		// interrumpió en medio, la cabecera es vieja y el índice ya trae filtros
+		if (leerIndice(version >= 3) || (version < 3 && leerIndice(true))) return true;
+		entradas.clear();
+		error = "indice truncado";
+		return false;
+	}
+
+	// Crea un archivo vacío (sin bloques) con el encabezado del CSV
+	static bool crear(const string& rutaArchivo, string_view encabezado) {
+		ofstream out(rutaArchivo, ios::binary | ios::trunc);
+		escribirCabecera(out, encabezado);
+		PieBloques pie{ static_cast<uint64_t>(out.tellp()), 0, {} };
+		memcpy(pie.firma, FIRMA_PIE_BLOQUES, 4);
+		escribirValor(out, pie);
+		return static_cast<bool>(out);
+	}
+
+	/**
+	 * @brief Agrega bloques ya codificados (con su entrada de índice sin desplazamiento).
+	 * @return false si no se pudo escribir; en ese caso el archivo queda como estaba.
+	 */
+	bool agregar(vector<pair<string, EntradaIndiceBloque>>& nuevos) {
+		if (version < VERSION_BLOQUES) return agregarActualizando(nuevos);
+		uint64_t tamOriginal = tamanoArchivo(ruta);
+		{
+			ofstream out(ruta, ios::binary | ios::app);
+			uint64_t posicion = tamOriginal;
+			for (auto& par : nuevos) {
+				par.second.desplazamiento = posicion;
+				out.write(par.first.data(), static_cast<streamsize>(par.first.size()));
+				posicion += par.first.size();
+				entradas.push_back(par.second);
+			}
+			escribirIndice(out, posicion);
+			out.flush();
+			if (out) {
+				CONTAR_METRICA(BytesEscritos, static_cast<uint64_t>(out.tellp()) - tamOriginal);
+				return true;
+			}
+		}
+		error_code ec;
+		filesystem::resize_file(ruta, tamOriginal, ec);
+		entradas.resize(entradas.size() - nuevos.size());
+		return false;
+	}
+
+	bool leer(ifstream& in, size_t b, string& datos) const {
+		const auto& e = entradas[b];
+		datos.resize(e.bytes);
+		in.seekg(static_cast<streamoff>(e.desplazamiento));
+		return in.read(datos.data(), e.bytes) && sumaFNV(datos) == e.suma;
+	}
+};
+
+// Bloque decodificado entregado a quien recorre: 'valido' es false si el bloque está dañado
+struct BloqueLeido {
+	size_t numero;
+	bool valido;
+	const BloqueDecodificado* datos;
+};
+
+/**
+ * @brief Decodifica en paralelo los bloques para los que 'incluir(b)' es verdadero y los entrega
+ * en orden a 'procesar(BloqueLeido)'. La lectura del disco es secuencial; la decodificación
+ * se reparte en tandas de 'hilos' bloques. Si 'detener' (no nulo) se activa, no se empieza
+ * otra tanda.
+ * @return Bytes comprimidos leídos.
+ */
+template<typename Filtro, typename Funcion>
+uint64_t decodificarBloques(const ArchivoBloques& archivo, size_t hilos, Filtro incluir, Funcion procesar, bool serieComoTexto = true,
+	const atomic<bool>* detener = nullptr) {
+	ifstream in(archivo.rutaArchivo(), ios::binary);
+	hilos = max<size_t>(1, hilos);
+	vector<size_t> pendientes;
+	for (size_t b = 0; b < archivo.indice().size(); ++b) if (incluir(b)) pendientes.push_back(b);
+
+	vector<string> comprimidos(hilos);
+	vector<BloqueDecodificado> decodificados(hilos);
+	vector<char> validos(hilos);
+	uint64_t bytes = 0;
+	for (size_t t = 0; t < pendientes.size() && !(detener && detener->load()); t += hilos) {
+		size_t tanda = min(hilos, pendientes.size() - t);
+		for (size_t i = 0; i < tanda; ++i) {
+			validos[i] = archivo.leer(in, pendientes[t + i], comprimidos[i]);
+			bytes += comprimidos[i].size();
+		}
+		auto tarea = [&](size_t i) {
+			if (validos[i]) validos[i] = decodificarBloque(comprimidos[i], decodificados[i], serieComoTexto);
+		};
+		vector<thread> trabajadores;
+		for (size_t i = 1; i < tanda; ++i) trabajadores.emplace_back(tarea, i);
+		tarea(0);
+		for (auto& h : trabajadores) h.join();
+		for (size_t i = 0; i < tanda; ++i) procesar(BloqueLeido{ pendientes[t + i], validos[i] != 0, &decodificados[i] });
+	}
+	return bytes;
+}
+
+// Una fila de una tabla, venga de un bloque comprimido o del CSV
+struct FilaCSV {
+	const string_view* campos;
+	size_t numCampos;
+	const char* error;     // Registro mal formado o bloque dañado
+	uint64_t linea;        // Línea del CSV; 0 si viene de un bloque
+	size_t bloque;         // Bloque de origen (si linea == 0; TODOS_LOS_BLOQUES si no se pudo abrir el .bloq)
+	string_view texto;     // Texto crudo (solo filas del CSV)
+	bool ilegible = false; // Filas perdidas: bloque dañado o .bloq que no se pudo abrir (no hay texto que respaldar)
+};
+
+const size_t TODOS_LOS_BLOQUES = numeric_limits<size_t>::max();
+
+// Texto de la fila para mensajes: el crudo del CSV o los campos unidos con comas
+inline string textoFila(const FilaCSV& fila) {
+	if (fila.linea != 0) return string(fila.texto);
+	string texto;
+	for (size_t k = 0; k < fila.numCampos; ++k) {
+		if (k) texto += ',';
+		agregarCampoCSV(texto, fila.campos[k]);
+	}
+	return texto;
+}
+
+size_t hilosBloques() {
+	return max(1u, thread::hardware_concurrency());
+}
+
+/**
+ * @brief Recorre todas las filas de una tabla: primero los bloques de '<ruta>.bloq' (si existe)
+ * y después el CSV. 'alEncabezado(campos)' se llama al empezar cada fuente y
+ * 'procesar(FilaCSV)' con cada fila. Con 'incluirBloque(entrada)' se saltan bloques enteros
+ * usando el índice (mínimo y máximo de la primera columna). En 'firma' (si no es nullptr)
+ * queda la del CSV tal como se leyó (tomada con el candado). Si 'detener' (no nulo) se
+ * activa, el recorrido termina sin llegar al final (quien llama lo revisa al regresar).
+ * @return Bytes leídos (comprimidos + CSV).
+ */
+template<typename FuncionEncabezado, typename FuncionFila>
+uint64_t recorrerFilas(const string& rutaCSV, FuncionEncabezado alEncabezado, FuncionFila procesar,
+	function<bool(const EntradaIndiceBloque&)> incluirBloque = nullptr, FirmaArchivo* firma = nullptr, const atomic<bool>* detener = nullptr) {
+	uint64_t bytes = 0;
+	const string rutaBloq = rutaBloques(rutaCSV);
+	CandadoArchivo candado = abrirLectura(rutaCSV); // Bloques y CSV se leen como una sola tabla
+	if (firma) *firma = firmaArchivo(rutaCSV);
+	if (tamanoArchivo(rutaBloq) > 0) {
+		ArchivoBloques bloques;
+		string error;
+		if (!bloques.abrir(rutaBloq, error)) {
+			cout << "!!! ERROR: '" << rutaBloq << "': " << error << ". Se omiten sus filas.\n";
+			procesar(FilaCSV{ nullptr, 0, "no se pudo abrir el archivo de bloques", 0, TODOS_LOS_BLOQUES, {}, true });
+		}
+		else {
+			vector<string_view> encabezado;
+			string_view resto = bloques.encabezado(), campo;
+			while (siguienteCampoCSV(resto, campo)) encabezado.push_back(campo);
+			alEncabezado(encabezado);
+			auto incluir = [&](size_t b) {
+				if (!incluirBloque || incluirBloque(bloques.indice()[b])) return true;
+				CONTAR_METRICA(BloquesDescartados, 1);
+				return false;
+			};
+			bytes += decodificarBloques(bloques, hilosBloques(), incluir, [&](const BloqueLeido& b) {
+				if (!b.valido) {
+					procesar(FilaCSV{ nullptr, 0, "bloque danado (suma de verificacion)", 0, b.numero, {}, true });
+					return;
+				}
+				const BloqueDecodificado& d = *b.datos;
+				for (size_t f = 0; f < d.filas(); ++f) {
+					procesar(FilaCSV{ d.campos.data() + d.inicioFila[f], d.inicioFila[f + 1] - d.inicioFila[f], nullptr, 0, b.numero, {} });
+				}
+			}, true, detener);
+		}
+	}
+
+	LectorCSV lector(rutaCSV);
+	const char* error = nullptr;
+	if ((detener && detener->load()) || !lector.siguiente(error)) return bytes;
+	alEncabezado(lector.campos());
+	while (!(detener && detener->load()) && lector.siguiente(error)) {
+		const vector<string_view>& campos = lector.campos();
+		procesar(FilaCSV{ campos.data(), campos.size(), error, lector.numeroLinea(), 0, lector.textoRegistro() });
+	}
+	return bytes + lector.bytesLeidos();
+}
+
+struct ResultadoCompactacion {
+	uint64_t filas = 0;
+	uint64_t bytesCSV = 0;
+	uint64_t bytesBloques = 0;
+	size_t bloques = 0;
+};
+
+/**
+ * @brief Pasa las filas del CSV a bloques nuevos de '<ruta>.bloq' y deja el CSV solo con su
+ * encabezado. 'agrupar' ordena las filas por la primera columna antes de cortar los bloques
+ * (así el índice puede saltar más bloques en las búsquedas).
+ * No modifica nada si el CSV tiene filas mal formadas o su encabezado no coincide con el de los bloques.
+ */
+bool compactarTabla(const string& rutaCSV, bool agrupar, size_t filasPorBloque, ResultadoCompactacion& resultado, string& error) {
+	escritorArchivos.esperar(rutaCSV);
+	CandadoArchivo candado(rutaCSV, ModoCandado::Exclusivo); // Ninguna fila nueva entre la lectura y el recorte
+	LectorCSV lector(rutaCSV);
+	const char* errorFila = nullptr;
+	if (!lector.siguiente(errorFila)) { error = "no existe o esta vacio"; return false; }
+	const string encabezado(lector.textoRegistro());
+
+	const string rutaBloq = rutaBloques(rutaCSV);
+	ArchivoBloques bloques;
+	if (tamanoArchivo(rutaBloq) == 0 && !ArchivoBloques::crear(rutaBloq, encabezado)) { error = "no se pudo crear " + rutaBloq; return false; }
+	if (!bloques.abrir(rutaBloq, error)) return false;
+	if (bloques.encabezado() != encabezado) {
+		error = "el encabezado del CSV no coincide con el de '" + rutaBloq + "' (use --descomprimir primero)";
+		return false;
+	}
+
+	vector<pair<string, EntradaIndiceBloque>> nuevos;
+	FilasBloque filas;
+	vector<size_t> orden;
+	const vector<size_t> columnasFiltro = columnasConFiltro(encabezado);
+	uint32_t mascaraFiltro = 0;
+	for (size_t k : columnasFiltro) mascaraFiltro |= 1u << k;
+	vector<uint64_t> hashes;
+	auto cortar = [&](size_t desde, size_t hasta) {
+		EntradaIndiceBloque entrada;
+		entrada.filas = static_cast<uint32_t>(hasta - desde);
+		hashes.clear();
+		for (size_t i = desde; i < hasta; ++i) {
+			size_t f = orden.empty() ? i : orden[i];
+			string_view primera = filas.numCampos(f) ? filas.campo(f, 0) : string_view();
+			if (i == desde || primera < entrada.minimo) entrada.minimo = primera;
+			if (i == desde || primera > entrada.maximo) entrada.maximo = primera;
+			size_t texto = filas.numCampos(f);
+			for (size_t k = 0; k < filas.numCampos(f); ++k) texto += filas.campo(f, k).size();
+			entrada.bytesTexto += static_cast<uint32_t>(texto);
+			for (size_t k : columnasFiltro) if (k < filas.numCampos(f)) hashes.push_back(hashValorFiltro(k, filas.campo(f, k)));
+		}
+		sort(hashes.begin(), hashes.end());
+		hashes.erase(unique(hashes.begin(), hashes.end()), hashes.end());
+		if (mascaraFiltro) entrada.filtro.armar(mascaraFiltro, hashes);
+		string datos = codificarBloque(filas, orden, desde, hasta);
+		entrada.bytes = static_cast<uint32_t>(datos.size());
+		entrada.suma = sumaFNV(datos);
+		resultado.bytesBloques += datos.size();
+		nuevos.emplace_back(move(datos), move(entrada));
+	};
+
+	while (lector.siguiente(errorFila)) {
+		if (errorFila) {
+			error = "linea " + to_string(lector.numeroLinea()) + ": " + errorFila + " (corrijala con --validar)";
+			return false;
+		}
+		filas.agregar(lector.campos().data(), lector.campos().size());
+		++resultado.filas;
+		if (!agrupar && filas.filas() == filasPorBloque) {
+			cortar(0, filas.filas());
+			filas.limpiar();
+		}
+	}
+	if (agrupar && filas.filas() > 0) {
+		orden.resize(filas.filas());
+		iota(orden.begin(), orden.end(), size_t{ 0 });
+		stable_sort(orden.begin(), orden.end(), [&filas](size_t a, size_t b) {
+			string_view ca = filas.numCampos(a) ? filas.campo(a, 0) : string_view();
+			string_view cb = filas.numCampos(b) ? filas.campo(b, 0) : string_view();
+			return ca < cb;
+		});
+	}
+	for (size_t desde = 0; desde < filas.filas(); desde += filasPorBloque) cortar(desde, min(filas.filas(), desde + filasPorBloque));
+	resultado.bloques = nuevos.size();
+	resultado.bytesCSV = lector.bytesLeidos();
+	if (nuevos.empty()) return true;
+
+	if (!bloques.agregar(nuevos)) { error = "no se pudo escribir '" + rutaBloq + "'"; return false; }
+	const string temporal = rutaTemporal(rutaCSV);
+	{
+		ofstream csv(temporal, ios::binary | ios::trunc);
+		csv << encabezado << "\n";
+		if (!csv) { error = "no se pudo escribir '" + temporal + "'"; return false; }
+	}
+	error_code ec;
+	filesystem::rename(temporal, rutaCSV, ec);
+	if (ec) { error = ec.message(); filesystem::remove(temporal, ec); return false; }
+	return true;
+}
+
+/**
+ * @brief Regresa la tabla a un solo CSV: encabezado, filas de los bloques y al final las
+ * filas que ya estaban en el CSV. Se escribe a un temporal y se renombra.
+ */
+bool descomprimirTabla(const string& rutaCSV, uint64_t& filas, string& error) {
+	const string rutaBloq = rutaBloques(rutaCSV);
+	escritorArchivos.esperar(rutaCSV);
+	CandadoArchivo candado(rutaCSV, ModoCandado::Exclusivo);
+	ArchivoBloques bloques;
+	if (!bloques.abrir(rutaBloq, error)) return false;
+	const string temporal = rutaTemporal(rutaCSV);
+	{
+		ofstream out(temporal, ios::binary | ios::trunc);
+		out << bloques.encabezado() << "\n";
+		string linea;
+		bool hayDanados = false;
+		filas = 0;
+		decodificarBloques(bloques, hilosBloques(), [](size_t) { return true; }, [&](const BloqueLeido& b) {
+			if (!b.valido) { hayDanados = true; return; }
+			for (size_t f = 0; f < b.datos->filas(); ++f) {
+				FilaCSV fila{ b.datos->campos.data() + b.datos->inicioFila[f], b.datos->inicioFila[f + 1] - b.datos->inicioFila[f], nullptr, 0, b.numero, {} };
+				linea = textoFila(fila);
+				linea += '\n';
+				out.write(linea.data(), static_cast<streamsize>(linea.size()));
+				++filas;
+			}
+		});
+		if (hayDanados) { error = "hay bloques danados; no se modifico nada"; out.close(); remove(temporal.c_str()); return false; }
+		ifstream csv(rutaCSV, ios::binary);
+		getline(csv, linea); // Encabezado ya escrito
+		if (csv.peek() != char_traits<char>::eof()) out << csv.rdbuf();
+		if (!out) { error = "no se pudo escribir '" + temporal + "'"; return false; }
+	}
+	error_code ec;
+	filesystem::rename(temporal, rutaCSV, ec);
+	if (ec) { error = ec.message(); return false; }
+	filesystem::remove(rutaBloq, ec);
+	return true;
+}
+
+// Tablas por alias para la línea de comandos (también se acepta la ruta del CSV)
+string rutaTablaHistorica(const string& nombre) {
+	if (nombre == "ingresos") return NOMBRE_ARCHIVO_INGRESOS;
+	if (nombre == "taller") return NOMBRE_ARCHIVO_TALLER;
+	if (nombre == "km") return NOMBRE_ARCHIVO_KM;
+	if (nombre == "pila") return "registro_camiones_pila.csv";
+	return nombre;
+}
+
+/**
+ * @brief Modos de linea de comandos del almacenamiento por bloques:
+ *   --comprimir [tabla...] [--agrupar] [--filas-bloque <n>]
+ *   --descomprimir [tabla...]
+ *   --bloques <tabla> [--buscar <valor>]   (índice; con --buscar cuenta las filas cuya primera
+ *                                           columna empieza con <valor> leyendo solo los bloques posibles)
+ * Tablas: ingresos, taller, km, pila (por omisión las cuatro) o la ruta de un CSV.
+ */
+int ejecutarBloques(int argc, char* argv[]) {
+	const string modo = argv[1];
+	vector<string> tablas;
+	bool agrupar = false;
+	size_t filasPorBloque = FILAS_POR_BLOQUE;
+	string buscar;
+	bool hayBusqueda = false;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--agrupar") agrupar = true;
+		else if (arg == "--filas-bloque" && tieneValor) filasPorBloque = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (arg == "--buscar" && tieneValor) { buscar = argv[++i]; hayBusqueda = true; }
+		else if (arg.rfind("--", 0) != 0) tablas.push_back(rutaTablaHistorica(arg));
+		else {
+			cout << "Uso: Proyecto7.0 --comprimir [tabla...] [--agrupar] [--filas-bloque <n>]\n"
+				<< "     Proyecto7.0 --descomprimir [tabla...]\n"
+				<< "     Proyecto7.0 --bloques <tabla> [--buscar <valor>]\n";
+			return 1;
+		}
+	}
+	if (tablas.empty()) tablas = { NOMBRE_ARCHIVO_INGRESOS, NOMBRE_ARCHIVO_TALLER, NOMBRE_ARCHIVO_KM, "registro_camiones_pila.csv" };
+
+	int codigo = 0;
+	for (const string& ruta : tablas) {
+		string error;
+		auto inicio = chrono::steady_clock::now();
+		if (modo == "--comprimir") {
+			ResultadoCompactacion r;
+			if (!compactarTabla(ruta, agrupar, filasPorBloque, r, error)) {
+				cout << "!!! ERROR: '" << ruta << "': " << error << "\n";
+				codigo = 1;
+				continue;
+			}
+			double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+			cout << "[CSV ACTUALIZADO] " << ruta << ": " << r.filas << " filas en " << r.bloques << " bloques, "
+				<< fixed << setprecision(1) << r.bytesCSV / 1048576.0 << " MB -> " << r.bytesBloques / 1048576.0 << " MB ("
+				<< (r.bytesBloques ? static_cast<double>(r.bytesCSV) / r.bytesBloques : 0.0) << "x) en " << setprecision(2) << segundos << " s\n";
+		}
+		else if (modo == "--descomprimir") {
+			uint64_t filas = 0;
+			if (!descomprimirTabla(ruta, filas, error)) {
+				cout << "!!! ERROR: '" << rutaBloques(ruta) << "': " << error << "\n";
+				codigo = 1;
+				continue;
+			}
+			cout << "[CSV ACTUALIZADO] " << ruta << ": " << filas << " filas de los bloques regresaron al CSV.\n";
+		}
+		else {
+			CandadoArchivo candado = abrirLectura(ruta);
+			ArchivoBloques bloques;
+			if (!bloques.abrir(rutaBloques(ruta), error)) {
+				cout << "!!! ERROR: '" << rutaBloques(ruta) << "': " << error << "\n";
+				codigo = 1;
+				continue;
+			}
+			const auto& indice = bloques.indice();
+			uint64_t comprimidos = 0, texto = 0;
+			for (const auto& e : indice) { comprimidos += e.bytes; texto += e.bytesTexto; }
+			cout << "\n======= " << rutaBloques(ruta) << " =======\n";
+			cout << indice.size() << " bloques, " << bloques.filas() << " filas, " << fixed << setprecision(1)
+				<< texto / 1048576.0 << " MB de texto en " << comprimidos / 1048576.0 << " MB ("
+				<< (comprimidos ? static_cast<double>(texto) / comprimidos : 0.0) << "x)\n";
+			if (!hayBusqueda) {
+				for (size_t b = 0; b < indice.size() && b < 20; ++b) {
+					cout << "  Bloque " << setw(4) << b << ": " << setw(6) << indice[b].filas << " filas  " << setw(9) << indice[b].bytes
+						<< " bytes  filtro " << setw(7) << indice[b].filtro.bits.size() << " bytes  [" << indice[b].minimo << " .. " << indice[b].maximo << "]\n";
+				}
+				if (indice.size() > 20) cout << "  ... (" << (indice.size() - 20) << " bloques mas)\n";
+				continue;
+			}
+			// Un bloque puede tener filas que empiezan con 'buscar' solo si su rango lo permite
+			auto posible = [&](size_t b) {
+				const auto& e = indice[b];
+				return !(e.maximo < buscar) && !(e.minimo.compare(0, buscar.size(), buscar) > 0);
+			};
+			uint64_t coincidencias = 0;
+			size_t leidos = 0;
+			uint64_t bytes = decodificarBloques(bloques, hilosBloques(), posible, [&](const BloqueLeido& b) {
+				++leidos;
+				if (!b.valido) { cout << "!!! ERROR: bloque " << b.numero << " danado.\n"; return; }
+				const BloqueDecodificado& d = *b.datos;
+				for (size_t f = 0; f < d.filas(); ++f) {
+					if (d.inicioFila[f + 1] > d.inicioFila[f] && d.campos[d.inicioFila[f]].compare(0, buscar.size(), buscar) == 0) ++coincidencias;
+				}
+			});
+			double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+			cout << "[BUSQUEDA] " << coincidencias << " filas empiezan con '" << buscar << "'; se leyeron " << leidos << " de "
+				<< indice.size() << " bloques (" << setprecision(1) << bytes / 1048576.0 << " MB) en " << setprecision(3) << segundos << " s\n";
+		}
+	}
+	return codigo;
+}
+
+// Se mantiene la función de pila original (no usada en el Case 6). La fila se entrega al
+// escritor asíncrono, que pone el encabezado si el archivo va a quedar vacío.
+void guardarMovimientoCSV(const RegistroCamion& registro) {
+	MEDIR_OPERACION(GuardarMovimiento);
+	string fila;
+	fila.reserve(registro.hora.size() + registro.numeroCamion.size() + registro.conductor.size() + registro.tipoMovimiento.size() + 4);
+	fila.append(registro.hora).append(",").append(registro.numeroCamion).append(",")
+		.append(registro.conductor).append(",").append(registro.tipoMovimiento).append("\n");
+	escritorArchivos.agregar("registro_camiones_pila.csv", fila, "Fecha_Hora,Camion,Conductor,Movimiento\n");
+}
+
+
+// ======================= LÓGICA DEL SUBMENU 7 (PILA) =======================
+
+void registrarEntrada() {
+	cout << "\n======= REGISTRO DE ENTRADA (PUSH) =======\n";
+	if (camionesEnPatio.size() >= MAX_CAMIONES) {
+		cout << "!!! LIMITE ALCANZADO: El patio ya tiene el maximo de " << MAX_CAMIONES << " camiones." << endl;
+		return;
+	}
+
+	RegistroCamion nuevoRegistro;
 	nuevoRegistro.numeroCamion = pedirTexto("Ingrese el NUMERO del camion: ");
 	// Se reutiliza la funcion pedirTexto que usa getline
 	nuevoRegistro.conductor = pedirTexto("Ingrese el nombre del CONDUCTOR que ingresa: ");
 	nuevoRegistro.tipoMovimiento = "ENTRADA";
+
+	MEDIR_OPERACION(RegistrarEntrada);
 	nuevoRegistro.hora = obtenerHoraActual();
 
-	camionesEnPatio.push(nuevoRegistro);
+	camionesEnPatio.push(move(nuevoRegistro));
+	const RegistroCamion& registrado = camionesEnPatio.top();
+	guardarMovimientoCSV(registrado);
+
+	cout << "\n[REGISTRO EXITOSO] Camion: " << registrado.numeroCamion
+		<< " - Entrada registrada a las: " << registrado.hora << endl;
+	cout << "Camiones actualmente en patio: " << camionesEnPatio.size() << " de " << MAX_CAMIONES << endl;
+}
+
+void registrarSalida() {
+	cout << "\n======== REGISTRO DE SALIDA (POP) ========\n";
+	if (camionesEnPatio.empty()) {
+		cout << "!!! ERROR: El patio de camiones esta vacio. No hay salidas para registrar." << endl;
+		return;
+	}
+
+	const RegistroCamion& ultimoCamion = camionesEnPatio.top(); // Válida hasta el pop()
+
+	cout << "[ULTIMO CAMION EN ENTRAR] Camion: " << ultimoCamion.numeroCamion
+		<< ", Conductor: " << ultimoCamion.conductor
+		<< ", Hora de Entrada: " << ultimoCamion.hora << endl;
+	cout << "------------------------------------------------------" << endl;
+
+	string numCamionSalida = pedirTexto("Confirme el NUMERO del camion para salir: ");
+	string conductorSalida = pedirTexto("Ingrese el nombre del CONDUCTOR que sale: ");
+
+	if (numCamionSalida != ultimoCamion.numeroCamion) {
+		cout << "!!! ADVERTENCIA: El camion ingresado (" << numCamionSalida << ") no coincide con el ultimo en entrar (" << ultimoCamion.numeroCamion << ").\n";
+	}
+
+	MEDIR_OPERACION(RegistrarSalida);
+	camionesEnPatio.pop();
+
+	RegistroCamion registroSalida;
+	registroSalida.numeroCamion = move(numCamionSalida);
+	registroSalida.conductor = move(conductorSalida);
+	registroSalida.tipoMovimiento = "SALIDA";
+	registroSalida.hora = obtenerHoraActual();
+
+	guardarMovimientoCSV(registroSalida);
+
+	cout << "\n[REGISTRO EXITOSO] Camion: " << registroSalida.numeroCamion
+		<< " - Salida registrada a las: " << registroSalida.hora << endl;
+	cout << "Camiones actualmente en patio: " << camionesEnPatio.size() << " de " << MAX_CAMIONES << endl;
+}
+void mostrarRegistrosEnTabla() {
+	const string ruta = "registro_camiones_pila.csv";
+	if (tamanoArchivo(ruta) == 0 && tamanoArchivo(rutaBloques(ruta)) == 0) {
+		cout << "Aun no hay registros de movimientos de camiones guardados en el archivo CSV." << endl;
+		return;
+	}
+
+	cout << "\n======== HISTORIAL DE MOVIMIENTOS DE CAMIONES (TABLA) ========\n";
+	cout << "----------------------------------------------------------------------------------" << endl;
+	cout << "| " << left << setw(20) << "FECHA Y HORA"
+		<< "| " << left << setw(10) << "CAMION"
+		<< "| " << left << setw(20) << "CONDUCTOR"
+		<< "| " << left << setw(12) << "MOVIMIENTO" << "|" << endl;
+	cout << "----------------------------------------------------------------------------------" << endl;
+
+	// Primero el historial compactado (si hay) y luego las filas recientes del CSV
+	recorrerFilas(ruta, [](const vector<string_view>&) {}, [](const FilaCSV& fila) {
+		if (fila.error || fila.numCampos < 4) return;
+		cout << "| " << left << setw(20) << fila.campos[0]
+			<< "| " << left << setw(10) << fila.campos[1]
+			<< "| " << left << setw(20) << fila.campos[2]
+			<< "| " << left << setw(12) << fila.campos[3] << "|" << endl;
+	});
+	cout << "----------------------------------------------------------------------------------" << endl;
+}
+
+void menuCamionesPila() {
+	int opcion = 0;
+	while (opcion != 4) {
+		reportarFallosEscritura();
+		// system("cls"); // Descomentar para limpiar
+		cout << "\n======== REGISTRO DE CAMIONES (PILA: Max " << MAX_CAMIONES << ") ========" << endl;
+		cout << "Camiones actualmente en patio: " << camionesEnPatio.size() << " de " << MAX_CAMIONES << endl;
+		cout << "-----------------------------------------------------------------" << endl;
+		cout << "1. Registrar ENTRADA de camion (PUSH)" << endl;
+		cout << "2. Registrar SALIDA de camion (POP)" << endl;
+		cout << "3. Mostrar Historial de Registros (Tabla)" << endl;
+		cout << "4. Regresar al menu principal" << endl;
+		cout << "Seleccione una opcion: ";
+		cin >> opcion;
+		limpiarBuffer();
+		// system("cls"); // Descomentar para limpiar
+
+		switch (opcion) {
+		case 1:
+			registrarEntrada();
+			limpiarPantalla();
+			break;
+		case 2:
+			registrarSalida();
+			limpiarPantalla();
+			break;
+		case 3:
+			mostrarRegistrosEnTabla();
+			limpiarPantalla();
+			break;
+		case 4:
+			cout << "Regresando al menu principal..." << endl;
+			break;
+		default:
+			cout << "Opcion invalida. Intente de nuevo." << endl;
+			limpiarPantalla();
+			break;
+		}
+	}
+}
+
+
+// ======================= IMPLEMENTACIÓN CON ESTRUCTURAS =======================
+
+// Función que reemplaza a nomEmpresa(), nomAuditor(), etc.
+int aniosTrabajando(const DatosEmpresa& datos) {
+	return 2025 - datos.anioInicio;
+}
+
+// Función que utiliza la nueva estructura DatosEmpresa
+void mostrarEmpresa(DatosEmpresa& datos) {
+	// Pedir año de inicio del desarrollador (aunque el código original pedía "contratación del desarrollador")
+	cout << "Ingrese el anio de inicio de operaciones de la empresa: ";
+	cin >> datos.anioInicio;
+	limpiarBuffer();
+
+	cout << "\n======= DATOS DE LA EMPRESA =======" << endl;
+	cout << "Empresa: " << datos.nombre << endl;
+	cout << "Auditor: " << datos.auditor << endl;
+	cout << "Especialista 1: " << datos.especialista1 << endl;
+	cout << "Especialista 2: " << datos.especialista2 << endl;
+	// Se utiliza la función y el campo anioInicio de la estructura
+	cout << "Anios trabajando (desde " << datos.anioInicio << "): "
+		<< aniosTrabajando(datos) << endl;
+	cout << "Slogan: " << datos.slogan << endl;
+}
+
+// Función que utiliza la nueva estructura Chofer
+void mostrarChofer(const Chofer& chofer) {
+	cout << "\n--- DATOS DEL CHOFER ---" << endl;
+	cout << "Nombre: " << chofer.nombre << endl;
+	cout << "ID de chofer: " << chofer.id << endl;
+	cout << "Edad: " << chofer.edad << " anios" << endl;
+	cout << "Telefono: " << chofer.telefono << endl;
+	cout << "Codigo Postal: " << chofer.codigoPostal << endl;
+}
+
+// Función que utiliza la nueva estructura UnidadTransporte
+void mostrarUnidad(const UnidadTransporte& unidad) {
+	cout << "\n--- DATOS DE UNIDAD DE TRANSPORTE ---" << endl;
+	cout << "ID de camion: " << unidad.idCamion << endl;
+	cout << "Placas: " << unidad.placas << endl;
+	cout << "Color: " << unidad.color << endl;
+	cout << "Anio: " << unidad.anio << endl;
+	cout << "Chofer: " << unidad.choferAsignado << endl;
+	cout << "Anios en la empresa: " << unidad.aniosEnEmpresa << endl;
+}
+
+// ======================= REGISTROS PERSISTENTES (CHOFERES Y UNIDADES) =======================
+// choferes.dat y unidades.dat guardan registros de tamaño fijo (128 bytes) después de una
+// cabecera de 16 bytes: cada registro se lee o reescribe en su lugar con un solo seek.
+// Los índices (hash) se arman en memoria al abrir: id de chofer; id de camión, placas y
+// chofer asignado para las unidades. Los registros borrados dejan un hueco que se reutiliza.
+// El formato usa el orden de bytes de la máquina (little-endian en x86/ARM).
+
+const string NOMBRE_ARCHIVO_CHOFERES = "choferes.dat";
+const string NOMBRE_ARCHIVO_UNIDADES = "unidades.dat";
+
+struct CabeceraArchivoFijo {
+	char firma[8];          // "P7CHOFER" o "P7UNIDAD"
+	uint32_t version;
+	uint32_t tamRegistro;
+};
+
+struct ChoferFijo {
+	int32_t id;
+	int32_t edad;
+	int32_t codigoPostal;
+	uint8_t activo;         // 0 = hueco de un registro borrado
+	uint8_t reservado[3];
+	char nombre[80];
+	char telefono[32];
+};
+static_assert(sizeof(ChoferFijo) == 128, "ChoferFijo debe medir 128 bytes");
+
+struct UnidadFijo {
+	int32_t idCamion;
+	int32_t placas;
+	int32_t anio;
+	int32_t aniosEnEmpresa;
+	uint8_t activo;
+	uint8_t reservado[3];
+	char color[28];
+	char choferAsignado[80];
+};
+static_assert(sizeof(UnidadFijo) == 128, "UnidadFijo debe medir 128 bytes");
+
+// Copia con truncado; el arreglo siempre queda terminado en '\0'
+template<size_t N>
+void copiarTextoFijo(char (&destino)[N], const string& origen) {
+	size_t n = min(origen.size(), N - 1);
+	memcpy(destino, origen.data(), n);
+	memset(destino + n, 0, N - n);
+}
+
+template<size_t N>
+string leerTextoFijo(const char (&origen)[N]) {
+	return string(origen, strnlen(origen, N));
+}
+
+ChoferFijo aFijo(const Chofer& c) {
+	ChoferFijo f{};
+	f.id = c.id; f.edad = c.edad; f.codigoPostal = c.codigoPostal; f.activo = 1;
+	copiarTextoFijo(f.nombre, c.nombre);
+	copiarTextoFijo(f.telefono, c.telefono);
+	return f;
+}
+
+Chofer desdeFijo(const ChoferFijo& f) {
+	return Chofer{ leerTextoFijo(f.nombre), f.id, f.edad, leerTextoFijo(f.telefono), f.codigoPostal };
+}
+
+UnidadFijo aFijo(const UnidadTransporte& u) {
+	UnidadFijo f{};
+	f.idCamion = u.idCamion; f.placas = u.placas; f.anio = u.anio; f.aniosEnEmpresa = u.aniosEnEmpresa; f.activo = 1;
+	copiarTextoFijo(f.color, u.color);
+	copiarTextoFijo(f.choferAsignado, u.choferAsignado);
+	return f;
+}
+
+UnidadTransporte desdeFijo(const UnidadFijo& f) {
+	return UnidadTransporte{ f.idCamion, f.placas, leerTextoFijo(f.color), f.anio, leerTextoFijo(f.choferAsignado), f.aniosEnEmpresa };
+}
+
+/**
+ * @brief Archivo de registros de tamaño fijo con sus ranuras en memoria.
+ * La ranura i vive en el byte sizeof(Cabecera) + i * sizeof(Fijo) del archivo.
+ */
+template<typename Fijo>
+class ArchivoFijo {
+	string ruta;
+	const char* firma;
+	fstream archivo;
+	vector<Fijo> ranuras;
+	vector<uint32_t> libres;
+
+	// false si no se pudo escribir (el flujo se limpia para que la siguiente escritura lo intente)
+	bool escribirRanura(uint32_t i) {
+		archivo.seekp(static_cast<streamoff>(sizeof(CabeceraArchivoFijo) + uint64_t(i) * sizeof(Fijo)));
+		archivo.write(reinterpret_cast<const char*>(&ranuras[i]), sizeof(Fijo));
+		archivo.flush();
+		if (!archivo) {
+			archivo.clear();
+			return false;
+		}
+		CONTAR_METRICA(BytesEscritos, sizeof(Fijo));
+		return true;
+	}
+
+public:
+	explicit ArchivoFijo(const char* firmaArchivo) : firma(firmaArchivo) {}
+
+	// Abre (o crea) el archivo y lee todas las ranuras; false si la cabecera no corresponde
+	bool abrir(const string& rutaArchivo) {
+		ruta = rutaArchivo;
+		ranuras.clear();
+		libres.clear();
+		if (archivo.is_open()) archivo.close();
+		CabeceraArchivoFijo esperada{};
+		memcpy(esperada.firma, firma, sizeof(esperada.firma));
+		esperada.version = 1;
+		esperada.tamRegistro = sizeof(Fijo);
+
+		archivo.open(ruta, ios::in | ios::out | ios::binary);
+		if (!archivo.is_open()) {
+			archivo.clear();
+			archivo.open(ruta, ios::out | ios::binary);
+			archivo.write(reinterpret_cast<const char*>(&esperada), sizeof(esperada));
+			archivo.close();
+			archivo.open(ruta, ios::in | ios::out | ios::binary);
+			return archivo.is_open();
+		}
+		CabeceraArchivoFijo cabecera{};
+		archivo.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera));
+		if (!archivo || memcmp(&cabecera, &esperada, sizeof(cabecera)) != 0) {
+			cout << "!!! ERROR: '" << ruta << "' no es un archivo de registros valido.\n";
+			archivo.close();
+			return false;
+		}
+		uint64_t bytes = tamanoArchivo(ruta) - sizeof(cabecera);
+		ranuras.resize(bytes / sizeof(Fijo));
+		archivo.read(reinterpret_cast<char*>(ranuras.data()), static_cast<streamsize>(ranuras.size() * sizeof(Fijo)));
+		archivo.clear();
+		CONTAR_METRICA(BytesLeidos, bytes);
+		for (uint32_t i = 0; i < ranuras.size(); ++i) {
+			if (!ranuras[i].activo) libres.push_back(i);
+		}
+		return true;
+	}
+
+	const vector<Fijo>& todas() const { return ranuras; }
+	const Fijo& en(uint32_t i) const { return ranuras[i]; }
+
+	// Las tres escrituras dejan la ranura en memoria como estaba si el disco falla (y regresan false)
+
+	// Escribe en un hueco libre (o al final); 'i' es la ranura usada
+	bool insertar(const Fijo& registro, uint32_t& i) {
+		const bool enHueco = !libres.empty();
+		Fijo anterior{};
+		if (enHueco) { i = libres.back(); anterior = ranuras[i]; ranuras[i] = registro; }
+		else { i = static_cast<uint32_t>(ranuras.size()); ranuras.push_back(registro); }
+		if (escribirRanura(i)) {
+			if (enHueco) libres.pop_back();
+			return true;
+		}
+		if (enHueco) ranuras[i] = anterior;
+		else ranuras.pop_back();
+		return false;
+	}
+
+	bool reemplazar(uint32_t i, const Fijo& registro) {
+		Fijo anterior = ranuras[i];
+		ranuras[i] = registro;
+		if (escribirRanura(i)) return true;
+		ranuras[i] = anterior;
+		return false;
+	}
+
+	bool borrar(uint32_t i) {
+		ranuras[i].activo = 0;
+		if (!escribirRanura(i)) {
+			ranuras[i].activo = 1;
+			return false;
+		}
+		libres.push_back(i);
+		return true;
+	}
+
+	size_t activos() const { return ranuras.size() - libres.size(); }
+};
+
+// Resultado de un alta, actualización o baja en los registros
+enum class ResultadoRegistro { Registrado, Actualizado, Eliminado, NoEncontrado, ErrorEscritura };
+
+class RegistroChoferes {
+	ArchivoFijo<ChoferFijo> archivo{ "P7CHOFER" };
+	unordered_map<int32_t, uint32_t> porId;
+public:
+	bool abrir(const string& ruta) {
+		porId.clear();
+		if (!archivo.abrir(ruta)) return false;
+		const auto& ranuras = archivo.todas();
+		porId.reserve(ranuras.size());
+		for (uint32_t i = 0; i < ranuras.size(); ++i) {
+			if (ranuras[i].activo) porId[ranuras[i].id] = i;
+		}
+		return true;
+	}
+
+	// Alta o actualización por id
+	ResultadoRegistro guardar(const Chofer& chofer) {
+		auto it = porId.find(chofer.id);
+		if (it != porId.end()) {
+			return archivo.reemplazar(it->second, aFijo(chofer)) ? ResultadoRegistro::Actualizado : ResultadoRegistro::ErrorEscritura;
+		}
+		uint32_t i;
+		if (!archivo.insertar(aFijo(chofer), i)) return ResultadoRegistro::ErrorEscritura;
+		porId[chofer.id] = i;
+		return ResultadoRegistro::Registrado;
+	}
+
+	ResultadoRegistro eliminar(int32_t id) {
+		auto it = porId.find(id);
+		if (it == porId.end()) return ResultadoRegistro::NoEncontrado;
+		if (!archivo.borrar(it->second)) return ResultadoRegistro::ErrorEscritura;
+		porId.erase(it);
+		return ResultadoRegistro::Eliminado;
+	}
+
+	const ChoferFijo* buscar(int32_t id) const {
+		auto it = porId.find(id);
+		return it == porId.end() ? nullptr : &archivo.en(it->second);
+	}
+
+	template<typename Funcion>
+	void paraCada(Funcion f) const {
+		for (const auto& r : archivo.todas()) if (r.activo) f(r);
+	}
+	size_t tamano() const { return porId.size(); }
+};
+
+class RegistroUnidades {
+	ArchivoFijo<UnidadFijo> archivo{ "P7UNIDAD" };
+	unordered_map<int32_t, uint32_t> porId;
+	unordered_map<int32_t, uint32_t> porPlacas;
+	unordered_multimap<string, uint32_t> porChofer;
+
+	void indexar(uint32_t i) {
+		const UnidadFijo& u = archivo.en(i);
+		porId[u.idCamion] = i;
+		porPlacas[u.placas] = i;
+		porChofer.emplace(leerTextoFijo(u.choferAsignado), i);
+	}
+
+	void desindexar(uint32_t i) {
+		const UnidadFijo& u = archivo.en(i);
+		porId.erase(u.idCamion);
+		auto placas = porPlacas.find(u.placas);
+		if (placas != porPlacas.end() && placas->second == i) porPlacas.erase(placas);
+		auto rango = porChofer.equal_range(leerTextoFijo(u.choferAsignado));
+		for (auto it = rango.first; it != rango.second; ++it) {
+			if (it->second == i) { porChofer.erase(it); break; }
+		}
+	}
+
+public:
+	bool abrir(const string& ruta) {
+		porId.clear(); porPlacas.clear(); porChofer.clear();
+		if (!archivo.abrir(ruta)) return false;
+		const auto& ranuras = archivo.todas();
+		porId.reserve(ranuras.size());
+		porPlacas.reserve(ranuras.size());
+		for (uint32_t i = 0; i < ranuras.size(); ++i) {
+			if (ranuras[i].activo) indexar(i);
+		}
+		return true;
+	}
+
+	// Alta o actualización por id de camión
+	ResultadoRegistro guardar(const UnidadTransporte& unidad) {
+		auto it = porId.find(unidad.idCamion);
+		if (it != porId.end()) {
+			uint32_t i = it->second;
+			desindexar(i);
+			bool escrito = archivo.reemplazar(i, aFijo(unidad));
+			indexar(i);            // La ranura nueva, o la anterior si no se pudo escribir
+			return escrito ? ResultadoRegistro::Actualizado : ResultadoRegistro::ErrorEscritura;
+		}
+		uint32_t i;
+		if (!archivo.insertar(aFijo(unidad), i)) return ResultadoRegistro::ErrorEscritura;
+		indexar(i);
+		return ResultadoRegistro::Registrado;
+	}
+
+	ResultadoRegistro eliminar(int32_t idCamion) {
+		auto it = porId.find(idCamion);
+		if (it == porId.end()) return ResultadoRegistro::NoEncontrado;
+		uint32_t i = it->second;
+		if (!archivo.borrar(i)) return ResultadoRegistro::ErrorEscritura;
+		desindexar(i);
+		return ResultadoRegistro::Eliminado;
+	}
+
+	const UnidadFijo* buscar(int32_t idCamion) const {
+		auto it = porId.find(idCamion);
+		return it == porId.end() ? nullptr : &archivo.en(it->second);
+	}
+
+	const UnidadFijo* buscarPorPlacas(int32_t placas) const {
+		auto it = porPlacas.find(placas);
+		return it == porPlacas.end() ? nullptr : &archivo.en(it->second);
+	}
+
+	vector<const UnidadFijo*> unidadesDeChofer(const string& chofer) const {
+		vector<const UnidadFijo*> unidades;
+		auto rango = porChofer.equal_range(chofer);
+		for (auto it = rango.first; it != rango.second; ++it) unidades.push_back(&archivo.en(it->second));
+		return unidades;
+	}
+
+	/**
+	 * @brief Resuelve el texto "Camion" de las tablas CSV (ej. "104") a su unidad registrada.
+	 * @return nullptr si el texto no es un id numérico o no hay unidad con ese id.
+	 */
+	const UnidadFijo* resolverCamion(string_view camion) const {
+		int32_t id = 0;
+		auto r = from_chars(camion.data(), camion.data() + camion.size(), id);
+		if (r.ec != errc() || r.ptr != camion.data() + camion.size()) return nullptr;
+		return buscar(id);
+	}
+
+	template<typename Funcion>
+	void paraCada(Funcion f) const {
+		for (const auto& r : archivo.todas()) if (r.activo) f(r);
+	}
+	size_t tamano() const { return porId.size(); }
+};
+
+RegistroChoferes registroChoferes;
+RegistroUnidades registroUnidades;
+
+// false si alguno no se pudo abrir (el módulo queda para reintentarse en el siguiente uso)
+bool cargarRegistros() {
+	bool choferes = registroChoferes.abrir(NOMBRE_ARCHIVO_CHOFERES);
+	bool unidades = registroUnidades.abrir(NOMBRE_ARCHIVO_UNIDADES);
+	return choferes && unidades;
+}
+
+// Se abren al primer uso (los modos de linea de comandos que no los usan no pagan la carga)
+bool abrirRegistros() {
+	if (asegurarModulo(Modulo::Registros)) return true;
+	cout << "!!! ERROR: Los registros de choferes y unidades no se pudieron abrir ('" << NOMBRE_ARCHIVO_CHOFERES << "', '"
+		<< NOMBRE_ARCHIVO_UNIDADES << "'); se reintentara la proxima vez.\n";
+	return false;
+}
+
+void menuChoferes() {
+	if (!abrirRegistros()) return;
+	int opcion = 0;
+	while (opcion != 5) {
+		cout << "\n======= CHOFERES (" << registroChoferes.tamano() << " en '" << NOMBRE_ARCHIVO_CHOFERES << "') =======" << endl;
+		cout << "1. Registrar o actualizar chofer" << endl;
+		cout << "2. Buscar chofer por ID" << endl;
+		cout << "3. Listar choferes" << endl;
+		cout << "4. Eliminar chofer" << endl;
+		cout << "5. Regresar al menu principal" << endl;
+		opcion = pedirEntero("Seleccione una opcion: ");
+
+		switch (opcion) {
+		case 1: {
+			Chofer nuevoChofer;
+			cout << "======= INGRESO DE DATOS DEL CHOFER =======" << endl;
+			nuevoChofer.nombre = pedirTexto("Ingrese nombre del chofer: ");
+			nuevoChofer.id = pedirEntero("Ingrese numero de chofer: ");
+			int anioNacimiento = pedirEntero("Ingrese anio de nacimiento del chofer: ");
+			nuevoChofer.edad = 2025 - anioNacimiento;
+			nuevoChofer.telefono = pedirTexto("Ingrese telefono del chofer: ");
+			nuevoChofer.codigoPostal = pedirEntero("Ingrese codigo postal del chofer: ");
+			mostrarChofer(nuevoChofer);
+			ResultadoRegistro resultado = registroChoferes.guardar(nuevoChofer);
+			if (resultado == ResultadoRegistro::ErrorEscritura) {
+				cout << "!!! ERROR: No se pudo escribir en '" << NOMBRE_ARCHIVO_CHOFERES << "'. El chofer no se guardo.\n";
+			}
+			else {
+				cout << (resultado == ResultadoRegistro::Actualizado ? "[ACTUALIZADO] " : "[REGISTRADO] ") << "Chofer #" << nuevoChofer.id
+					<< " guardado en '" << NOMBRE_ARCHIVO_CHOFERES << "'.\n";
+			}
+			pausaYLimpiar();
+			break;
+		}
+		case 2: {
+			const ChoferFijo* c = registroChoferes.buscar(pedirEntero("ID del chofer: "));
+			if (c) {
+				mostrarChofer(desdeFijo(*c));
+				auto unidades = registroUnidades.unidadesDeChofer(leerTextoFijo(c->nombre));
+				for (const UnidadFijo* u : unidades) cout << "Unidad asignada: camion " << u->idCamion << " (placas " << u->placas << ")\n";
+			}
+			else cout << "[NO ENCONTRADO] No existe un chofer con ese ID.\n";
+			pausaYLimpiar();
+			break;
+		}
+		case 3:
+			cout << left << setw(8) << "ID" << setw(30) << "NOMBRE" << setw(6) << "EDAD" << setw(16) << "TELEFONO" << "C.P.\n";
+			registroChoferes.paraCada([](const ChoferFijo& c) {
+				cout << left << setw(8) << c.id << setw(30) << c.nombre << setw(6) << c.edad << setw(16) << c.telefono << c.codigoPostal << "\n";
+			});
+			pausaYLimpiar();
+			break;
+		case 4:
+			switch (registroChoferes.eliminar(pedirEntero("ID del chofer a eliminar: "))) {
+			case ResultadoRegistro::Eliminado: cout << "[ELIMINACION EXITOSA] Chofer eliminado.\n"; break;
+			case ResultadoRegistro::NoEncontrado: cout << "[ADVERTENCIA] No existe un chofer con ese ID.\n"; break;
+			default: cout << "!!! ERROR: No se pudo escribir en '" << NOMBRE_ARCHIVO_CHOFERES << "'. El chofer no se elimino.\n"; break;
+			}
+			pausaYLimpiar();
+			break;
+		case 5:
+			break;
+		default:
+			cout << "Opcion invalida. Intente de nuevo." << endl;
+		}
+	}
+}
+
+void mostrarUnidadFija(const UnidadFijo* u) {
+	if (u) mostrarUnidad(desdeFijo(*u));
+	else cout << "[NO ENCONTRADO] No existe una unidad con ese dato.\n";
+}
+
+void menuUnidades() {
+	if (!abrirRegistros()) return;
+	int opcion = 0;
+	while (opcion != 7) {
+		cout << "\n======= UNIDADES (" << registroUnidades.tamano() << " en '" << NOMBRE_ARCHIVO_UNIDADES << "') =======" << endl;
+		cout << "1. Registrar o actualizar unidad" << endl;
+		cout << "2. Buscar unidad por ID de camion" << endl;
+		cout << "3. Buscar unidad por placas" << endl;
+		cout << "4. Unidades asignadas a un chofer" << endl;
+		cout << "5. Listar unidades" << endl;
+		cout << "6. Eliminar unidad" << endl;
+		cout << "7. Regresar al menu principal" << endl;
+		opcion = pedirEntero("Seleccione una opcion: ");
+
+		switch (opcion) {
+		case 1: {
+			UnidadTransporte nuevaUnidad;
+			cout << "======= INGRESO DE DATOS DE LA UNIDAD =======" << endl;
+			nuevaUnidad.idCamion = pedirEntero("Ingrese ID del camion: ");
+			nuevaUnidad.placas = pedirEntero("Ingrese numero de placas (solo numeros): ");
+			nuevaUnidad.color = pedirTexto("Ingrese color del camion: ");
+			nuevaUnidad.anio = pedirEntero("Ingrese anio del camion: ");
+			nuevaUnidad.choferAsignado = pedirTexto("Ingrese nombre del chofer asignado: ");
+			nuevaUnidad.aniosEnEmpresa = pedirEntero("Ingrese anios en la empresa del chofer: ");
+			mostrarUnidad(nuevaUnidad);
+			const UnidadFijo* conPlacas = registroUnidades.buscarPorPlacas(nuevaUnidad.placas);
+			if (conPlacas && conPlacas->idCamion != nuevaUnidad.idCamion) {
+				cout << "[ADVERTENCIA] Las placas " << nuevaUnidad.placas << " ya estan registradas en el camion "
+					<< conPlacas->idCamion << ". No se guardo la unidad.\n";
+			}
+			else {
+				ResultadoRegistro resultado = registroUnidades.guardar(nuevaUnidad);
+				if (resultado == ResultadoRegistro::ErrorEscritura) {
+					cout << "!!! ERROR: No se pudo escribir en '" << NOMBRE_ARCHIVO_UNIDADES << "'. La unidad no se guardo.\n";
+				}
+				else {
+					cout << (resultado == ResultadoRegistro::Actualizado ? "[ACTUALIZADO] " : "[REGISTRADO] ") << "Camion " << nuevaUnidad.idCamion
+						<< " guardado en '" << NOMBRE_ARCHIVO_UNIDADES << "'.\n";
+				}
+			}
+			pausaYLimpiar();
+			break;
+		}
+		case 2:
+			mostrarUnidadFija(registroUnidades.buscar(pedirEntero("ID del camion: ")));
+			pausaYLimpiar();
+			break;
+		case 3:
+			mostrarUnidadFija(registroUnidades.buscarPorPlacas(pedirEntero("Placas: ")));
+			pausaYLimpiar();
+			break;
+		case 4: {
+			auto unidades = registroUnidades.unidadesDeChofer(pedirTexto("Nombre del chofer: "));
+			if (unidades.empty()) cout << "[NO ENCONTRADO] El chofer no tiene unidades asignadas.\n";
+			for (const UnidadFijo* u : unidades) mostrarUnidadFija(u);
+			pausaYLimpiar();
+			break;
+		}
+		case 5:
+			cout << left << setw(10) << "CAMION" << setw(10) << "PLACAS" << setw(12) << "COLOR" << setw(6) << "ANIO" << "CHOFER\n";
+			registroUnidades.paraCada([](const UnidadFijo& u) {
+				cout << left << setw(10) << u.idCamion << setw(10) << u.placas << setw(12) << u.color << setw(6) << u.anio << u.choferAsignado << "\n";
+			});
+			pausaYLimpiar();
+			break;
+		case 6:
+			switch (registroUnidades.eliminar(pedirEntero("ID del camion a eliminar: "))) {
+			case ResultadoRegistro::Eliminado: cout << "[ELIMINACION EXITOSA] Unidad eliminada.\n"; break;
+			case ResultadoRegistro::NoEncontrado: cout << "[ADVERTENCIA] No existe una unidad con ese ID.\n"; break;
+			default: cout << "!!! ERROR: No se pudo escribir en '" << NOMBRE_ARCHIVO_UNIDADES << "'. La unidad no se elimino.\n"; break;
+			}
+			pausaYLimpiar();
+			break;
+		case 7:
+			break;
+		default:
+			cout << "Opcion invalida. Intente de nuevo." << endl;
+		}
+	}
+}
+
+/**
+ * @brief Al capturar ingresos o kilometraje: si el camión está registrado y tiene chofer
+ * asignado, se ofrece ese chofer en lugar de volver a escribir el nombre.
+ */
+string pedirChoferDeCamion(const string& camion, string_view mensaje) {
+	abrirRegistros();
+	const UnidadFijo* unidad = registroUnidades.resolverCamion(camion);
+	if (unidad && unidad->choferAsignado[0] != '\0') {
+		string asignado = leerTextoFijo(unidad->choferAsignado);
+		string respuesta = pedirTexto("Chofer asignado al camion " + camion + ": " + asignado + " (ENTER para usarlo u otro nombre): ");
+		return respuesta.empty() ? asignado : respuesta;
+	}
+	return pedirTexto(mensaje);
+}
+
+// ======================= SUBMENU 5: RECURSIVIDAD (Cálculo de Sueldo) =======================
+
+// Nombres de meses para mostrar (tabla constante: no se reconstruye en cada llamada)
+constexpr const char* NOMBRES_MESES[] = { "Enero", "Febrero", "Marzo", "Abril", "Mayo", "Junio",
+										  "Julio", "Agosto", "Septiembre", "Octubre", "Noviembre", "Diciembre" };
+
+/**
+ * @brief Función recursiva que pide sueldos del mes más reciente al más antiguo.
+ * @param mesActual El índice del mes actual (comienza en totalMeses, termina en 1 - el más antiguo).
+ * @param totalMeses El número total de meses a calcular (límite superior).
+ * @return double El sueldo total acumulado desde el mes más antiguo hasta mesActual.
+ */
+double calcularSueldoAcumuladoRecursivo(int mesActual, int totalMeses) {
+	// Cálculo para asignar un nombre de mes de forma cíclica (0 a 11)
+	int indiceMes = (mesActual - 1) % 12;
+	const char* nombreMes = NOMBRES_MESES[indiceMes];
+
+	double sueldoMes;
+	double sueldoAcumulado = 0.0;
+
+	// 1. Pedir el sueldo del mes (del más reciente al más antiguo)
+	cout << "Ingrese sueldo para el mes de " << nombreMes << " (Mes #" << mesActual << " de " << totalMeses << "): $";
+
+	// Lectura de sueldo con manejo de error básico
+	if (!(cin >> sueldoMes)) {
+		cin.clear();
+		limpiarBuffer();
+		cout << "!!! Advertencia: Entrada invalida. Usando sueldo de $0.00 para este mes.\n";
+		sueldoMes = 0.0;
+	}
+
+	// 2. Llamada recursiva para el mes anterior
+	if (mesActual > 1) {
+		// La llamada recursiva devuelve la suma de los sueldos de los meses 1 hasta mesActual-1
+		sueldoAcumulado = calcularSueldoAcumuladoRecursivo(mesActual - 1, totalMeses);
+	}
+	else {
+		// Caso Base: mesActual == 1 (el mes más antiguo)
+		cout << "\n--- Sueldos ingresados. Mostrando resultados de mas antiguo a mas reciente ---\n";
+		sueldoAcumulado = 0.0; // La base de la acumulación es 0
+	}
+
+	// 3. Después de regresar (desenrollando la pila): Imprimir y Acumular
+	sueldoAcumulado += sueldoMes;
+
+	// 3. (Continuación) Imprimir el sueldo y el acumulado (Orden: Antiguo -> Reciente)
+	cout << fixed << setprecision(2);
+	cout << "[Mes: " << nombreMes << " (Mes " << mesActual << ")] Sueldo: $" << setw(10) << sueldoMes
+		<< " | Acumulado: $" << setw(10) << sueldoAcumulado << endl;
+
+	// 4. Retornar el sueldo acumulado (incluyendo el mes actual)
+	return sueldoAcumulado;
+}
+
+void menuCalculoSueldoRecursivo() {
+	int totalMeses;
+	string nombreEmpleado = pedirTexto("Ingrese el nombre del empleado para calcular su sueldo acumulado: ");
+
+	do {
+		cout << "Ingrese el numero de meses (N) a calcular (minimo 1, maximo 12): ";
+		// Lectura de totalMeses con manejo de error
+		if (!(cin >> totalMeses)) {
+			cin.clear();
+			limpiarBuffer();
+			totalMeses = 0; // Para que el bucle repita
+		}
+		limpiarBuffer();
+
+		if (totalMeses <= 0 || totalMeses > 12) {
+			cout << "Numero de meses invalido. Debe ser entre 1 y 12.\n";
+		}
+	} while (totalMeses <= 0 || totalMeses > 12);
+
+	// system("cls"); // Descomentar para limpiar
+	cout << "======= CALCULO DE SUELDO ACUMULADO PARA " << nombreEmpleado << " (" << totalMeses << " MESES) =======\n\n";
+
+	// Inicia la recursión desde el mes más reciente (totalMeses) hasta el más antiguo (1)
+	double sueldoFinal = calcularSueldoAcumuladoRecursivo(totalMeses, totalMeses);
+
+	cout << "\n=================================================================\n";
+	cout << "RESULTADO FINAL: El sueldo acumulado total en " << totalMeses
+		<< " meses para " << nombreEmpleado << " es: $" << fixed << setprecision(2) << sueldoFinal << endl;
+	cout << "=================================================================\n";
+}
+
+
+// ======================= MOTOR DE NOMINA (SUELDOS ACUMULADOS) =======================
+// Sueldos mensuales de toda la plantilla leídos de sueldos_empleados.csv
+// (Empleado,Mes_1,...,Mes_N; cada empleado puede tener un número distinto de meses).
+// Los acumulados son sumas prefijo por empleado, iterativas o en paralelo, sin límite de meses.
+
+const string NOMBRE_ARCHIVO_SUELDOS = "sueldos_empleados.csv";
+const string NOMBRE_ARCHIVO_ACUMULADOS = "acumulados_nomina.csv";
+
+// Todas las series en un solo arreglo: los meses del empleado i son [inicio[i], inicio[i+1])
+struct NominaEmpleados {
+	vector<string> empleados;
+	vector<size_t> inicio = { 0 };
+	vector<Centavos> sueldos;
+	uint64_t rechazadas = 0;   // Filas mal formadas o con un sueldo que no es un monto (no se cargan)
+
+	size_t numEmpleados() const { return empleados.size(); }
+	size_t mesesDe(size_t i) const { return inicio[i + 1] - inicio[i]; }
+	void agregar(string_view empleado) { empleados.emplace_back(empleado); inicio.push_back(sueldos.size()); }
+};
+
+NominaEmpleados cargarNomina(const string& ruta) {
+	MEDIR_OPERACION(CargarNomina);
+	NominaEmpleados nomina;
+	CandadoArchivo candado = abrirLectura(ruta);
+	LectorCSV lector(ruta);
+	const char* error = nullptr;
+	if (!lector.siguiente(error)) return nomina; // Ignorar encabezados
+	nomina.sueldos.reserve(tamanoArchivo(ruta) / 8);
+	// Una fila con un sueldo ilegible no se carga: tomarlo como 0 bajaría su acumulado sin aviso
+	auto rechazar = [&](const string& motivo) {
+		++nomina.rechazadas;
+		CONTAR_METRICA(ErroresParseo, 1);
+		if (nomina.rechazadas <= 10) cout << "[ADVERTENCIA] Linea " << lector.numeroLinea() << " de '" << ruta << "' rechazada: " << motivo << "\n";
+	};
+	while (lector.siguiente(error)) {
+		const vector<string_view>& campos = lector.campos();
+		if (error) { rechazar(error); continue; }
+		if (campos[0].empty()) { rechazar("sin nombre de empleado"); continue; }
+		size_t n = campos.size();
+		if (n > 1 && campos[n - 1].empty()) --n; // Coma final
+		const size_t antes = nomina.sueldos.size();
+		size_t invalido = 0;
+		for (size_t k = 1; k < n && invalido == 0; ++k) {
+			Centavos sueldo = 0;
+			if (convertirCentavos(campos[k], sueldo)) nomina.sueldos.push_back(sueldo);
+			else invalido = k;
+		}
+		if (invalido != 0) {
+			nomina.sueldos.resize(antes);
+			rechazar("sueldo no numerico '" + string(campos[invalido].substr(0, 20)) + "' en la columna " + to_string(invalido + 1));
+			continue;
+		}
+		nomina.agregar(campos[0]);
+		CONTAR_METRICA(FilasLeidas, 1);
+	}
+	if (nomina.rechazadas > 10) cout << "[ADVERTENCIA] ... y " << (nomina.rechazadas - 10) << " filas rechazadas mas.\n";
+	CONTAR_METRICA(BytesLeidos, lector.bytesLeidos());
+	return nomina;
+}
+
+// Suma prefijo de un tramo: destino[k] = base + valores[0] + ... + valores[k]; regresa el último
+Centavos acumularTramo(const Centavos* valores, Centavos* destino, size_t n, Centavos base) {
+	for (size_t k = 0; k < n; ++k) {
+		base += valores[k];
+		destino[k] = base;
+	}
+	return base;
+}
+
+// Acumulados de toda la nómina en un solo hilo
+vector<Centavos> acumularNomina(const NominaEmpleados& nomina) {
+	vector<Centavos> acumulados(nomina.sueldos.size());
+	for (size_t i = 0; i < nomina.numEmpleados(); ++i) {
+		acumularTramo(nomina.sueldos.data() + nomina.inicio[i], acumulados.data() + nomina.inicio[i], nomina.mesesDe(i), 0);
+	}
+	return acumulados;
+}
+
+/**
+ * @brief Acumulados en paralelo (suma prefijo segmentada en tres pasos).
+ * 1) Cada hilo acumula su bloque del arreglo reiniciando en cada empleado que empieza ahí.
+ * 2) Se calcula en orden el arrastre de cada bloque: lo acumulado del empleado que viene
+ *    del bloque anterior (cero si en ese bloque empezó otro empleado).
+ * 3) Cada hilo suma su arrastre a los meses anteriores al primer empleado que empieza en su bloque.
+ * Funciona igual con muchos empleados cortos que con un solo empleado de muchos años.
+ */
+vector<Centavos> acumularNominaParalelo(const NominaEmpleados& nomina, size_t numHilos) {
+	MEDIR_OPERACION(CalcularNomina);
+	const size_t n = nomina.sueldos.size();
+	numHilos = max<size_t>(1, min(numHilos, n / 4096));
+	if (numHilos == 1) return acumularNomina(nomina);
+
+	vector<Centavos> acumulados(n);
+	vector<size_t> limites(numHilos + 1);
+	for (size_t b = 0; b <= numHilos; ++b) limites[b] = n * b / numHilos;
+	vector<Centavos> cola(numHilos);      // Acumulado al final del bloque (desde el último inicio visible)
+	vector<size_t> primerInicio(numHilos); // Posición del primer empleado que empieza dentro del bloque
+	vector<Centavos> arrastre(numHilos, 0);
+
+	auto enParalelo = [numHilos](auto tarea) {
+		vector<thread> hilos;
+		for (size_t b = 1; b < numHilos; ++b) hilos.emplace_back(tarea, b);
+		tarea(0);
+		for (auto& h : hilos) h.join();
+	};
+
+	enParalelo([&](size_t b) {
+		size_t desde = limites[b], hasta = limites[b + 1];
+		// Primer empleado cuyo inicio cae en [desde, hasta)
+		auto it = lower_bound(nomina.inicio.begin(), nomina.inicio.end() - 1, desde);
+		primerInicio[b] = (it != nomina.inicio.end() - 1 && *it < hasta) ? *it : hasta;
+		Centavos suma = 0;
+		size_t k = desde;
+		while (k < hasta) {
+			size_t finTramo = (it != nomina.inicio.end() - 1 && *it < hasta) ? *it : hasta;
+			if (finTramo == k) { suma = 0; ++it; continue; } // Empieza un empleado: se reinicia
+			suma = acumularTramo(nomina.sueldos.data() + k, acumulados.data() + k, finTramo - k, suma);
+			k = finTramo;
+		}
+		cola[b] = suma;
+	});
+
+	for (size_t b = 1; b < numHilos; ++b) {
+		bool empiezaEnAnterior = primerInicio[b - 1] < limites[b];
+		arrastre[b] = empiezaEnAnterior ? cola[b - 1] : arrastre[b - 1] + cola[b - 1];
+	}
+
+	enParalelo([&](size_t b) {
+		if (arrastre[b] == 0) return;
+		for (size_t k = limites[b]; k < primerInicio[b]; ++k) acumulados[k] += arrastre[b];
+	});
+	return acumulados;
+}
+
+size_t hilosNomina() {
+	return max(1u, thread::hardware_concurrency());
+}
+
+// Resumen en pantalla: plantilla, meses, total pagado y los empleados con mayor acumulado
+void mostrarResumenNomina(const NominaEmpleados& nomina, const vector<Centavos>& acumulados) {
+	Centavos totalGeneral = 0;
+	vector<pair<Centavos, size_t>> finales;
+	finales.reserve(nomina.numEmpleados());
+	for (size_t i = 0; i < nomina.numEmpleados(); ++i) {
+		Centavos final = nomina.mesesDe(i) ? acumulados[nomina.inicio[i + 1] - 1] : 0;
+		totalGeneral += final;
+		finales.emplace_back(final, i);
+	}
+	size_t top = min<size_t>(10, finales.size());
+	partial_sort(finales.begin(), finales.begin() + top, finales.end(), greater<>());
+
+	cout << "\n======= NOMINA: " << nomina.numEmpleados() << " empleados, " << nomina.sueldos.size() << " meses-sueldo =======\n";
+	cout << "Total acumulado de la plantilla: $" << Monto{ totalGeneral } << "\n";
+	cout << "Mayores acumulados:\n";
+	for (size_t k = 0; k < top; ++k) {
+		size_t i = finales[k].second;
+		cout << "  " << left << setw(25) << nomina.empleados[i] << right << setw(6) << nomina.mesesDe(i) << " meses  $"
+			<< setw(16) << Monto{ finales[k].first } << "\n";
+	}
+}
+
+// Mes a mes de un empleado (mismo formato que el modo recursivo)
+void mostrarAcumuladoEmpleado(const NominaEmpleados& nomina, const vector<Centavos>& acumulados, const string& empleado) {
+	auto it = find(nomina.empleados.begin(), nomina.empleados.end(), empleado);
+	if (it == nomina.empleados.end()) {
+		cout << "[NO ENCONTRADO] No hay sueldos registrados para '" << empleado << "'.\n";
+		return;
+	}
+	size_t i = static_cast<size_t>(it - nomina.empleados.begin());
+	for (size_t mes = 0; mes < nomina.mesesDe(i); ++mes) {
+		size_t k = nomina.inicio[i] + mes;
+		cout << "[Mes: " << NOMBRES_MESES[mes % 12] << " (Mes " << (mes + 1) << ")] Sueldo: $" << setw(10) << Monto{ nomina.sueldos[k] }
+			<< " | Acumulado: $" << setw(12) << Monto{ acumulados[k] } << endl;
+	}
+}
+
+// Acumulados a CSV: Empleado,Acum_1,...,Acum_N,Total (el encabezado usa la serie más larga)
+// @return false si el archivo no se pudo abrir o escribir completo
+bool guardarAcumuladosNomina(const NominaEmpleados& nomina, const vector<Centavos>& acumulados, const string& ruta) {
+	ofstream archivo(ruta, ios::out | ios::binary);
+	if (!archivo.is_open()) {
+		cout << "!!! ERROR: No se pudo abrir '" << ruta << "' para guardar los acumulados.\n";
+		return false;
+	}
+	size_t maxMeses = 0;
+	for (size_t i = 0; i < nomina.numEmpleados(); ++i) maxMeses = max(maxMeses, nomina.mesesDe(i));
+	archivo << "Empleado";
+	for (size_t m = 1; m <= maxMeses; ++m) archivo << ",Acum_" << m;
+	archivo << ",Total\n";
+
+	string fila;
+	char buffer[24];
+	for (size_t i = 0; i < nomina.numEmpleados(); ++i) {
+		fila.clear();
+		agregarCampoCSV(fila, nomina.empleados[i]);
+		for (size_t k = nomina.inicio[i]; k < nomina.inicio[i + 1]; ++k) {
+			fila += ',';
+			fila.append(buffer, formatearCentavos(buffer, acumulados[k]));
+		}
+		fila += ',';
+		fila.append(buffer, formatearCentavos(buffer, nomina.mesesDe(i) ? acumulados[nomina.inicio[i + 1] - 1] : 0));
+		fila += '\n';
+		archivo.write(fila.data(), static_cast<streamsize>(fila.size()));
+	}
+	CONTAR_METRICA(BytesEscritos, archivo.tellp());
+	archivo.close();
+	if (!archivo) {
+		cout << "!!! ERROR: No se pudo escribir '" << ruta << "' completo; los acumulados guardados estan incompletos.\n";
+		return false;
+	}
+	cout << "[CSV ACTUALIZADO] Acumulados de " << nomina.numEmpleados() << " empleados guardados en '" << ruta << "'.\n";
+	return true;
+}
+
+void menuNomina() {
+	NominaEmpleados nomina;
+	vector<Centavos> acumulados;
+	int opcion = 0;
+	while (opcion != 5) {
+		cout << "\n======= CALCULO DE SUELDO ACUMULADO =======" << endl;
+		cout << "1. Calculo de un empleado (Recursividad, hasta 12 meses)" << endl;
+		cout << "2. Cargar nomina desde archivo y calcular acumulados" << endl;
+		cout << "3. Consultar acumulado de un empleado" << endl;
+		cout << "4. Guardar acumulados en '" << NOMBRE_ARCHIVO_ACUMULADOS << "'" << endl;
+		cout << "5. Regresar al menu principal" << endl;
+		opcion = pedirEntero("Seleccione una opcion: ");
+
+		switch (opcion) {
+		case 1:
+			menuCalculoSueldoRecursivo();
+			pausaYLimpiar();
+			break;
+		case 2: {
+			string ruta = pedirTexto("Archivo de sueldos (ENTER = " + NOMBRE_ARCHIVO_SUELDOS + "): ");
+			if (ruta.empty()) ruta = NOMBRE_ARCHIVO_SUELDOS;
+			nomina = cargarNomina(ruta);
+			if (nomina.numEmpleados() == 0) {
+				cout << "[ADVERTENCIA] No se encontraron sueldos en '" << ruta << "'.\n";
+				acumulados.clear();
+			}
+			else {
+				acumulados = acumularNominaParalelo(nomina, hilosNomina());
+				mostrarResumenNomina(nomina, acumulados);
+			}
+			limpiarPantalla();
+			break;
+		}
+		case 3:
+		case 4:
+			if (nomina.numEmpleados() == 0) {
+				cout << "[ADVERTENCIA] Primero cargue la nomina (opcion 2).\n";
+			}
+			else if (opcion == 3) {
+				mostrarAcumuladoEmpleado(nomina, acumulados, pedirTexto("Nombre del empleado: "));
+			}
+			else {
+				guardarAcumuladosNomina(nomina, acumulados, NOMBRE_ARCHIVO_ACUMULADOS);
+			}
+			limpiarPantalla();
+			break;
+		case 5:
+			break;
+		default:
+			cout << "Opcion invalida. Intente de nuevo." << endl;
+		}
+	}
+}
+
+// Modo de linea de comandos: Proyecto7.0 --nomina [archivo] [--salida <csv>] [--hilos <n>]
+int ejecutarNomina(int argc, char* argv[]) {
+	string ruta = NOMBRE_ARCHIVO_SUELDOS, salida = NOMBRE_ARCHIVO_ACUMULADOS;
+	size_t hilos = hilosNomina();
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--salida" && tieneValor) salida = argv[++i];
+		else if (arg == "--hilos" && tieneValor) hilos = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (arg.rfind("--", 0) != 0) ruta = arg;
+		else {
+			cout << "Uso: Proyecto7.0 --nomina [archivo] [--salida <csv>] [--hilos <n>]\n";
+			return 1;
+		}
+	}
+	NominaEmpleados nomina = cargarNomina(ruta);
+	if (nomina.numEmpleados() == 0) {
+		cout << "!!! ERROR: No se encontraron sueldos en '" << ruta << "'.\n";
+		return 1;
+	}
+	vector<Centavos> acumulados = acumularNominaParalelo(nomina, hilos);
+	mostrarResumenNomina(nomina, acumulados);
+	if (!guardarAcumuladosNomina(nomina, acumulados, salida)) return 1;
+	return nomina.rechazadas ? 2 : 0;
+}
+
+
+// ======================= SUBMENU 6: METODOS DE ORDENAMIENTO Y LISTAS =======================
+
+// ======================= ESQUEMA DE REGISTROS (CASE 6) =======================
+// Cada tipo de registro describe en tiempo de compilación sus columnas de texto, sus
+// campos clave y su serie numérica. Con esa descripción se generan, para cada tabla,
+// el parseo, la serialización, la búsqueda, la comparación y la impresión (sin
+// cadenas de if/else por tipo en tiempo de ejecución).
+
+template<typename T>
+struct CampoTexto {
+	const char* columna;      // Encabezado en el CSV (también se usa en los mensajes)
+	const char* etiqueta;     // Encabezado en las tablas de pantalla
+	const char* descripcion;  // Para los mensajes: "numero de CAMION", "nombre del CHOFER", ...
+	int ancho;                // Ancho de la columna en pantalla
+	string T::* miembro;
+	bool opcional = false;    // Columna agregada después: los CSV anteriores no la traen
+};
+
+template<typename T>
+struct EsquemaRegistro; // Se especializa para cada tipo de registro
+
+// 1. Método Burbuja (ingresos_camiones.csv)
+template<>
+struct EsquemaRegistro<IngresoRecord> {
+	static constexpr const char* nombre = "INGRESO";
+	static constexpr const char* tituloTabla = "INGRESOS";
+	static inline const string& archivo = NOMBRE_ARCHIVO_INGRESOS;
+	static constexpr OperacionMetrica opCargar = OperacionMetrica::CargarIngresos;
+	static constexpr OperacionMetrica opGuardar = OperacionMetrica::GuardarIngresos;
+
+	static constexpr CampoTexto<IngresoRecord> camposTexto[] = {
+		{ "Camion", "CAMION", "numero de CAMION", 10, &IngresoRecord::camion },
+		{ "Chofer", "CHOFER", "nombre del CHOFER", 15, &IngresoRecord::chofer },
+		{ "Semana", "SEMANA", "SEMANA (AAAA-Www, vacio si no aplica)", 9, &IngresoRecord::semana, true },
+	};
+	static constexpr array<size_t, 2> claves = { 0, 1 };          // Camion + Chofer
+	static constexpr array<size_t, 1> camposEditables = { 2 };    // Texto no clave que se puede actualizar
+	static constexpr array<size_t, 2> camposOrden = { 0, 1 };     // Opciones 1 y 2 del ordenamiento
+
+	using Valor = Centavos;                                       // Montos exactos
+	static constexpr vector<Valor> IngresoRecord::* serie = &IngresoRecord::ingresos;
+	static constexpr size_t longitudFija = 7;                     // Siempre Días 1-7
+	static constexpr const char* columnaSerie = "Dia_";
+	static constexpr const char* etiquetaSerie = "Dia ";
+	static constexpr const char* etiquetaValor = "ingreso";
+	static constexpr const char* etiquetaTotal = "Total Ingresos";
+};
+
+// 2. Método Selección (taller_camiones.csv)
+template<>
+struct EsquemaRegistro<TallerRecord> {
+	static constexpr const char* nombre = "TALLER";
+	static constexpr const char* tituloTabla = "COSTOS DE TALLER";
+	static inline const string& archivo = NOMBRE_ARCHIVO_TALLER;
+	static constexpr OperacionMetrica opCargar = OperacionMetrica::CargarTaller;
+	static constexpr OperacionMetrica opGuardar = OperacionMetrica::GuardarTaller;
+
+	static constexpr CampoTexto<TallerRecord> camposTexto[] = {
+		{ "Camion", "CAMION", "numero de CAMION", 10, &TallerRecord::camion },
+		{ "Encargado", "ENCARGADO", "nombre del ENCARGADO", 15, &TallerRecord::encargado },
+		{ "Taller", "TALLER", "nombre del TALLER", 15, &TallerRecord::taller },
+	};
+	static constexpr array<size_t, 2> claves = { 0, 2 };          // Camion + Taller
+	static constexpr array<size_t, 1> camposEditables = { 1 };    // Encargado
+	static constexpr array<size_t, 2> camposOrden = { 0, 2 };
+
+	using Valor = Centavos;
+	static constexpr vector<Valor> TallerRecord::* serie = &TallerRecord::costos;
+	static constexpr size_t longitudFija = 0;                     // Visitas variables
+	static constexpr const char* columnaSerie = "Costo_";
+	static constexpr const char* etiquetaSerie = "Costo ";
+	static constexpr const char* etiquetaValor = "costo para Visita";
+	static constexpr const char* etiquetaTotal = "Total Costos";
+};
+
+// 3. Método Inserción (kilometraje_camiones.csv)
+template<>
+struct EsquemaRegistro<KilometrajeRecord> {
+	static constexpr const char* nombre = "KILOMETRAJE";
+	static constexpr const char* tituloTabla = "KILOMETRAJE";
+	static inline const string& archivo = NOMBRE_ARCHIVO_KM;
+	static constexpr OperacionMetrica opCargar = OperacionMetrica::CargarKm;
+	static constexpr OperacionMetrica opGuardar = OperacionMetrica::GuardarKm;
+
+	static constexpr CampoTexto<KilometrajeRecord> camposTexto[] = {
+		{ "Camion", "CAMION", "numero de CAMION", 10, &KilometrajeRecord::camion },
+		{ "Chofer", "CHOFER", "nombre del CHOFER", 15, &KilometrajeRecord::chofer },
+	};
+	static constexpr array<size_t, 2> claves = { 0, 1 };
+	static constexpr array<size_t, 0> camposEditables = {};
+	static constexpr array<size_t, 2> camposOrden = { 0, 1 };
+
+	using Valor = double;                                         // Distancias
+	static constexpr vector<Valor> KilometrajeRecord::* serie = &KilometrajeRecord::km;
+	static constexpr size_t longitudFija = 0;                     // Días variables
+	static constexpr const char* columnaSerie = "Km_Dia_";
+	static constexpr const char* etiquetaSerie = "Dia ";
+	static constexpr const char* etiquetaValor = "KM para Dia";
+	static constexpr const char* etiquetaTotal = "Total KM";
+};
+
+// Operaciones sobre los valores de una serie según su tipo (E::Valor):
+// centavos exactos para dinero, double para distancias.
+inline Centavos sumaSerie(const vector<Centavos>& serie) { return sumaMontos(serie); }
+inline double sumaSerie(const vector<double>& serie) { return sumaValores(serie); }
+
+inline bool convertirValor(string_view texto, Centavos& valor) { return convertirCentavos(texto, valor); }
+inline bool convertirValor(string_view texto, double& valor) { return convertirDouble(texto, valor); }
+
+inline void pedirValor(string_view mensaje, Centavos& valor) { valor = pedirMonto(mensaje); }
+inline void pedirValor(string_view mensaje, double& valor) { valor = pedirDouble(mensaje); }
+
+// Para imprimir con '<<': los double usan el 'fixed << setprecision(2)' del flujo
+inline Monto valorImprimible(Centavos valor) { return Monto{ valor }; }
+inline double valorImprimible(double valor) { return valor; }
+
+inline string textoValor(Centavos valor) { return textoCentavos(valor); }
+inline string textoValor(double valor) { return to_string(valor); }
+
+// ======================= CRUD COMÚN (CARGAR/GUARDAR/ELIMINAR) =======================
+
+// ---------- Órdenes mantenidos de la lista (opción 6 del menú de listas) ----------
+// Por cada campo de ordenamiento (los dos de texto y el Total) se guarda la permutación
+// ascendente de las posiciones de la carga completa (bloques y luego CSV). Se arma con un
+// sort la primera vez que se pide; las altas del CRUD se juntan en una corrida de pendientes
+// que en la siguiente consulta se ordena (es chica) y se mezcla linealmente con cada
+// permutación ya armada. Una reescritura de la tabla (baja o actualización) o un cambio por
+// fuera (otro proceso, --comprimir) la invalidan, igual que a los rollups.
+
+const size_t CAMPOS_ORDEN_LISTA = 3; // camposOrden[0], camposOrden[1] y Total
+
+template<typename T>
+class OrdenesTabla {
+	array<vector<uint32_t>, CAMPOS_ORDEN_LISTA> permutaciones;
+	array<bool, CAMPOS_ORDEN_LISTA> armadas{};
+	vector<uint32_t> pendientes;   // Altas desde la última consulta (al final de la carga)
+	uint64_t filas = 0;
+	uint64_t huellaCSV = 0, huellaBloques = 0;
+	bool vigente = false;
+
+	static uint64_t tamanoCSV() { return tamanoArchivo(EsquemaRegistro<T>::archivo); }
+	static uint64_t tamanoBloques() { return tamanoArchivo(rutaBloques(EsquemaRegistro<T>::archivo)); }
+	bool huellaCoincide() const { return huellaCSV == tamanoCSV() && huellaBloques == tamanoBloques(); }
+
+	void invalidar() {
+		vigente = false;
+		armadas.fill(false);
+		pendientes.clear();
+		for (auto& p : permutaciones) p.clear();
+	}
+
+	// Llama a f(comparador) con el orden estricto (campo, posición): el resultado no depende del algoritmo
+	template<typename Funcion>
+	static void conComparador(const vector<T>& registros, size_t campo, Funcion f) {
+		using E = EsquemaRegistro<T>;
+		if (campo == CAMPOS_ORDEN_LISTA - 1) {
+			f([&registros](uint32_t a, uint32_t b) {
+				return registros[a].total < registros[b].total || (registros[a].total == registros[b].total && a < b);
+			});
+			return;
+		}
+		const string T::* miembro = E::camposTexto[E::camposOrden[campo]].miembro;
+		f([&registros, miembro](uint32_t a, uint32_t b) {
+			int c = (registros[a].*miembro).compare(registros[b].*miembro);
+			return c < 0 || (c == 0 && a < b);
+		});
+	}
+
+public:
+	// Cómo se obtuvo el último orden (para el mensaje del menú y el benchmark)
+	bool ultimoCompleto = false;
+	size_t ultimasMezcladas = 0;
+
+	// Antes de escribir (como RollupIngresos::cambio): si el archivo cambió por fuera se descarta
+	void antesDeGuardar() {
+		if (vigente && !huellaCoincide()) invalidar();
+	}
+
+	// Después de escribir: 'agregado' es la fila nueva al final, o nullptr si se reescribió la tabla
+	void guardada(const T* agregado) {
+		if (!vigente) return;
+		if (!agregado) { invalidar(); return; }
+		pendientes.push_back(static_cast<uint32_t>(filas++));
+		huellaCSV = tamanoCSV();
+		huellaBloques = tamanoBloques();
+	}
+
+	/**
+	 * @brief Posiciones de 'registros' (la carga completa, en orden de archivo) en orden
+	 * ascendente por 'campo' (0 y 1: camposOrden; 2: Total).
+	 */
+	const vector<uint32_t>& orden(const vector<T>& registros, size_t campo) {
+		if (!vigente || filas != registros.size() || !huellaCoincide()) {
+			invalidar();
+			filas = registros.size();
+			huellaCSV = tamanoCSV();
+			huellaBloques = tamanoBloques();
+			vigente = true;
+		}
+		ultimoCompleto = !armadas[campo];
+		ultimasMezcladas = armadas[campo] ? pendientes.size() : 0;
+		if (!pendientes.empty()) {
+			for (size_t c = 0; c < CAMPOS_ORDEN_LISTA; ++c) {
+				if (!armadas[c]) continue;
+				vector<uint32_t>& p = permutaciones[c];
+				size_t antes = p.size();
+				p.insert(p.end(), pendientes.begin(), pendientes.end());
+				conComparador(registros, c, [&](auto menor) {
+					sort(p.begin() + antes, p.end(), menor);
+					inplace_merge(p.begin(), p.begin() + antes, p.end(), menor);
+				});
+			}
+			pendientes.clear();
+		}
+		vector<uint32_t>& p = permutaciones[campo];
+		if (!armadas[campo]) {
+			p.resize(registros.size());
+			iota(p.begin(), p.end(), 0u);
+			conComparador(registros, campo, [&](auto menor) { sort(p.begin(), p.end(), menor); });
+			armadas[campo] = true;
+		}
+		return p;
+	}
+};
+
+template<typename T>
+inline OrdenesTabla<T> ordenesTabla;
+
+// Avisos de cambios para los acumulados derivados (los ingresos además tienen rollups: sobrecargas arriba)
+template<typename T> void registroAgregado(const T&) { ordenesTabla<T>.antesDeGuardar(); }
+template<typename T> void registroRetirado(const T&) {}
+template<typename T> void tablaGuardada(const T* agregado) { ordenesTabla<T>.guardada(agregado); }
+// Los cambios ya avisados no llegaron al archivo: los acumulados que los aplicaron se descartan
+template<typename T> void tablaNoGuardada(const T*) {}
+
+// Fila que no se pudo cargar: línea física del archivo, motivo y el texto original
+struct FilaRechazada {
+	uint64_t linea;
+	string motivo;
+	string contenido;
+	bool ilegible = false;        // Bloque dañado o ilegible: sus filas no están en 'contenido'
+};
+
+// Últimas filas rechazadas al cargar cada tabla (las muestran el menú de listas y --validar)
+template<typename T>
+inline vector<FilaRechazada> rechazosCSV;
+
+/**
+ * @brief Posición de cada columna de texto según el encabezado del CSV.
+ * Las columnas se buscan por nombre, en cualquier orden. Si falta alguna obligatoria (archivo
+ * sin encabezado o con nombres distintos) se usan las posiciones de siempre; una opcional
+ * ausente queda vacía (así se siguen leyendo los CSV guardados antes de agregarla).
+ * La serie numérica empieza después de la última columna de texto y el Total es el último valor.
+ */
+template<typename T>
+struct MapaColumnas {
+	array<int, size(EsquemaRegistro<T>::camposTexto)> indice{};
+	size_t inicioSerie = 0;
+	bool conTotal = false;        // El encabezado tiene la columna Total
+
+	// Todas las columnas presentes y en el orden en que se escriben
+	bool canonico() const {
+		for (size_t i = 0; i < indice.size(); ++i) if (indice[i] != static_cast<int>(i)) return false;
+		return true;
+	}
+};
+
+template<typename T>
+MapaColumnas<T> mapearColumnas(const vector<string_view>& encabezado) {
+	using E = EsquemaRegistro<T>;
+	MapaColumnas<T> mapa;
+	bool porNombre = true;
+	for (size_t i = 0; i < mapa.indice.size(); ++i) {
+		auto it = find(encabezado.begin(), encabezado.end(), string_view(E::camposTexto[i].columna));
+		mapa.indice[i] = it == encabezado.end() ? -1 : static_cast<int>(it - encabezado.begin());
+		if (mapa.indice[i] < 0 && !E::camposTexto[i].opcional) porNombre = false;
+	}
+	if (!porNombre) {
+		int posicion = 0;
+		for (size_t i = 0; i < mapa.indice.size(); ++i) {
+			if (!E::camposTexto[i].opcional) mapa.indice[i] = posicion++;
+			else if (mapa.indice[i] >= 0) mapa.indice[i] = posicion++;
+		}
+	}
+	for (int indice : mapa.indice) mapa.inicioSerie = max(mapa.inicioSerie, static_cast<size_t>(indice + 1));
+	mapa.conTotal = find(encabezado.begin(), encabezado.end(), string_view("Total")) != encabezado.end();
+	return mapa;
+}
+
+// Encabezado de un CSV existente (vacío si no existe)
+template<typename T>
+MapaColumnas<T> mapaDeArchivo(const string& ruta) {
+	CandadoArchivo candado = abrirLectura(ruta);
+	LectorCSV lector(ruta);
+	const char* error = nullptr;
+	vector<string_view> vacio;
+	return mapearColumnas<T>(lector.siguiente(error) ? lector.campos() : vacio);
+}
+
+/**
+ * @brief Qué convertir de cada fila (proyección) y qué filas conservar (predicado).
+ * El predicado de texto se evalúa sobre los campos crudos antes de convertir nada, y sin
+ * 'conSerie' solo se convierte el Total: una búsqueda por camion o por total no paga el
+ * parseo de los valores diarios. Lo que no se convierte tampoco se valida.
+ */
+template<typename T>
+struct FiltroRegistros {
+	using Valor = typename EsquemaRegistro<T>::Valor;
+
+	bool conSerie = true;        // false: la serie queda vacía (texto y Total sí se llenan)
+	int campo = -1;              // camposTexto[campo] == valor (-1: sin filtro de texto)
+	bool cualquierCampo = false; // true: basta con que algún campo de texto sea igual a 'valor'
+	string valor;
+	bool conMinimo = false, conMaximo = false;
+	Valor totalMinimo{}, totalMaximo{};
+	const atomic<bool>* detener = nullptr; // Si se activa, el recorrido se corta (precarga interrumpida)
+
+	bool filtraTexto() const { return campo >= 0 || cualquierCampo; }
+	bool aceptaTotal(Valor total) const {
+		return (!conMinimo || total >= totalMinimo) && (!conMaximo || total <= totalMaximo);
+	}
+};
+
+template<typename T>
+bool coincideTextoCrudo(const MapaColumnas<T>& mapa, const string_view* campos, const FiltroRegistros<T>& filtro) {
+	auto valorDe = [&](size_t i) { return mapa.indice[i] >= 0 ? campos[mapa.indice[i]] : string_view(); };
+	if (filtro.campo >= 0) return valorDe(static_cast<size_t>(filtro.campo)) == filtro.valor;
+	for (size_t i = 0; i < mapa.indice.size(); ++i) if (valorDe(i) == filtro.valor) return true;
+	return false;
+}
+
+/**
+ * @brief Recorre la tabla fila por fila sin guardarla en memoria (bloques comprimidos y CSV).
+ * Los campos de texto van primero (ubicados por el encabezado); después la serie numérica
+ * y al final el Total. Si el encabezado no tiene Total se calcula con la suma de la serie;
+ * si lo tiene, una serie fija (los 7 días de ingresos) debe traer todos sus valores y el
+ * Total. Una coma al final de la fila se ignora.
+ * Las filas con comillas sin cerrar, columnas faltantes o valores no numéricos no se
+ * procesan: se agregan a 'rechazos' (si no es nullptr) con su número de línea (o su bloque).
+ * 'procesar(registro, bytesFila)' recibe cada fila ya convertida que pasa el 'filtro'; el mismo
+ * registro se reutiliza en la siguiente fila (se puede mover si se quiere conservar).
+ * En 'firma' (si no es nullptr) queda la del CSV leído (ver recorrerFilas).
+ * @return Número de filas procesadas.
+ */
+template<typename T, typename Funcion>
+uint64_t recorrerCSV(const string& ruta, Funcion procesar, vector<FilaRechazada>* rechazos = nullptr,
+	const FiltroRegistros<T>& filtro = FiltroRegistros<T>{}, FirmaArchivo* firma = nullptr) {
+	using E = EsquemaRegistro<T>;
+	MapaColumnas<T> mapa;
+	uint64_t filas = 0, rechazadas = 0;
+	string motivo;
+	T record{};
+	auto rechazar = [&](const FilaCSV& fila, string_view porque) {
+		++rechazadas;
+		if (!rechazos) return;
+		string detalle(porque);
+		if (fila.linea == 0) detalle.insert(0, fila.bloque == TODOS_LOS_BLOQUES ? string("[bloques] ") : "[bloque " + to_string(fila.bloque) + "] ");
+		rechazos->push_back(FilaRechazada{ fila.linea, move(detalle), textoFila(fila), fila.ilegible });
+	};
+
+	uint64_t bytes = recorrerFilas(ruta, [&mapa](const vector<string_view>& encabezado) { mapa = mapearColumnas<T>(encabezado); },
+		[&](const FilaCSV& fila) {
+		if (fila.error) { rechazar(fila, fila.error); return; }
+		const string_view* campos = fila.campos;
+		size_t n = fila.numCampos;
+		if (n > mapa.inicioSerie && campos[n - 1].empty()) --n; // Coma final
+		if (n < mapa.inicioSerie) {
+			rechazar(fila, "faltan columnas: tiene " + to_string(n) + ", se esperaban al menos " + to_string(mapa.inicioSerie));
+			return;
+		}
+		if (filtro.filtraTexto() && !coincideTextoCrudo(mapa, campos, filtro)) return;
+
+		// El último valor es el Total (las series fijas solo lo tienen si sobra un valor). Una
+		// serie fija con otro número de valores está incompleta: su Total se leería como un día.
+		// Si el encabezado trae Total, la fila también lo debe traer
+		size_t valores = n - mapa.inicioSerie;
+		if (E::longitudFija != 0 && valores != E::longitudFija + 1 && (mapa.conTotal || valores != E::longitudFija)) {
+			rechazar(fila, "se esperaban " + to_string(E::longitudFija) + " valores (y el Total), la fila tiene " + to_string(valores));
+			return;
+		}
+		bool hayTotal = valores > 0 && (E::longitudFija == 0 || valores > E::longitudFija);
+		auto invalido = [&](size_t k) {
+			motivo = "valor no numerico '" + string(campos[k].substr(0, 20)) + "' en la columna " + to_string(k + 1);
+			rechazar(fila, motivo);
+		};
+		auto& serie = record.*E::serie;
+		serie.clear();
+		if (filtro.conSerie || !hayTotal) {
+			serie.reserve(valores);
+			for (size_t k = mapa.inicioSerie; k < n; ++k) {
+				typename E::Valor valor{};
+				if (!convertirValor(campos[k], valor)) { invalido(k); return; }
+				serie.push_back(valor);
+			}
+			if (hayTotal) {
+				record.total = serie.back();
+				serie.pop_back();
+			}
+			else {
+				record.total = sumaSerie(serie);
+			}
+		}
+		else if (!convertirValor(campos[n - 1], record.total)) {
+			invalido(n - 1);
+			return;
+		}
+		if (!filtro.aceptaTotal(record.total)) return;
+
+		for (size_t i = 0; i < mapa.indice.size(); ++i) {
+			const auto& campo = E::camposTexto[i];
+			if (mapa.indice[i] >= 0) (record.*campo.miembro).assign(campos[mapa.indice[i]]);
+			else (record.*campo.miembro).clear();
+		}
+		size_t bytesFila = n;
+		for (size_t k = 0; k < n; ++k) bytesFila += campos[k].size();
+		procesar(record, bytesFila);
+		++filas;
+	}, [&mapa, &filtro](const EntradaIndiceBloque& e) {
+		// Búsqueda por igualdad: el rango de la primera columna y el filtro de Bloom dicen qué
+		// bloques no pueden tener el valor
+		if (filtro.campo >= 0) {
+			int columna = mapa.indice[filtro.campo];
+			if (columna < 0) return true;
+			if (columna == 0 && (filtro.valor < e.minimo || e.maximo < filtro.valor)) return false;
+			return e.filtro.puedeContener(static_cast<size_t>(columna), filtro.valor);
+		}
+		if (!filtro.cualquierCampo) return true;
+		for (int columna : mapa.indice) {
+			if (columna >= 0 && e.filtro.puedeContener(static_cast<size_t>(columna), filtro.valor)) return true;
+		}
+		return false;
+	}, firma, filtro.detener);
+	CONTAR_METRICA(FilasLeidas, filas);
+	CONTAR_METRICA(ErroresParseo, rechazadas);
+	CONTAR_METRICA(BytesLeidos, bytes);
+	return filas;
+}
+
+// Carga los registros de la tabla (todos, o solo los que pasan el filtro y con lo que pide)
+template<typename T>
+vector<T> cargarCSV(const FiltroRegistros<T>& filtro = FiltroRegistros<T>{}) {
+	using E = EsquemaRegistro<T>;
+	MEDIR_OPERACION_VALOR(E::opCargar);
+	MEDIR_ASIGNACIONES(AsignacionesCarga);
+	vector<T> registros;
+	const bool completo = !filtro.filtraTexto() && !filtro.conMinimo && !filtro.conMaximo && filtro.conSerie;
+	// Solo una carga completa sirve después para sobrescribir la tabla (ver respaldarRechazos);
+	// su firma deja al escritor detectar si otro proceso cambia el CSV antes del reemplazo
+	if (completo) rechazosCSV<T>.clear();
+	FirmaArchivo firma;
+	recorrerCSV<T>(E::archivo, [&registros, completo](T& record, size_t bytesFila) {
+		// Con la primera fila se estima cuántas hay a partir del tamaño del archivo
+		if (completo && registros.empty()) registros.reserve(tamanoArchivo(E::archivo) / bytesFila + 1);
+		registros.push_back(move(record));
+	}, completo ? &rechazosCSV<T> : nullptr, filtro, completo ? &firma : nullptr);
+	if (completo) escritorArchivos.anotarFirma(E::archivo, firma);
+	return registros;
+}
+
+// Número de registros sin convertir las series (solo se valida el Total)
+template<typename T>
+uint64_t contarRegistros() {
+	FiltroRegistros<T> soloTotal;
+	soloTotal.conSerie = false;
+	return recorrerCSV<T>(EsquemaRegistro<T>::archivo, [](const T&, size_t) {}, nullptr, soloTotal);
+}
+
+// Encabezado del CSV; las series variables se dimensionan con 'longitudSerie' columnas
+template<typename T>
+void escribirEncabezadoCSV(ostream& archivo, size_t longitudSerie) {
+	using E = EsquemaRegistro<T>;
+	bool primero = true;
+	for (const auto& campo : E::camposTexto) {
+		archivo << (primero ? "" : ",") << campo.columna;
+		primero = false;
+	}
+	for (size_t i = 1; i <= longitudSerie; ++i) archivo << "," << E::columnaSerie << i;
+	archivo << ",Total\n";
+}
+
+// Una fila del CSV (el flujo ya debe tener 'fixed << setprecision(2)' para las series double)
+template<typename T>
+void escribirRegistroCSV(ostream& archivo, const T& record) {
+	using E = EsquemaRegistro<T>;
+	bool primero = true;
+	for (const auto& campo : E::camposTexto) {
+		if (!primero) archivo << ',';
+		escribirCampoCSV(archivo, record.*campo.miembro);
+		primero = false;
+	}
+	for (auto val : record.*E::serie) archivo << "," << valorImprimible(val);
+	archivo << "," << valorImprimible(record.total) << "\n";
+}
+
+/**
+ * @brief Las filas rechazadas en la última carga no están en 'registros'; antes de
+ * sobrescribir la tabla se agregan a '<archivo>.rechazados' para no perderlas.
+ */
+template<typename T>
+void respaldarRechazos() {
+	using E = EsquemaRegistro<T>;
+	vector<FilaRechazada>& rechazos = rechazosCSV<T>;
+	if (rechazos.empty()) return;
+	const string ruta = E::archivo + ".rechazados";
+	bool nuevo = tamanoArchivo(ruta) == 0;
+	ofstream archivo(ruta, ios::app);
+	if (!archivo.is_open()) {
+		cout << "!!! ERROR: No se pudo abrir '" << ruta << "' para respaldar las filas rechazadas.\n";
+		return;
+	}
+	if (nuevo) archivo << "Linea,Motivo,Contenido\n";
+	for (const auto& r : rechazos) {
+		archivo << r.linea << ',';
+		escribirCampoCSV(archivo, r.motivo);
+		archivo << ',';
+		escribirCampoCSV(archivo, r.contenido);
+		archivo << '\n';
+	}
+	cout << "[ADVERTENCIA] " << rechazos.size() << " filas con errores no se incluyen en la tabla; se respaldaron en '" << ruta << "'.\n";
+	rechazos.clear();
+}
+
+/**
+ * @brief Reemplaza la tabla con 'registros' (que deben venir de una carga completa).
+ * Si en esa carga hubo bloques dañados o el .bloq no se pudo abrir, sus filas no están en
+ * 'registros' ni se pueden respaldar: no se modifica nada (igual que --descomprimir).
+ * El .bloq se borra solo cuando sincronizar() confirma que el CSV nuevo quedó en el disco.
+ * @return false si no se sobrescribió o no se pudo confirmar la escritura.
+ */
+template<typename T>
+bool guardarCSV_Sobrescribir(const vector<T>& registros) {
+	using E = EsquemaRegistro<T>;
+	MEDIR_OPERACION_VALOR(E::opGuardar);
+	const string rutaBloq = rutaBloques(E::archivo);
+	const vector<FilaRechazada>& rechazos = rechazosCSV<T>;
+	if (any_of(rechazos.begin(), rechazos.end(), [](const FilaRechazada& r) { return r.ilegible; })) {
+		cout << "!!! ERROR: '" << rutaBloq << "' tiene bloques danados o no se pudo leer; sus filas no se cargaron y se perderian.\n"
+			<< "    No se modifico '" << E::archivo << "' (revise con --validar y restaure el .bloq de un respaldo).\n";
+		tablaNoGuardada(static_cast<const T*>(nullptr));
+		return false;
+	}
+	respaldarRechazos<T>();
+	// La tabla se arma en memoria y el escritor asíncrono la pasa al disco
+	ostringstream archivo;
+	// Encabezados dinámicos: el primer registro define las columnas (al menos una si está vacío)
+	size_t columnas = E::longitudFija;
+	if (columnas == 0) columnas = registros.empty() ? 1 : (registros[0].*E::serie).size();
+	escribirEncabezadoCSV<T>(archivo, columnas);
+
+	archivo << fixed << setprecision(2);
+	for (const auto& record : registros) escribirRegistroCSV(archivo, record);
+	escritorArchivos.reemplazar(E::archivo, archivo.str());
+	tablaGuardada(static_cast<const T*>(nullptr));
+	// Los registros incluían las filas de los bloques: se borran cuando ya quedaron en el CSV
+	if (!filesystem::exists(rutaBloq)) {
+		cout << "[CSV EN COLA] La tabla de registros se sobrescribira en '" << E::archivo << "' (en segundo plano).\n";
+		return true;
+	}
+	if (!escritorArchivos.sincronizar()) {
+		reportarFallosEscritura();
+		cout << "!!! ERROR: No se confirmo la escritura de '" << E::archivo << "'; se conserva '" << rutaBloq << "'.\n"
+			<< "    Revise la tabla con --validar antes de volver a guardar (sus filas podrian aparecer dos veces).\n";
+		tablaNoGuardada(static_cast<const T*>(nullptr));
+		return false;
+	}
+	cout << "[CSV ACTUALIZADO] La tabla de registros ha sido sobrescrita en '" << E::archivo << "'.\n";
+	CandadoArchivo candado(E::archivo, ModoCandado::Exclusivo);
+	error_code ec;
+	if (filesystem::remove(rutaBloq, ec)) {
+		cout << "[ADVERTENCIA] La tabla completa quedo en el CSV; '" << rutaBloq << "' se elimino (vuelva a compactar con --comprimir).\n";
+	}
+	return true;
+}
+
+// Encola un registro al final del CSV (escribe el encabezado si el archivo no existe o está vacío)
+// @return false si no se encoló
+template<typename T>
+bool guardarCSV_Append(const T& record) {
+	using E = EsquemaRegistro<T>;
+	MEDIR_OPERACION_VALOR(E::opGuardar);
+	const string& nombreArchivo = E::archivo;
+
+	// Un CSV anterior a una columna opcional (o con otro orden) se reescribe una vez con el encabezado actual
+	if (tamanoArchivo(nombreArchivo) > 0 && !mapaDeArchivo<T>(nombreArchivo).canonico()) {
+		cout << "[ADVERTENCIA] '" << nombreArchivo << "' tiene el formato anterior; se agregan las columnas nuevas.\n";
+		if (!guardarCSV_Sobrescribir(cargarCSV<T>())) {
+			cout << "!!! ERROR: El registro no se guardo (la fila no coincidiria con las columnas del archivo).\n";
+			return false;
+		}
+	}
+
+	// El encabezado solo se escribe si el archivo no existe o está vacío (lo decide el escritor)
+	ostringstream encabezado, fila;
+	escribirEncabezadoCSV<T>(encabezado, E::longitudFija ? E::longitudFija : (record.*E::serie).size());
+	fila << fixed << setprecision(2);
+	escribirRegistroCSV(fila, record);
+	registroAgregado(record);
+	escritorArchivos.agregar(nombreArchivo, fila.str(), encabezado.str());
+	tablaGuardada(&record);
+	return true;
+}
+
+// Con 'orden' se muestran en ese orden de posiciones (al revés si 'invertido')
+template<typename T>
+void mostrarRegistros(const vector<T>& registros, const vector<uint32_t>* orden = nullptr, bool invertido = false) {
+	using E = EsquemaRegistro<T>;
+	cout << "\n======= DATOS ACTUALES DE " << E::tituloTabla << " (" << registros.size() << " Registros) =======\n";
+	if (registros.empty()) { cout << "No hay registros guardados para mostrar." << endl; return; }
+
+	// Obtener el máximo de valores para los encabezados
+	size_t maxValores = E::longitudFija;
+	for (const auto& r : registros) {
+		if ((r.*E::serie).size() > maxValores) maxValores = (r.*E::serie).size();
+	}
+
+	cout << "----------------------------------------------------------------------------------------------------------------\n";
+	for (const auto& campo : E::camposTexto) cout << "| " << left << setw(campo.ancho) << campo.etiqueta;
+	for (size_t i = 0; i < maxValores; ++i) {
+		cout << "| " << right << setw(7) << (E::etiquetaSerie + to_string(i + 1));
+	}
+	cout << "| " << right << setw(10) << "TOTAL" << " |\n";
+	cout << "----------------------------------------------------------------------------------------------------------------\n";
+
+	cout << fixed << setprecision(2);
+	for (size_t i = 0; i < registros.size(); ++i) {
+		const T& record = !orden ? registros[i] : registros[(*orden)[invertido ? registros.size() - 1 - i : i]];
+		for (const auto& campo : E::camposTexto) cout << "| " << left << setw(campo.ancho) << record.*campo.miembro;
+
+		const auto& serie = record.*E::serie;
+		for (size_t i = 0; i < maxValores; ++i) {
+			if (i < serie.size()) {
+				cout << "| " << right << setw(7) << valorImprimible(serie[i]);
+			}
+			else {
+				cout << "| " << right << setw(7) << "-";
+			}
+		}
+		cout << "| " << right << setw(10) << valorImprimible(record.total) << " |" << endl;
+	}
+	cout << "----------------------------------------------------------------------------------------------------------------\n";
+}
+
+// Pide los campos clave del registro (ej. Camion y Chofer) con el verbo indicado
+template<typename T>
+array<string, EsquemaRegistro<T>::claves.size()> pedirClaves(const string& accion) {
+	using E = EsquemaRegistro<T>;
+	array<string, E::claves.size()> valores;
+	for (size_t i = 0; i < E::claves.size(); ++i) {
+		valores[i] = pedirTexto(string("Ingrese el ") + E::camposTexto[E::claves[i]].descripcion + " del registro a " + accion + ": ");
+	}
+	return valores;
+}
+
+template<typename T>
+bool coincideClaves(const T& r, const array<string, EsquemaRegistro<T>::claves.size()>& valores) {
+	using E = EsquemaRegistro<T>;
+	for (size_t i = 0; i < E::claves.size(); ++i) {
+		if (r.*E::camposTexto[E::claves[i]].miembro != valores[i]) return false;
+	}
+	return true;
+}
+
+template<typename T>
+string describirClaves(const array<string, EsquemaRegistro<T>::claves.size()>& valores) {
+	using E = EsquemaRegistro<T>;
+	string texto;
+	for (size_t i = 0; i < E::claves.size(); ++i) {
+		texto += (i ? " y " : "") + string(E::camposTexto[E::claves[i]].columna) + ": " + valores[i];
+	}
+	return texto;
+}
+
+template<typename T>
+void eliminarRegistro(vector<T>& registros) {
+	using E = EsquemaRegistro<T>;
+	cout << "\n======= ELIMINAR REGISTRO DE " << E::nombre << " =======\n";
+	auto claves = pedirClaves<T>("eliminar");
+	size_t tam_antes = registros.size();
+
+	registros.erase(
+		remove_if(registros.begin(), registros.end(),
+			[&claves](const T& r) {
+				if (!coincideClaves(r, claves)) return false;
+				registroRetirado(r);
+				return true;
+			}),
+		registros.end()
+	);
+	size_t tam_despues = registros.size();
+
+	if (tam_despues < tam_antes) {
+		if (guardarCSV_Sobrescribir(registros)) cout << "\n[ELIMINACION EXITOSA] Se eliminaron " << (tam_antes - tam_despues) << " registros.\n";
+	}
+	else {
+		cout << "\n[ADVERTENCIA] No se encontro ningun registro con " << describirClaves<T>(claves) << ".\n";
+	}
+}
+
+
+// ======================= OPERACIONES AVANZADAS DE LISTA =======================
+
+// --- Operaciones de Búsqueda ---
+template<typename T>
+void mostrarResumenRegistro(const T& r) {
+	using E = EsquemaRegistro<T>;
+	cout << " ";
+	bool primero = true;
+	for (const auto& campo : E::camposTexto) {
+		cout << (primero ? " " : ", ") << campo.columna << ": " << r.*campo.miembro;
+		primero = false;
+	}
+	cout << ", " << E::etiquetaTotal << ": " << fixed << setprecision(2) << valorImprimible(r.total) << endl;
+}
+
+// Busca directo en el archivo: solo se convierten las filas que coinciden y sin su serie diaria
+template<typename T>
+void buscarRegistro(uint64_t totalRegistros, const string& tipoRegistro) {
+	if (totalRegistros == 0) { cout << "La lista esta vacia. No se puede buscar." << endl; return; }
+
+	cout << "\n======= BUSQUEDA DE REGISTRO (" << tipoRegistro << ") =======\n";
+	FiltroRegistros<T> filtro;
+	filtro.valor = pedirTexto("Ingrese el valor de busqueda (Camion o Chofer/Encargado): ");
+	filtro.cualquierCampo = true;
+	filtro.conSerie = false;
+	const string& busqueda = filtro.valor;
+	MEDIR_OPERACION(BuscarRegistro);
+	int count = 0;
+
+	for (const auto& r : cargarCSV<T>(filtro)) {
+		cout << "\n[ENCONTRADO #" << (++count) << "]\n";
+		mostrarResumenRegistro(r);
+	}
+
+	if (count == 0) {
+		cout << "[NO ENCONTRADO] No se encontraron registros que coincidan con la busqueda: '" << busqueda << "'.\n";
+	}
+	else {
+		cout << "\n[RESUMEN] Se encontraron " << count << " registros coincidentes.\n";
+	}
+}
+
+// --- Operaciones de Actualización ---
+template<typename T>
+void actualizarRegistro(vector<T>& registros) {
+	using E = EsquemaRegistro<T>;
+	cout << "\n======= ACTUALIZAR REGISTRO DE " << E::nombre << " =======\n";
+	auto claves = pedirClaves<T>("actualizar");
+
+	auto it = find_if(registros.begin(), registros.end(),
+		[&claves](const T& r) {
+			return coincideClaves(r, claves);
+		});
+
+	if (it != registros.end()) {
+		cout << "[ENCONTRADO] Actualizando registro de " << describirClaves<T>(claves) << endl;
+		T& r = *it;
+		registroRetirado(r);
+
+		auto& serie = r.*E::serie;
+		for (size_t i = 0; i < serie.size(); ++i) {
+			pedirValor("  Nuevo " + string(E::etiquetaValor) + " " + to_string(i + 1) + " (Anterior: " + textoValor(serie[i]) + "): ", serie[i]);
+		}
+		for (size_t indice : E::camposEditables) {
+			const auto& campo = E::camposTexto[indice];
+			r.*campo.miembro = pedirTexto("  Nuevo " + string(campo.descripcion) + " (Anterior: " + r.*campo.miembro + "): ");
+		}
+
+		r.total = sumaSerie(serie);
+		registroAgregado(r);
+		if (guardarCSV_Sobrescribir(registros)) {
+			cout << "[ACTUALIZACION EXITOSA] Total recalculado: " << fixed << setprecision(2) << valorImprimible(r.total) << endl;
+		}
+	}
+	else {
+		cout << "[ADVERTENCIA] No se encontro el registro para actualizar.\n";
+	}
+}
+
+// --- Operaciones de Ordenamiento ---
+// El orden sale de ordenesTabla<T>: solo se arma con un sort la primera vez; después las altas
+// se mezclan y mostrar la lista ordenada es un recorrido lineal (descendente = al revés)
+template<typename T>
+void ordenarRegistros(const vector<T>& registros) {
+	using E = EsquemaRegistro<T>;
+	const char* campo1 = E::camposTexto[E::camposOrden[0]].columna;
+	const char* campo2 = E::camposTexto[E::camposOrden[1]].columna;
+	cout << "\n======= ORDENAR REGISTROS DE " << E::nombre << " =======\n";
+	cout << "Ordenar por: 1. " << campo1 << " (Texto) | 2. " << campo2 << " (Texto) | 3. Total (Numerico): ";
+	int campo = pedirEntero("");
+	cout << "¿Orden Ascendente (1) o Descendente (2)?: ";
+	int orden = pedirEntero("");
+	bool asc = (orden == 1);
+
+	if (campo < 1 || campo > 3) {
+		cout << "[ADVERTENCIA] Opcion de campo invalida. No se realizo el ordenamiento.\n";
+		return;
+	}
+	const char* nombreCampo = campo == 1 ? campo1 : campo == 2 ? campo2 : "Total";
+	const vector<uint32_t>* posiciones;
+	{
+		MEDIR_OPERACION(OrdenarRegistros);
+		posiciones = &ordenesTabla<T>.orden(registros, static_cast<size_t>(campo - 1));
+	}
+	cout << "[ORDENAMIENTO] Lista ordenada por " << nombreCampo << " " << (asc ? "ASCENDENTE" : "DESCENDENTE");
+	if (ordenesTabla<T>.ultimoCompleto) cout << " (orden armado; se mantiene para las siguientes consultas).\n";
+	else cout << " (orden mantenido; " << ordenesTabla<T>.ultimasMezcladas << " altas mezcladas).\n";
+	mostrarRegistros(registros, posiciones, !asc);
+}
+
+// ======================= MENUS DE LISTAS COMPLETOS =======================
+
+// Aviso de las filas que no se pudieron cargar (las primeras 'limite')
+template<typename T>
+void mostrarResumenRechazos(size_t limite) {
+	const vector<FilaRechazada>& rechazos = rechazosCSV<T>;
+	if (rechazos.empty()) return;
+	cout << "[ADVERTENCIA] " << rechazos.size() << " filas de '" << EsquemaRegistro<T>::archivo << "' no se cargaron:\n";
+	for (size_t i = 0; i < rechazos.size() && i < limite; ++i) {
+		cout << "  Linea " << rechazos[i].linea << ": " << rechazos[i].motivo << " | " << rechazos[i].contenido.substr(0, 60) << "\n";
+	}
+	if (rechazos.size() > limite) cout << "  ... (" << (rechazos.size() - limite) << " mas; detalle con --validar)\n";
+}
+
+template<typename T>
+uint64_t validarTabla(size_t limite) {
+	using E = EsquemaRegistro<T>;
+	vector<FilaRechazada> rechazos;
+	auto inicio = chrono::steady_clock::now();
+	uint64_t filas = recorrerCSV<T>(E::archivo, [](const T&, size_t) {}, &rechazos);
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	double mb = (tamanoArchivo(E::archivo) + tamanoArchivo(rutaBloques(E::archivo))) / 1048576.0;
+	cout << left << setw(28) << E::archivo << right << setw(10) << filas << " filas validas" << setw(8) << rechazos.size()
+		<< " rechazadas  " << fixed << setprecision(1) << setw(8) << mb / max(segundos, 1e-9) << " MB/s\n";
+	for (size_t i = 0; i < rechazos.size() && i < limite; ++i) {
+		cout << "  Linea " << rechazos[i].linea << ": " << rechazos[i].motivo << " | " << rechazos[i].contenido.substr(0, 80) << "\n";
+	}
+	if (rechazos.size() > limite) cout << "  ... (" << (rechazos.size() - limite) << " mas)\n";
+	return rechazos.size();
+}
+
+// Modo de linea de comandos: Proyecto7.0 --validar [--max <n>]
+// Revisa las tres tablas y lista las filas rechazadas; regresa 2 si hubo alguna.
+int ejecutarValidacion(int argc, char* argv[]) {
+	size_t limite = 20;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--max" && i + 1 < argc) limite = strtoull(argv[++i], nullptr, 10);
+		else {
+			cout << "Uso: Proyecto7.0 --validar [--max <n>]\n";
+			return 1;
+		}
+	}
+	uint64_t rechazadas = validarTabla<IngresoRecord>(limite) + validarTabla<TallerRecord>(limite) + validarTabla<KilometrajeRecord>(limite);
+	return rechazadas ? 2 : 0;
+}
+
+// Corre la consulta filtrada y, para comparar, una carga completa de la misma tabla
+template<typename T>
+void consultarTabla(FiltroRegistros<T> filtro, const string& camion, size_t limite) {
+	using E = EsquemaRegistro<T>;
+	if (!camion.empty()) {
+		for (size_t i = 0; i < size(E::camposTexto); ++i) {
+			if (string(E::camposTexto[i].columna) == "Camion") filtro.campo = static_cast<int>(i);
+		}
+		filtro.valor = camion;
+	}
+	const double mb = (tamanoArchivo(E::archivo) + tamanoArchivo(rutaBloques(E::archivo))) / 1048576.0;
+
+	auto inicio = chrono::steady_clock::now();
+	vector<T> encontrados = cargarCSV<T>(filtro);
+	double segundosFiltro = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	inicio = chrono::steady_clock::now();
+	size_t todos = cargarCSV<T>().size();
+	double segundosCompleto = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+	for (size_t i = 0; i < encontrados.size() && i < limite; ++i) mostrarResumenRegistro(encontrados[i]);
+	if (encontrados.size() > limite) cout << " ... (" << (encontrados.size() - limite) << " mas)\n";
+	cout << "[RESUMEN] " << E::archivo << ": " << encontrados.size() << " de " << todos << " registros coinciden.\n"
+		<< fixed << setprecision(3) << "  Consulta filtrada: " << segundosFiltro << " s (" << setprecision(1)
+		<< mb / max(segundosFiltro, 1e-9) << " MB/s)\n"
+		<< setprecision(3) << "  Carga completa:    " << segundosCompleto << " s (" << setprecision(1)
+		<< mb / max(segundosCompleto, 1e-9) << " MB/s)\n";
+}
+
+// Modo de linea de comandos: Proyecto7.0 --consulta <ingresos|taller|km> [--camion <id> | --buscar <texto>]
+//   [--total-min <valor>] [--total-max <valor>] [--con-serie] [--max <n>]
+// --buscar es la búsqueda del menú de listas: cualquier campo de texto igual a <texto>
+int ejecutarConsulta(int argc, char* argv[]) {
+	const char* uso = "Uso: Proyecto7.0 --consulta <ingresos|taller|km> [--camion <id> | --buscar <texto>] [--total-min <valor>]"
+		" [--total-max <valor>] [--con-serie] [--max <n>]\n";
+	if (argc < 3) { cout << uso; return 1; }
+	const string ruta = rutaTablaHistorica(argv[2]);
+	string camion, buscar, minimo, maximo;
+	bool conSerie = false;
+	size_t limite = 20;
+	for (int i = 3; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--camion" && tieneValor) camion = argv[++i];
+		else if (arg == "--buscar" && tieneValor) buscar = argv[++i];
+		else if (arg == "--total-min" && tieneValor) minimo = argv[++i];
+		else if (arg == "--total-max" && tieneValor) maximo = argv[++i];
+		else if (arg == "--con-serie") conSerie = true;
+		else if (arg == "--max" && tieneValor) limite = strtoull(argv[++i], nullptr, 10);
+		else { cout << uso; return 1; }
+	}
+
+	auto ejecutar = [&](auto muestra) -> int {
+		using T = decltype(muestra);
+		FiltroRegistros<T> filtro;
+		filtro.conSerie = conSerie;
+		filtro.cualquierCampo = !buscar.empty();
+		filtro.valor = buscar;
+		filtro.conMinimo = !minimo.empty();
+		filtro.conMaximo = !maximo.empty();
+		if ((filtro.conMinimo && !convertirValor(minimo, filtro.totalMinimo)) ||
+			(filtro.conMaximo && !convertirValor(maximo, filtro.totalMaximo))) {
+			cout << "!!! ERROR: el total debe ser numerico.\n";
+			return 1;
+		}
+		consultarTabla<T>(filtro, camion, limite);
+		return 0;
+	};
+	if (ruta == NOMBRE_ARCHIVO_INGRESOS) return ejecutar(IngresoRecord{});
+	if (ruta == NOMBRE_ARCHIVO_TALLER) return ejecutar(TallerRecord{});
+	if (ruta == NOMBRE_ARCHIVO_KM) return ejecutar(KilometrajeRecord{});
+	cout << uso;
+	return 1;
+}
+
+/**
+ * @brief Menú de listas genérico para cualquier tipo de registro con EsquemaRegistro.
+ * @return true si se debe regresar al menú de ordenamiento (para agregar un nuevo registro), false para salir.
+ */
+template<typename T>
+bool menuListaGenerico(const string& metodoUsado) {
+	int opcion = 0;
+	bool regresarMenuOrdenamiento = false;
+
+	// Solo las opciones que muestran o modifican la lista completa la cargan con sus series
+	auto cargarCompleto = []() {
+		vector<T> registros = cargarCSV<T>();
+		mostrarResumenRechazos<T>(3);
+		return registros;
+	};
+
+	while (opcion != 9) {
+		reportarFallosEscritura();
+		const uint64_t totalRegistros = contarRegistros<T>();
+
+		cout << "\n======== MENU DE LISTAS DE REGISTROS (" << metodoUsado << ") ========\n";
+		cout << "Registros actuales: " << totalRegistros << endl;
+		cout << "--------------------------------------------------------" << endl;
+		cout << "1. Mostrar todos los registros actuales" << endl;
+		cout << "2. Agregar un nuevo registro (Regresar al Menu Ordenamiento)" << endl;
+		cout << "3. Eliminar un registro" << endl;
+		cout << "--------------------------------------------------------" << endl;
+		cout << "4. Búsqueda: Encontrar un elemento en la lista" << endl;
+		cout << "5. Actualización: Modificar el valor de un elemento en la lista" << endl;
+		cout << "6. Ordenamiento: Organizar los elementos en un orden específico" << endl;
+		cout << "7. Tamaño: Obtener cuántos elementos tiene la lista" << endl;
+		cout << "8. Verificar si está vacía: Comprobar si la lista no contiene ningún elemento" << endl;
+		cout << "9. Regresar al Menu Principal" << endl;
+		cout << "Seleccione una opcion: ";
+		cin >> opcion;
+		limpiarBuffer();
+
+		switch (opcion) {
+		case 1: {
+			vector<T> registros = cargarCompleto();
+			mostrarRegistros(registros);
+			limpiarPantalla();
+			break;
+		}
+		case 2:
+			regresarMenuOrdenamiento = true;
+			opcion = 9; // Salir del bucle
+			break;
+		case 3: {
+			vector<T> registros = cargarCompleto();
+			eliminarRegistro(registros);
+			limpiarPantalla();
+			break;
+		}
+		case 4:
+			buscarRegistro<T>(totalRegistros, metodoUsado);
+			limpiarPantalla();
+			break;
+		case 5: {
+			vector<T> registros = cargarCompleto();
+			actualizarRegistro(registros);
+			limpiarPantalla();
+			break;
+		}
+		case 6: {
+			vector<T> registros = cargarCompleto();
+			ordenarRegistros(registros); // Muestra la lista ordenada dentro de la función
+			limpiarPantalla();
+			break;
+		}
+		case 7:
+			cout << "\n[TAMAÑO] La lista contiene " << totalRegistros << " elementos.\n";
+			limpiarPantalla();
+			break;
+		case 8:
+			if (totalRegistros == 0) {
+				cout << "\n[ESTADO] La lista ESTA vacia.\n";
+			}
+			else {
+				cout << "\n[ESTADO] La lista NO esta vacia. Contiene " << totalRegistros << " elementos.\n";
+			}
+			limpiarPantalla();
+			break;
+		case 9:
+			cout << "Regresando al Menu Principal...\n";
+			break;
+		default:
+			cout << "Opcion invalida. Intente de nuevo." << endl;
+			limpiarPantalla();
+			break;
+		}
+	}
+	return regresarMenuOrdenamiento;
+}
+
+// Adaptadores: si el usuario elige "Agregar", se regresa al método de captura correspondiente
+void menuListaIngresosCompleto(const string& metodoUsado) {
+	if (menuListaGenerico<IngresoRecord>(metodoUsado)) {
+		metodoBurbuja();
+	}
+}
+void menuListaTallerCompleto(const string& metodoUsado) {
+	if (menuListaGenerico<TallerRecord>(metodoUsado)) {
+		metodoSeleccion();
+	}
+}
+void menuListaKilometrajeCompleto(const string& metodoUsado) {
+	if (menuListaGenerico<KilometrajeRecord>(metodoUsado)) {
+		metodoInsercion();
+	}
+}
+
+
+// ======================= ROLLUPS DE INGRESOS (SEMANA, MES Y AÑO) =======================
+// Acumulados de ingresos por camion y por chofer, por semana ISO, mes y año. Se arman con
+// una sola pasada sobre el CSV la primera vez que se consultan y después se mantienen al
+// día con cada alta, actualización o baja del CRUD (sin volver a leer el archivo).
+// Si el CSV cambia por fuera (su tamaño ya no coincide) se vuelven a armar en la siguiente consulta.
+// La semana entera se asigna al mes de su jueves (los días 1-7 se guardan ordenados por
+// monto, así que no se puede repartir por día).
+
+enum class DimensionRollup { Camion = 0, Chofer = 1 };
+
+struct CuboAnual {
+	array<Centavos, 54> semanas{}; // Índices 1..53
+	array<Centavos, 13> meses{};   // Índices 1..12
+	Centavos total = 0;
+	int64_t registros = 0;
+};
+
+class RollupIngresos {
+	// [dimension][año][camion o chofer]
+	array<map<int, unordered_map<string, CuboAnual>>, 2> cubos;
+	array<unordered_map<string, Centavos>, 2> sinSemana; // Registros sin semana (o inválida)
+	uint64_t huella = 0;      // Tamaño del CSV cuando los acumulados quedaron al día
+	bool construido = false;
+
+	void acumular(DimensionRollup dim, const string& clave, SemanaISO s, Centavos monto, int signo) {
+		size_t d = static_cast<size_t>(dim);
+		if (!s.valida()) {
+			auto it = sinSemana[d].try_emplace(clave, 0).first;
+			it->second += signo * monto;
+			if (it->second == 0 && signo < 0) sinSemana[d].erase(it);
+			return;
+		}
+		auto& delAnio = cubos[d][s.anio];
+		auto it = delAnio.try_emplace(clave).first;
+		CuboAnual& cubo = it->second;
+		cubo.semanas[s.semana] += signo * monto;
+		cubo.meses[mesDeSemana(s)] += signo * monto;
+		cubo.total += signo * monto;
+		cubo.registros += signo;
+		if (cubo.registros <= 0) delAnio.erase(it);
+		if (delAnio.empty()) cubos[d].erase(s.anio);
+	}
+
+public:
+	void aplicar(const IngresoRecord& r, int signo) {
+		SemanaISO s;
+		convertirSemana(r.semana, s);
+		acumular(DimensionRollup::Camion, r.camion, s, r.total, signo);
+		acumular(DimensionRollup::Chofer, r.chofer, s, r.total, signo);
+	}
+
+	// false si 'detener' cortó la pasada (los acumulados quedan sin armar)
+	bool reconstruir(const atomic<bool>* detener = nullptr) {
+		for (auto& c : cubos) c.clear();
+		for (auto& m : sinSemana) m.clear();
+		FiltroRegistros<IngresoRecord> soloTotal; // Los acumulados solo usan semana, camion, chofer y Total
+		soloTotal.conSerie = false;
+		soloTotal.detener = detener;
+		recorrerCSV<IngresoRecord>(NOMBRE_ARCHIVO_INGRESOS, [this](const IngresoRecord& r, size_t) { aplicar(r, +1); }, nullptr, soloTotal);
+		construido = !(detener && detener->load());
+		if (!construido) {
+			for (auto& c : cubos) c.clear();
+			for (auto& m : sinSemana) m.clear();
+			return false;
+		}
+		huella = tamanoArchivo(NOMBRE_ARCHIVO_INGRESOS);
+		return true;
+	}
+
+	// Antes de una consulta: arma los acumulados si faltan o si el CSV cambió por fuera
+	bool asegurarVigente(const atomic<bool>* detener = nullptr) {
+		if (!construido || huella != tamanoArchivo(NOMBRE_ARCHIVO_INGRESOS)) return reconstruir(detener);
+		return true;
+	}
+
+	// Desde el CRUD, antes de escribir: solo se aplica si ya están armados y al día
+	// (si después la escritura falla, descartar() los deja para reconstruir)
+	void cambio(const IngresoRecord& r, int signo) {
+		if (!construido) return;
+		if (huella != tamanoArchivo(NOMBRE_ARCHIVO_INGRESOS)) { construido = false; return; }
+		aplicar(r, signo);
+	}
+
+	// Desde el CRUD, después de escribir el CSV
+	void sincronizar() {
+		if (construido) huella = tamanoArchivo(NOMBRE_ARCHIVO_INGRESOS);
+	}
+
+	// Desde el CRUD, si el CSV no se escribió: los cambios ya aplicados no están en el archivo
+	void descartar() {
+		construido = false;
+		for (auto& c : cubos) c.clear();
+		for (auto& m : sinSemana) m.clear();
+	}
+
+	const unordered_map<string, CuboAnual>* delAnio(DimensionRollup dim, int anio) const {
+		const auto& porAnio = cubos[static_cast<size_t>(dim)];
+		auto it = porAnio.find(anio);
+		return it == porAnio.end() ? nullptr : &it->second;
+	}
+
+	const CuboAnual* cubo(DimensionRollup dim, int anio, const string& clave) const {
+		const auto* mapa = delAnio(dim, anio);
+		if (!mapa) return nullptr;
+		auto it = mapa->find(clave);
+		return it == mapa->end() ? nullptr : &it->second;
+	}
+
+	vector<int> anios(DimensionRollup dim) const {
+		vector<int> lista;
+		for (const auto& par : cubos[static_cast<size_t>(dim)]) lista.push_back(par.first);
+		return lista;
+	}
+
+	Centavos totalSinSemana(DimensionRollup dim) const {
+		Centavos total = 0;
+		for (const auto& par : sinSemana[static_cast<size_t>(dim)]) total += par.second;
+		return total;
+	}
+};
+
+RollupIngresos rollupIngresos;
+
+void registroAgregado(const IngresoRecord& record) {
+	rollupIngresos.cambio(record, +1);
+	ordenesTabla<IngresoRecord>.antesDeGuardar();
+}
+void registroRetirado(const IngresoRecord& record) { rollupIngresos.cambio(record, -1); }
+void tablaGuardada(const IngresoRecord* agregado) {
+	rollupIngresos.sincronizar();
+	ordenesTabla<IngresoRecord>.guardada(agregado);
+}
+void tablaNoGuardada(const IngresoRecord*) { rollupIngresos.descartar(); }
+
+constexpr const char* MESES_CORTOS[] = { "", "ENE", "FEB", "MAR", "ABR", "MAY", "JUN", "JUL", "AGO", "SEP", "OCT", "NOV", "DIC" };
+
+// "Ingresos mensuales por camion (o chofer) del año": una búsqueda en el mapa del año
+void mostrarIngresosMensuales(DimensionRollup dim, int anio, size_t limite) {
+	auto inicio = chrono::steady_clock::now();
+	const auto* mapa = rollupIngresos.delAnio(dim, anio);
+	vector<pair<const string*, const CuboAnual*>> filas;
+	if (mapa) {
+		filas.reserve(mapa->size());
+		for (const auto& par : *mapa) filas.emplace_back(&par.first, &par.second);
+	}
+	size_t top = min(limite, filas.size());
+	partial_sort(filas.begin(), filas.begin() + top, filas.end(),
+		[](const auto& a, const auto& b) { return a.second->total > b.second->total; });
+	CuboAnual general;
+	for (const auto& f : filas) {
+		for (int m = 1; m <= 12; ++m) general.meses[m] += f.second->meses[m];
+		general.total += f.second->total;
+	}
+	double microsegundos = chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count();
+
+	const char* nombreDim = dim == DimensionRollup::Camion ? "CAMION" : "CHOFER";
+	if (filas.empty()) {
+		cout << "[NO ENCONTRADO] No hay ingresos con semana registrada en " << anio << ".\n";
+		return;
+	}
+	cout << "\n======= INGRESOS MENSUALES POR " << nombreDim << " " << anio << " (" << filas.size() << " en total) =======\n";
+	cout << left << setw(18) << nombreDim << right;
+	for (int m = 1; m <= 12; ++m) cout << setw(14) << MESES_CORTOS[m];
+	cout << setw(16) << "TOTAL" << "\n";
+	auto imprimir = [](const string& nombre, const CuboAnual& c) {
+		cout << left << setw(18) << nombre.substr(0, 17) << right;
+		for (int m = 1; m <= 12; ++m) cout << setw(14) << Monto{ c.meses[m] };
+		cout << setw(16) << Monto{ c.total } << "\n";
+	};
+	for (size_t i = 0; i < top; ++i) imprimir(*filas[i].first, *filas[i].second);
+	if (filas.size() > top) cout << "... (" << (filas.size() - top) << " mas)\n";
+	imprimir("TOTAL", general);
+	cout << "(Consulta resuelta desde los acumulados en " << fixed << setprecision(1) << microsegundos << " us)\n";
+}
+
+void mostrarIngresosSemanales(DimensionRollup dim, int anio, const string& clave) {
+	const CuboAnual* c = rollupIngresos.cubo(dim, anio, clave);
+	if (!c) {
+		cout << "[NO ENCONTRADO] No hay ingresos de '" << clave << "' en " << anio << ".\n";
+		return;
+	}
+	cout << "\n======= INGRESOS SEMANALES DE " << clave << " EN " << anio << " (" << c->registros << " registros) =======\n";
+	for (int w = 1; w <= semanasEnAnio(anio); ++w) {
+		if (c->semanas[w] == 0) continue;
+		cout << textoSemana(SemanaISO{ anio, w }) << " (" << MESES_CORTOS[mesDeSemana(SemanaISO{ anio, w })] << ")  $"
+			<< right << setw(16) << Monto{ c->semanas[w] } << "\n";
+	}
+	cout << "TOTAL " << anio << ":      $" << setw(16) << Monto{ c->total } << "\n";
+}
+
+int pedirAnioRollup(DimensionRollup dim) {
+	vector<int> disponibles = rollupIngresos.anios(dim);
+	if (!disponibles.empty()) {
+		cout << "Anios con ingresos:";
+		for (int a : disponibles) cout << " " << a;
+		cout << "\n";
+	}
+	return pedirEntero("Ingrese el anio: ");
+}
+
+
+// ======================= METODOS DE ORDENAMIENTO (CASE 6) =======================
+
+// ---------- MÉTODO BURBUJA (Adaptado para List Menu) ----------
+void burbujaDesc(vector<Centavos>& ingresos) {
+	for (size_t i = 0; i < ingresos.size() - 1; i++) {
+		for (size_t j = 0; j < ingresos.size() - i - 1; j++) {
+			if (ingresos[j] < ingresos[j + 1]) {
+				swap(ingresos[j], ingresos[j + 1]);
+			}
+		}
+	}
+}
+
+constexpr const char* DIAS_SEMANA[] = { "Lunes", "Martes", "Miercoles", "Jueves", "Viernes", "Sabado", "Domingo" };
+
+string obtenerNombreDia(size_t indice, bool esSemanaActual) {
+	if (esSemanaActual && indice < size(DIAS_SEMANA)) {
+		return DIAS_SEMANA[indice];
+	}
+	return "Dia " + to_string(indice + 1);
+}
+
+void metodoBurbuja() {
+	string camion, chofer;
+	cout << "\n======= METODO BURBUJA: REGISTRO DE INGRESOS (ORDENAMIENTO DESCENDENTE) =======\n";
+	cout << "Ingrese el numero de camion: ";
+	cin >> camion;
+	limpiarBuffer();
+	chofer = pedirChoferDeCamion(camion, "Ingrese el nombre del chofer: ");
+
+	vector<Centavos> ingresos(7);
+	char resp;
+	cout << "¿Los ingresos corresponden a los 7 dias de una semana actual (Lunes a Domingo)? (S/N): ";
+	cin >> resp;
+	limpiarBuffer();
+
+	bool esSemanaActual = (toupper(resp) == 'S');
+	SemanaISO semana = semanaActual();
+	if (!esSemanaActual) {
+		string texto = pedirTexto("Semana de los ingresos (AAAA-Www, ej. 2025-W07; Enter si no aplica): ");
+		if (!texto.empty() && !convertirSemana(texto, semana)) {
+			cout << "[ADVERTENCIA] Semana invalida. El registro se guarda sin semana.\n";
+		}
+		if (texto.empty()) semana = SemanaISO{};
+	}
+
+	cout << "\nIngrese los ingresos por cada dia de la semana:\n";
+	for (size_t i = 0; i < ingresos.size(); i++) {
+		ingresos[i] = pedirMonto(obtenerNombreDia(i, esSemanaActual) + " (" + to_string(i + 1) + "): ");
+	}
+
+	Centavos total = sumaMontos(ingresos);
+	burbujaDesc(ingresos); // Ordenar
+
+	cout << "\n======= INGRESOS ORDENADOS (MAYOR A MENOR) =======\n";
+	cout << "Camion: " << camion << ", Chofer: " << chofer;
+	if (semana.valida()) cout << ", Semana: " << textoSemana(semana);
+	cout << endl;
+	cout << "Dia\t\tIngreso\n";
+	for (size_t i = 0; i < ingresos.size(); i++) {
+		cout << obtenerNombreDia(i, esSemanaActual) << "\t" << Monto{ ingresos[i] } << "\n";
+	}
+	cout << "---------------------------------\nTOTAL:\t\t" << Monto{ total } << "\n";
+
+	// 1. Guardar el registro en el archivo CSV (APPEND)
+	if (guardarCSV_Append(IngresoRecord{ move(camion), move(chofer), move(ingresos), total, semana.valida() ? textoSemana(semana) : string() })) {
+		cout << "Registro en cola para '" << NOMBRE_ARCHIVO_INGRESOS << "' (se escribe en segundo plano).\n";
+	}
+
+	// 2. Mostrar el menu de listas inmediatamente
+	limpiarPantalla();
+	menuListaIngresosCompleto("METODO BURBUJA");
+}
+
+// ---------- MÉTODO SELECCIÓN (Adaptado para List Menu) ----------
+void seleccionAsc(vector<Centavos>& costos) {
+	for (size_t i = 0; i < costos.size() - 1; i++) {
+		size_t minIndex = i;
+		for (size_t j = i + 1; j < costos.size(); j++) {
+			if (costos[j] < costos[minIndex]) minIndex = j;
+		}
+		swap(costos[i], costos[minIndex]);
+	}
+}
+
+void metodoSeleccion() {
+	string camion, encargado, taller;
+	cout << "\n======= METODO SELECCION: REGISTRO DE COSTOS DE TALLER (ORDENAMIENTO ASCENDENTE) =======\n";
+	cout << "Ingrese el numero de camion: ";
+	cin >> camion;
+	limpiarBuffer();
+	cout << "Ingrese el nombre del encargado: ";
+	getline(cin, encargado);
+	cout << "Ingrese el nombre del taller: ";
+	getline(cin, taller);
+
+	int visitas;
+	visitas = pedirEntero("¿Cuantas veces fue al taller este mes?: ");
+	if (visitas <= 0) {
+		cout << "El numero de visitas debe ser un valor positivo.\n";
+		limpiarPantalla();
+		return;
+	}
 
-	bool existe = false;
-	ifstream archivoLectura("registro_camiones_pila.csv");
-	if (archivoLectura.good()) existe = true;
-	archivoLectura.close();
+	vector<Centavos> costos(visitas);
+	cout << "\nIngrese los costos por cada reparacion:\n";
+	for (size_t i = 0; i < costos.size(); i++) {
+		costos[i] = pedirMonto("Costo de la reparacion #" + to_string(i + 1) + ": ");
+	}
 
-	guardarMovimientoCSV(nuevoRegistro, !existe);
+	seleccionAsc(costos);
+	Centavos total = sumaMontos(costos);
 
-	cout << "\n[REGISTRO EXITOSO] Camion: " << nuevoRegistro.numeroCamion
-		<< " - Entrada registrada a las: " << nuevoRegistro.hora << endl;
-	cout << "Camiones actualmente en patio: " << camionesEnPatio.size() << " de " << MAX_CAMIONES << endl;
+	cout << "\n======= COSTOS ORDENADOS (MENOR A MAYOR) =======\n";
+	cout << "Visita\tCosto\n";
+	for (size_t i = 0; i < costos.size(); i++) {
+		cout << (i + 1) << "\t" << Monto{ costos[i] } << "\n";
+	}
+	cout << "---------------------------------\nTOTAL:\t" << Monto{ total } << "\n";
+
+	if (guardarCSV_Append(TallerRecord{ move(camion), move(encargado), move(taller), move(costos), total })) {
+		cout << "Registro en cola para '" << NOMBRE_ARCHIVO_TALLER << "' (se escribe en segundo plano).\n";
+	}
+
+	limpiarPantalla();
+	menuListaTallerCompleto("METODO SELECCION");
 }
 
-void registrarSalida() {
-	cout << "\n======== REGISTRO DE SALIDA (POP) ========\n";
-	if (camionesEnPatio.empty()) {
-		cout << "!!! ERROR: El patio de camiones esta vacio. No hay salidas para registrar." << endl;
+// ---------- MÉTODO INSERCIÓN (Adaptado para List Menu) ----------
+void insercionAsc(vector<double>& km) {
+	for (size_t i = 1; i < km.size(); i++) {
+		double key = km[i];
+		int j = static_cast<int>(i) - 1;
+		while (j >= 0 && km[j] > key) {
+			km[j + 1] = km[j];
+			j--;
+		}
+		km[j + 1] = key;
+	}
+}
+
+void metodoInsercion() {
+	string camion, chofer;
+	cout << "\n======= METODO INSERCION: REGISTRO DE KILOMETRAJE (ORDENAMIENTO ASCENDENTE) =======\n";
+	cout << "Ingrese el numero de camion: ";
+	cin >> camion;
+	limpiarBuffer();
+	chofer = pedirChoferDeCamion(camion, "Ingrese el nombre del chofer: ");
+
+	int dias;
+	dias = pedirEntero("¿Cuantos dias desea registrar kilometraje?: ");
+	if (dias <= 0) {
+		cout << "El numero de dias debe ser un valor positivo.\n";
+		limpiarPantalla();
 		return;
 	}
 
-	RegistroCamion ultimoCamion = camionesEnPatio.top();
+	vector<double> km(dias);
+	for (size_t i = 0; i < km.size(); i++) {
+		km[i] = pedirDouble("Kilometraje del dia #" + to_string(i + 1) + ": ");
+	}
 
-	cout << "[ULTIMO CAMION EN ENTRAR] Camion: " << ultimoCamion.numeroCamion
-		<< ", Conductor: " << ultimoCamion.conductor
-		<< ", Hora de Entrada: " << ultimoCamion.hora << endl;
-	cout << "------------------------------------------------------" << endl;
+	insercionAsc(km);
+	double total = sumaValores(km);
 
-	string numCamionSalida = pedirTexto("Confirme el NUMERO del camion para salir: ");
-	string conductorSalida = pedirTexto("Ingrese el nombre del CONDUCTOR que sale: ");
+	cout << "\n======= KILOMETRAJE ORDENADO (MENOR A MAYOR) =======\n";
+	cout << fixed << setprecision(2);
+	cout << "Dia\tKm\n";
+	for (size_t i = 0; i < km.size(); i++) cout << (i + 1) << "\t" << km[i] << "\n";
+	cout << "---------------------------------\nTOTAL:\t" << total << "\n";
 
-	if (numCamionSalida != ultimoCamion.numeroCamion) {
-		cout << "!!! ADVERTENCIA: El camion ingresado (" << numCamionSalida << ") no coincide con el ultimo en entrar (" << ultimoCamion.numeroCamion << ").\n";
+	if (guardarCSV_Append(KilometrajeRecord{ move(camion), move(chofer), move(km), total })) {
+		cout << "Registro en cola para '" << NOMBRE_ARCHIVO_KM << "' (se escribe en segundo plano).\n";
 	}
 
-	camionesEnPatio.pop();
+	limpiarPantalla();
+	menuListaKilometrajeCompleto("METODO INSERCION");
+}
 
-	RegistroCamion registroSalida;
-	registroSalida.numeroCamion = numCamionSalida;
-	registroSalida.conductor = conductorSalida;
-	registroSalida.tipoMovimiento = "SALIDA";
-	registroSalida.hora = obtenerHoraActual();
 
-	guardarMovimientoCSV(registroSalida, false);
+// ======================= ANOMALÍAS DE TALLER Y KILOMETRAJE (WELFORD Y EWMA) =======================
+// Una pasada por tabla deja por camion solo su media y varianza en línea (Welford) y un
+// promedio móvil exponencial (EWMA) de sus registros en orden de archivo: memoria constante por
+// camion aunque la historia tenga millones de filas. Cada registro de taller aporta su costo
+// total; cada registro de kilometraje, sus km por día. Se marcan los camiones cuyo último
+// registro o cuya EWMA se alejan de su propia historia (carta de control EWMA), o cuya media se
+// aleja de la del resto de la flota. Como los rollups, se mantienen al día con cada alta del CRUD y se vuelven a armar
+// si el archivo cambió por fuera o la tabla se reescribió.
+
+const double ALFA_EWMA = 0.2;           // Peso del registro más reciente
+const double UMBRAL_ANOMALIA = 3.0;     // Desviaciones estándar para marcar
+const uint64_t MIN_HISTORIA = 5;        // Registros antes de juzgar a un camion
+
+struct EstadisticaEnLinea {
+	uint64_t n = 0;
+	double media = 0.0;
+	double m2 = 0.0;            // Suma de cuadrados de las diferencias con la media
+
+	void agregar(double x) {
+		++n;
+		double d = x - media;
+		media += d / static_cast<double>(n);
+		m2 += d * (x - media);
+	}
+	double desviacion() const { return n > 1 ? sqrt(m2 / static_cast<double>(n - 1)) : 0.0; }
+};
+
+struct HistorialCamion {
+	EstadisticaEnLinea historia;
+	double ewma = 0.0;
+	double ultimo = 0.0;
+	double zUltimo = 0.0;       // El último registro contra la historia que había antes de él
+	uint64_t atipicos = 0;      // Registros a más de UMBRAL_ANOMALIA de la historia que tenían antes
+};
+
+// Valor que aporta cada registro: costo del mes en pesos o km por día
+inline double valorObservado(const TallerRecord& r) { return r.total / 100.0; }
+inline double valorObservado(const KilometrajeRecord& r) { return r.km.empty() ? r.total : r.total / static_cast<double>(r.km.size()); }
+
+template<typename T>
+class AnomaliasTabla {
+	unordered_map<string, HistorialCamion> camiones;
+	uint64_t huellaCSV = 0, huellaBloques = 0;
+	bool construido = false;
+
+	static uint64_t tamanoCSV() { return tamanoArchivo(EsquemaRegistro<T>::archivo); }
+	static uint64_t tamanoBloques() { return tamanoArchivo(rutaBloques(EsquemaRegistro<T>::archivo)); }
+	bool huellaCoincide() const { return huellaCSV == tamanoCSV() && huellaBloques == tamanoBloques(); }
+
+	void observar(const T& r) {
+		double x = valorObservado(r);
+		HistorialCamion& h = camiones[r.camion];
+		double s = h.historia.desviacion();
+		h.zUltimo = h.historia.n >= MIN_HISTORIA && s > 0.0 ? (x - h.historia.media) / s : 0.0;
+		if (fabs(h.zUltimo) > UMBRAL_ANOMALIA) ++h.atipicos;
+		h.ewma = h.historia.n == 0 ? x : ALFA_EWMA * x + (1.0 - ALFA_EWMA) * h.ewma;
+		h.ultimo = x;
+		h.historia.agregar(x);
+	}
+
+public:
+	// false si 'detener' cortó la pasada (el historial queda sin armar)
+	bool reconstruir(const atomic<bool>* detener = nullptr) {
+		camiones.clear();
+		FiltroRegistros<T> filtro;
+		filtro.conSerie = !is_same_v<T, TallerRecord>; // Los km por día necesitan el largo de la serie
+		filtro.detener = detener;
+		recorrerCSV<T>(EsquemaRegistro<T>::archivo, [this](const T& r, size_t) { observar(r); }, nullptr, filtro);
+		construido = !(detener && detener->load());
+		if (!construido) {
+			camiones.clear();
+			return false;
+		}
+		huellaCSV = tamanoCSV();
+		huellaBloques = tamanoBloques();
+		return true;
+	}
+
+	bool asegurarVigente(const atomic<bool>* detener = nullptr) {
+		if (!construido || !huellaCoincide()) return reconstruir(detener);
+		return true;
+	}
+
+	// Desde el CRUD, antes de escribir: solo se aplica si ya están armados y al día
+	// (si después la escritura falla, descartar() deja el historial para reconstruir)
+	void cambio(const T& r) {
+		if (!construido) return;
+		if (!huellaCoincide()) { construido = false; return; }
+		observar(r);
+	}
+
+	// Desde el CRUD, después de escribir; nullptr si se reescribió la tabla (la EWMA no se puede deshacer)
+	void guardada(const T* agregado) {
+		if (!construido) return;
+		if (!agregado) { construido = false; return; }
+		huellaCSV = tamanoCSV();
+		huellaBloques = tamanoBloques();
+	}
+
+	// Desde el CRUD, si el archivo no se escribió
+	void descartar() {
+		construido = false;
+		camiones.clear();
+	}
+
+	const unordered_map<string, HistorialCamion>& historiales() const { return camiones; }
+};
+
+template<typename T>
+inline AnomaliasTabla<T> anomaliasTabla;
+
+void registroAgregado(const TallerRecord& record) {
+	anomaliasTabla<TallerRecord>.cambio(record);
+	ordenesTabla<TallerRecord>.antesDeGuardar();
+}
+void tablaGuardada(const TallerRecord* agregado) {
+	anomaliasTabla<TallerRecord>.guardada(agregado);
+	ordenesTabla<TallerRecord>.guardada(agregado);
+}
+void tablaNoGuardada(const TallerRecord*) { anomaliasTabla<TallerRecord>.descartar(); }
+void registroAgregado(const KilometrajeRecord& record) {
+	anomaliasTabla<KilometrajeRecord>.cambio(record);
+	ordenesTabla<KilometrajeRecord>.antesDeGuardar();
+}
+void tablaGuardada(const KilometrajeRecord* agregado) {
+	anomaliasTabla<KilometrajeRecord>.guardada(agregado);
+	ordenesTabla<KilometrajeRecord>.guardada(agregado);
+}
+void tablaNoGuardada(const KilometrajeRecord*) { anomaliasTabla<KilometrajeRecord>.descartar(); }
+
+struct AnomaliaCamion {
+	string camion;
+	const char* tabla;
+	const HistorialCamion* h;
+	double zPropio = 0.0;       // EWMA contra la historia del camion
+	double zFlota = 0.0;        // Media del camion contra las medias de la flota
+
+	double gravedad() const { return max({ fabs(zPropio), fabs(zFlota), fabs(h->zUltimo) }); }
+};
+
+// Camiones de una tabla que pasan el umbral en cualquiera de los dos criterios
+template<typename T>
+void evaluarAnomalias(const char* tabla, vector<AnomaliaCamion>& marcados, uint64_t& evaluados) {
+	const auto& camiones = anomaliasTabla<T>.historiales();
+	EstadisticaEnLinea flota;
+	for (const auto& par : camiones) if (par.second.historia.n >= MIN_HISTORIA) flota.agregar(par.second.historia.media);
+	const double sFlota = flota.desviacion();
+	// Desviación de la EWMA cuando el camion sigue en su media: s * sqrt(alfa / (2 - alfa))
+	const double factorEwma = sqrt(ALFA_EWMA / (2.0 - ALFA_EWMA));
+	for (const auto& par : camiones) {
+		const HistorialCamion& h = par.second;
+		if (h.historia.n < MIN_HISTORIA) continue;
+		++evaluados;
+		AnomaliaCamion a{ par.first, tabla, &h };
+		double s = h.historia.desviacion();
+		if (s > 0.0) a.zPropio = (h.ewma - h.historia.media) / (s * factorEwma);
+		if (sFlota > 0.0) a.zFlota = (h.historia.media - flota.media) / sFlota;
+		if (a.gravedad() >= UMBRAL_ANOMALIA) marcados.push_back(move(a));
+	}
+}
+
+/**
+ * @brief Camiones con costos de taller o km por día fuera de lo normal, más graves primero.
+ * Las dos tablas se arman (si hace falta) en paralelo, cada una en su hilo; los bloques
+ * comprimidos además se decodifican con todos los núcleos.
+ */
+vector<AnomaliaCamion> detectarAnomalias(uint64_t& evaluados) {
+	MEDIR_OPERACION(DeteccionAnomalias);
+	thread hiloTaller([]() { anomaliasTabla<TallerRecord>.asegurarVigente(); });
+	anomaliasTabla<KilometrajeRecord>.asegurarVigente();
+	hiloTaller.join();
+
+	vector<AnomaliaCamion> marcados;
+	evaluados = 0;
+	evaluarAnomalias<TallerRecord>("TALLER", marcados, evaluados);
+	evaluarAnomalias<KilometrajeRecord>("KM/DIA", marcados, evaluados);
+	sort(marcados.begin(), marcados.end(), [](const AnomaliaCamion& a, const AnomaliaCamion& b) {
+		return a.gravedad() != b.gravedad() ? a.gravedad() > b.gravedad() : a.camion < b.camion;
+	});
+	return marcados;
+}
+
+void mostrarAnomalias(const vector<AnomaliaCamion>& marcados, uint64_t evaluados, size_t limite) {
+	cout << "\n======= CAMIONES CON COSTOS O KILOMETRAJE ATIPICOS (" << marcados.size() << " de " << evaluados
+		<< " evaluados, umbral " << fixed << setprecision(1) << UMBRAL_ANOMALIA << " desv.) =======\n";
+	if (marcados.empty()) {
+		cout << "Ningun camion se aleja de su historia ni de la flota.\n";
+		return;
+	}
+	cout << left << setw(10) << "CAMION" << setw(8) << "TABLA" << right << setw(11) << "REGISTROS" << setw(14) << "MEDIA"
+		<< setw(14) << "DESV." << setw(14) << "EWMA" << setw(14) << "ULTIMO" << setw(10) << "Z ULTIMO" << setw(10) << "Z PROPIO" << setw(10) << "Z FLOTA"
+		<< setw(10) << "ATIPICOS" << "\n";
+	cout << setprecision(2);
+	for (size_t i = 0; i < marcados.size() && i < limite; ++i) {
+		const AnomaliaCamion& a = marcados[i];
+		const HistorialCamion& h = *a.h;
+		cout << left << setw(10) << a.camion.substr(0, 9) << setw(8) << a.tabla << right << setw(11) << h.historia.n
+			<< setw(14) << h.historia.media << setw(14) << h.historia.desviacion() << setw(14) << h.ewma << setw(14) << h.ultimo
+			<< setw(10) << h.zUltimo << setw(10) << a.zPropio << setw(10) << a.zFlota << setw(10) << h.atipicos << "\n";
+	}
+	if (marcados.size() > limite) cout << "... (" << (marcados.size() - limite) << " camiones mas)\n";
+}
+
+// Modo de linea de comandos: Proyecto7.0 --anomalias [--max <n>]
+int ejecutarAnomalias(int argc, char* argv[]) {
+	size_t limite = 20;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--max" && i + 1 < argc) limite = strtoull(argv[++i], nullptr, 10);
+		else {
+			cout << "Uso: Proyecto7.0 --anomalias [--max <n>]\n";
+			return 1;
+		}
+	}
+	auto inicio = chrono::steady_clock::now();
+	uint64_t evaluados = 0;
+	vector<AnomaliaCamion> marcados = detectarAnomalias(evaluados);
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	mostrarAnomalias(marcados, evaluados, limite);
+	uint64_t bytes = tamanoArchivo(NOMBRE_ARCHIVO_TALLER) + tamanoArchivo(rutaBloques(NOMBRE_ARCHIVO_TALLER))
+		+ tamanoArchivo(NOMBRE_ARCHIVO_KM) + tamanoArchivo(rutaBloques(NOMBRE_ARCHIVO_KM));
+	cout << "Una pasada sobre " << fixed << setprecision(1) << bytes / 1048576.0 << " MB en " << setprecision(2) << segundos << " s\n";
+	return 0;
+}
+
+
+// ======================= REPORTES CRUZADOS (INGRESOS x TALLER x KILOMETRAJE) =======================
+// Join por hash de las tres tablas sobre 'camion' (u opcionalmente camion + chofer).
+// Cada tabla se lee una sola vez, en su propio hilo, y se agrega al vuelo en su propio mapa;
+// al final los tres mapas se combinan. No se guardan filas en memoria, solo un acumulado
+// por clave, así que el costo es lineal aunque cada tabla tenga millones de filas.
+
+const string NOMBRE_ARCHIVO_REPORTE = "reporte_camiones.csv";
+const char SEPARADOR_CLAVE = '\x1f'; // Separa camion y chofer dentro de la clave del mapa
+
+struct AcumuladoTabla {
+	Centavos monto = 0;
+	double km = 0.0;
+	uint64_t filas = 0;
+};
+
+struct FilaReporte {
+	string camion;
+	string chofer;              // Vacío en el reporte por camión
+	Centavos ingresos = 0;
+	Centavos costos = 0;
+	double km = 0.0;
+	uint64_t registrosIngreso = 0;
+	uint64_t visitasTaller = 0;
+	uint64_t registrosKm = 0;
+
+	Centavos margen() const { return ingresos - costos; }
+	double porKm(Centavos monto) const { return km > 0.0 ? monto / 100.0 / km : 0.0; }
+};
+
+inline void sumarFila(AcumuladoTabla& a, const IngresoRecord& r) { a.monto += r.total; ++a.filas; }
+inline void sumarFila(AcumuladoTabla& a, const TallerRecord& r) { a.monto += r.total; ++a.filas; }
+inline void sumarFila(AcumuladoTabla& a, const KilometrajeRecord& r) { a.km += r.total; ++a.filas; }
+
+// Una pasada sobre la tabla: acumulado por camion (y por chofer si la tabla lo tiene y se pide)
+template<typename T>
+unordered_map<string, AcumuladoTabla> agregarTabla(bool porChofer, const string& ruta = EsquemaRegistro<T>::archivo) {
+	unordered_map<string, AcumuladoTabla> mapa;
+	string clave; // Se reutiliza: buscar una clave existente no asigna memoria
+	FiltroRegistros<T> soloTotal;
+	soloTotal.conSerie = false;
+	recorrerCSV<T>(ruta, [&](const T& r, size_t) {
+		clave.assign(r.camion);
+		if constexpr (!is_same_v<T, TallerRecord>) {
+			if (porChofer) { clave += SEPARADOR_CLAVE; clave += r.chofer; }
+		}
+		sumarFila(mapa[clave], r);
+	}, nullptr, soloTotal);
+	return mapa;
+}
+
+/**
+ * @brief Reparte 'monto' en partes proporcionales a 'pesos' que suman exactamente 'monto'
+ * (residuo mayor: cada parte es el piso de su cuota y los centavos que faltan van a las de
+ * mayor fracción). Ninguna parte queda con signo contrario al monto. Sin pesos positivos el
+ * reparto es en partes iguales.
+ */
+vector<Centavos> repartirProporcional(Centavos monto, const vector<double>& pesos) {
+	const size_t n = pesos.size();
+	vector<Centavos> partes(n, 0);
+	if (n == 0) return partes;
+	const Centavos magnitud = monto < 0 ? -monto : monto;
+	double suma = 0.0;
+	for (double p : pesos) suma += max(p, 0.0);
+	vector<double> fracciones(n);
+	Centavos asignado = 0;
+	for (size_t i = 0; i < n; ++i) {
+		double cuota = suma > 0.0 ? magnitud * (max(pesos[i], 0.0) / suma) : static_cast<double>(magnitud) / n;
+		double piso = min(floor(cuota), static_cast<double>(magnitud));
+		partes[i] = static_cast<Centavos>(piso);
+		fracciones[i] = cuota - piso;
+		asignado += partes[i];
+	}
+	vector<size_t> orden(n);
+	iota(orden.begin(), orden.end(), size_t{ 0 });
+	stable_sort(orden.begin(), orden.end(), [&fracciones](size_t a, size_t b) { return fracciones[a] > fracciones[b]; });
+	// Con redondeo de double el residuo puede salir de [0, n): se reparte en vueltas, y un
+	// excedente se quita a partes que lo tengan (nunca por debajo de cero)
+	for (size_t k = 0; asignado < magnitud; ++k, ++asignado) ++partes[orden[k % n]];
+	while (asignado > magnitud) {
+		for (size_t k = n; k-- > 0 && asignado > magnitud;) {
+			if (partes[orden[k]] > 0) { --partes[orden[k]]; --asignado; }
+		}
+	}
+	if (monto < 0) for (auto& p : partes) p = -p;
+	return partes;
+}
+
+/**
+ * @brief Combina los acumulados de las tres tablas en una fila por camion (o por camion y chofer).
+ * En el reporte por chofer el taller no tiene chofer (tiene encargado), así que el costo de
+ * cada camion se reparte entre sus choferes según los km que manejó cada uno, con
+ * repartirProporcional: exacto al centavo y sin partes negativas.
+ */
+vector<FilaReporte> combinarReporteCruzado(const unordered_map<string, AcumuladoTabla>& ingresos,
+	const unordered_map<string, AcumuladoTabla>& taller, const unordered_map<string, AcumuladoTabla>& km, bool porChofer) {
+	vector<FilaReporte> filas;
+	unordered_map<string, size_t> posicion;
+	posicion.reserve(ingresos.size() + km.size());
+	auto filaDe = [&](const string& clave) -> FilaReporte& {
+		auto it = posicion.find(clave);
+		if (it != posicion.end()) return filas[it->second];
+		posicion.emplace(clave, filas.size());
+		FilaReporte f;
+		size_t sep = clave.find(SEPARADOR_CLAVE);
+		f.camion = clave.substr(0, sep);
+		if (sep != string::npos) f.chofer = clave.substr(sep + 1);
+		filas.push_back(move(f));
+		return filas.back();
+	};
+
+	for (const auto& par : ingresos) {
+		FilaReporte& f = filaDe(par.first);
+		f.ingresos += par.second.monto;
+		f.registrosIngreso += par.second.filas;
+	}
+	for (const auto& par : km) {
+		FilaReporte& f = filaDe(par.first);
+		f.km += par.second.km;
+		f.registrosKm += par.second.filas;
+	}
+
+	if (!porChofer) {
+		for (const auto& par : taller) {
+			FilaReporte& f = filaDe(par.first);
+			f.costos += par.second.monto;
+			f.visitasTaller += par.second.filas;
+		}
+		return filas;
+	}
+
+	unordered_map<string, vector<size_t>> filasDeCamion;
+	for (size_t i = 0; i < filas.size(); ++i) filasDeCamion[filas[i].camion].push_back(i);
+	for (const auto& par : taller) {
+		auto it = filasDeCamion.find(par.first);
+		if (it == filasDeCamion.end()) {
+			FilaReporte& f = filaDe(par.first + SEPARADOR_CLAVE + "(sin chofer)");
+			f.costos += par.second.monto;
+			f.visitasTaller += par.second.filas;
+			continue;
+		}
+		const vector<size_t>& indices = it->second;
+		vector<double> kmChofer;
+		kmChofer.reserve(indices.size());
+		for (size_t i : indices) kmChofer.push_back(filas[i].km);
+		vector<Centavos> partes = repartirProporcional(par.second.monto, kmChofer);
+		for (size_t k = 0; k < indices.size(); ++k) filas[indices[k]].costos += partes[k];
+		filas[indices.back()].visitasTaller += par.second.filas;
+	}
+	return filas;
+}
+
+// Lee las tres tablas (cada una en su hilo) y las combina
+vector<FilaReporte> generarReporteCruzado(bool porChofer) {
+	MEDIR_OPERACION(ReporteCruzado);
+	unordered_map<string, AcumuladoTabla> ingresos, taller, km;
+	thread hiloIngresos([&]() { ingresos = agregarTabla<IngresoRecord>(porChofer); });
+	thread hiloTaller([&]() { taller = agregarTabla<TallerRecord>(false); });
+	km = agregarTabla<KilometrajeRecord>(porChofer);
+	hiloIngresos.join();
+	hiloTaller.join();
+	return combinarReporteCruzado(ingresos, taller, km, porChofer);
+}
+
+// Placas del camion si está en el registro de unidades (el texto "Camion" es su id)
+string placasDeCamion(const string& camion) {
+	const UnidadFijo* u = registroUnidades.resolverCamion(camion);
+	return u ? to_string(u->placas) : "-";
+}
+
+void mostrarReporteCruzado(vector<FilaReporte>& filas, bool porChofer, size_t limite) {
+	sort(filas.begin(), filas.end(), [](const FilaReporte& a, const FilaReporte& b) { return a.margen() > b.margen(); });
+	FilaReporte general;
+	for (const auto& f : filas) {
+		general.ingresos += f.ingresos;
+		general.costos += f.costos;
+		general.km += f.km;
+	}
+
+	cout << "\n======= REPORTE CRUZADO POR " << (porChofer ? "CAMION Y CHOFER" : "CAMION") << " (" << filas.size()
+		<< " filas, mayores margenes primero) =======\n";
+	cout << left << setw(8) << "CAMION";
+	if (porChofer) cout << setw(22) << "CHOFER";
+	cout << setw(10) << "PLACAS" << right << setw(18) << "INGRESOS" << setw(17) << "COSTOS" << setw(16) << "KM"
+		<< setw(10) << "ING/KM" << setw(10) << "COSTO/KM" << setw(18) << "MARGEN" << "\n";
+	cout << fixed << setprecision(2);
+	for (size_t i = 0; i < filas.size() && i < limite; ++i) {
+		const FilaReporte& f = filas[i];
+		cout << left << setw(8) << f.camion;
+		if (porChofer) cout << setw(22) << f.chofer.substr(0, 21);
+		cout << setw(10) << placasDeCamion(f.camion) << right << setw(18) << Monto{ f.ingresos } << setw(17) << Monto{ f.costos }
+			<< setw(16) << f.km << setw(10) << f.porKm(f.ingresos) << setw(10) << f.porKm(f.costos) << setw(18) << Monto{ f.margen() } << "\n";
+	}
+	if (filas.size() > limite) cout << "... (" << (filas.size() - limite) << " filas mas en el CSV exportado)\n";
+	cout << left << setw(porChofer ? 40 : 18) << "TOTAL" << right << setw(18) << Monto{ general.ingresos } << setw(17) << Monto{ general.costos }
+		<< setw(16) << general.km << setw(10) << general.porKm(general.ingresos) << setw(10) << general.porKm(general.costos)
+		<< setw(18) << Monto{ general.margen() } << "\n";
+}
+
+bool guardarReporteCruzado(const vector<FilaReporte>& filas, bool porChofer, const string& ruta) {
+	ofstream archivo(ruta, ios::out | ios::binary);
+	if (!archivo.is_open()) {
+		cout << "!!! ERROR: No se pudo abrir '" << ruta << "' para exportar el reporte.\n";
+		return false;
+	}
+	archivo << "Camion," << (porChofer ? "Chofer," : "") << "Placas,Ingresos,Costos,Km,Ingreso_Km,Costo_Km,Margen,Margen_Km\n";
+	archivo << fixed << setprecision(2);
+	for (const auto& f : filas) {
+		escribirCampoCSV(archivo, f.camion);
+		archivo << ",";
+		if (porChofer) {
+			escribirCampoCSV(archivo, f.chofer);
+			archivo << ",";
+		}
+		archivo << placasDeCamion(f.camion) << "," << Monto{ f.ingresos } << "," << Monto{ f.costos } << "," << f.km << ","
+			<< setprecision(4) << f.porKm(f.ingresos) << "," << f.porKm(f.costos) << "," << setprecision(2) << Monto{ f.margen() } << ","
+			<< setprecision(4) << f.porKm(f.margen()) << setprecision(2) << "\n";
+	}
+	CONTAR_METRICA(BytesEscritos, archivo.tellp());
+	archivo.close();
+	if (!archivo) {
+		cout << "!!! ERROR: No se pudo escribir '" << ruta << "' completo; el reporte exportado esta incompleto.\n";
+		return false;
+	}
+	cout << "[CSV ACTUALIZADO] Reporte de " << filas.size() << " filas exportado a '" << ruta << "'.\n";
+	return true;
+}
+
+void menuReportes() {
+	abrirRegistros();
+	int opcion = 0;
+	while (opcion != 6) {
+		cout << "\n======= REPORTES CRUZADOS (INGRESOS, TALLER Y KILOMETRAJE) =======" << endl;
+		cout << "1. Ingreso/km, costo/km y margen por camion" << endl;
+		cout << "2. Ingreso/km, costo/km y margen por camion y chofer" << endl;
+		cout << "3. Ingresos mensuales de un anio (por camion o chofer)" << endl;
+		cout << "4. Ingresos semanales de un camion o chofer" << endl;
+		cout << "5. Camiones con costos de taller o km atipicos" << endl;
+		cout << "6. Regresar" << endl;
+		opcion = pedirEntero("Seleccione una opcion: ");
+		if (opcion == 5) {
+			uint64_t evaluados = 0;
+			vector<AnomaliaCamion> marcados = detectarAnomalias(evaluados);
+			mostrarAnomalias(marcados, evaluados, 20);
+			limpiarPantalla();
+			continue;
+		}
+		if (opcion == 3 || opcion == 4) {
+			rollupIngresos.asegurarVigente();
+			DimensionRollup dim = pedirEntero("1. Por camion | 2. Por chofer: ") == 2 ? DimensionRollup::Chofer : DimensionRollup::Camion;
+			int anio = pedirAnioRollup(dim);
+			if (opcion == 3) mostrarIngresosMensuales(dim, anio, 20);
+			else mostrarIngresosSemanales(dim, anio, pedirTexto(dim == DimensionRollup::Camion ? "Numero de camion: " : "Nombre del chofer: "));
+			limpiarPantalla();
+			continue;
+		}
+		if (opcion != 1 && opcion != 2) {
+			if (opcion != 6) cout << "Opcion invalida. Intente de nuevo." << endl;
+			continue;
+		}
+		bool porChofer = (opcion == 2);
+		auto inicio = chrono::steady_clock::now();
+		vector<FilaReporte> filas = generarReporteCruzado(porChofer);
+		double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		mostrarReporteCruzado(filas, porChofer, 20);
+		cout << "(Calculado en " << fixed << setprecision(3) << segundos << " s)\n";
+		string resp = pedirTexto("¿Exportar el reporte completo a '" + NOMBRE_ARCHIVO_REPORTE + "'? (S/N): ");
+		if (!resp.empty() && toupper(static_cast<unsigned char>(resp[0])) == 'S') guardarReporteCruzado(filas, porChofer, NOMBRE_ARCHIVO_REPORTE);
+		limpiarPantalla();
+	}
+}
+
+// Modo de linea de comandos: Proyecto7.0 --reporte [--por-chofer] [--salida <csv>] [--mensual <anio>]
+int ejecutarReporte(int argc, char* argv[]) {
+	bool porChofer = false;
+	int anioMensual = 0;
+	string salida = NOMBRE_ARCHIVO_REPORTE;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--por-chofer") porChofer = true;
+		else if (arg == "--salida" && i + 1 < argc) salida = argv[++i];
+		else if (arg == "--mensual" && i + 1 < argc) anioMensual = atoi(argv[++i]);
+		else {
+			cout << "Uso: Proyecto7.0 --reporte [--por-chofer] [--salida <csv>] [--mensual <anio>]\n";
+			return 1;
+		}
+	}
+	if (anioMensual != 0) {
+		auto inicio = chrono::steady_clock::now();
+		rollupIngresos.asegurarVigente();
+		double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		cout << "Acumulados armados en " << fixed << setprecision(2) << segundos << " s (una pasada sobre '" << NOMBRE_ARCHIVO_INGRESOS << "').\n";
+		mostrarIngresosMensuales(porChofer ? DimensionRollup::Chofer : DimensionRollup::Camion, anioMensual, 10);
+		return 0;
+	}
+	abrirRegistros();
+	auto inicio = chrono::steady_clock::now();
+	vector<FilaReporte> filas = generarReporteCruzado(porChofer);
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	mostrarReporteCruzado(filas, porChofer, 10);
+	bool guardado = guardarReporteCruzado(filas, porChofer, salida);
+	uint64_t bytes = tamanoArchivo(NOMBRE_ARCHIVO_INGRESOS) + tamanoArchivo(NOMBRE_ARCHIVO_TALLER) + tamanoArchivo(NOMBRE_ARCHIVO_KM);
+	cout << "Join de " << fixed << setprecision(1) << bytes / 1048576.0 << " MB en " << setprecision(2) << segundos << " s ("
+		<< setprecision(1) << bytes / 1048576.0 / max(segundos, 1e-9) << " MB/s)\n";
+	return guardado ? 0 : 1;
+}
+
+
+// ======================= SERIES DE KILOMETRAJE (SUMAS POR RANGO DE DÍAS) =======================
+// Km por camion en un rango de días de la serie, con el día menor y el mayor. Los bloques con
+// serie por fila se suman desde sus enteros, sin formatear ni convertir texto; en las filas
+// ascendentes (las capturadas con el método de inserción) el menor y el mayor del rango son
+// sus extremos y no se recorren. Las filas del CSV sin compactar se convierten una por una.
+
+struct SerieCamion {
+	uint64_t registros = 0;
+	uint64_t dias = 0;
+	Centavos km = 0;               // En centésimas de km
+	Centavos minimo = 0, maximo = 0;
+};
+
+struct ResultadoSeries {
+	unordered_map<string, SerieCamion> camiones;
+	uint64_t filasCodificadas = 0; // Sumadas desde la serie por fila
+	uint64_t filasTexto = 0;       // Convertidas desde texto
+	uint64_t bytes = 0;
+};
+
+// Agrega los días [desde, hasta) de una serie (índices base 0, ya recortados a su largo)
+inline void acumularSerie(SerieCamion& a, const int64_t* valores, size_t desde, size_t hasta, bool ascendente) {
+	++a.registros;
+	if (desde >= hasta) return;
+	Centavos minimo = valores[desde], maximo = valores[hasta - 1];
+	if (!ascendente) {
+		auto extremos = minmax_element(valores + desde, valores + hasta);
+		minimo = *extremos.first;
+		maximo = *extremos.second;
+	}
+	if (a.dias == 0 || minimo < a.minimo) a.minimo = minimo;
+	if (a.dias == 0 || maximo > a.maximo) a.maximo = maximo;
+	a.dias += hasta - desde;
+	a.km += sumaCentavos(valores + desde, hasta - desde);
+}
+
+/**
+ * @brief Km por camion de los días [diaDesde, diaHasta] (base 1) de cada registro de
+ * kilometraje; con 'camion' no vacío solo ese camion (y solo los bloques que lo pueden tener).
+ */
+ResultadoSeries sumarSeriesKm(size_t diaDesde, size_t diaHasta, const string& camion) {
+	MEDIR_OPERACION(SeriesKm);
+	ResultadoSeries resultado;
+	const string& ruta = NOMBRE_ARCHIVO_KM;
+	const string rutaBloq = rutaBloques(ruta);
+	CandadoArchivo candado = abrirLectura(ruta);
+	string clave; // Se reutiliza: buscar una clave existente no asigna memoria
+	vector<int64_t> valores;
+	auto acumular = [&](string_view camionFila, const int64_t* serie, size_t largo, bool ascendente) {
+		clave.assign(camionFila);
+		acumularSerie(resultado.camiones[clave], serie, min(largo, diaDesde - 1), min(largo, diaHasta), ascendente);
+	};
+	// Fila en texto: las columnas [inicio, n - 1) son la serie y la última el Total
+	auto filaTexto = [&](const string_view* campos, size_t n, size_t inicio) {
+		if (n == 0 || (!camion.empty() && campos[0] != camion)) return;
+		valores.clear();
+		for (size_t k = inicio; k + 1 < n; ++k) {
+			Centavos v = 0;
+			if (!convertirCentavos(campos[k], v)) { CONTAR_METRICA(ErroresParseo, 1); return; }
+			valores.push_back(v);
+		}
+		acumular(campos[0], valores.data(), valores.size(), false);
+		++resultado.filasTexto;
+	};
+
+	if (tamanoArchivo(rutaBloq) > 0) {
+		ArchivoBloques bloques;
+		string error;
+		if (!bloques.abrir(rutaBloq, error)) {
+			cout << "!!! ERROR: '" << rutaBloq << "': " << error << ". Se omiten sus filas.\n";
+		}
+		else {
+			vector<string_view> encabezado;
+			string_view resto = bloques.encabezado(), campo;
+			while (siguienteCampoCSV(resto, campo)) encabezado.push_back(campo);
+			const size_t inicio = mapearColumnas<KilometrajeRecord>(encabezado).inicioSerie;
+			auto incluir = [&](size_t b) {
+				const EntradaIndiceBloque& e = bloques.indice()[b];
+				return camion.empty() || (e.minimo <= camion && camion <= e.maximo);
+			};
+			resultado.bytes += decodificarBloques(bloques, hilosBloques(), incluir, [&](const BloqueLeido& b) {
+				if (!b.valido) {
+					cout << "[ADVERTENCIA] El bloque " << b.numero << " de '" << rutaBloq << "' esta danado; se omiten sus filas.\n";
+					return;
+				}
+				const BloqueDecodificado& d = *b.datos;
+				for (size_t f = 0; f < d.filas(); ++f) {
+					const string_view* campos = d.campos.data() + d.inicioFila[f];
+					if (d.inicioSerie == 0) { filaTexto(campos, d.inicioFila[f + 1] - d.inicioFila[f], inicio); continue; }
+					if (!camion.empty() && campos[0] != camion) continue;
+					acumular(campos[0], d.serie.data() + d.inicioFilaSerie[f], d.inicioFilaSerie[f + 1] - d.inicioFilaSerie[f], d.serieAscendente);
+					++resultado.filasCodificadas;
+				}
+			}, false);
+		}
+	}
+
+	LectorCSV lector(ruta);
+	const char* error = nullptr;
+	if (lector.siguiente(error)) {
+		const size_t inicio = mapearColumnas<KilometrajeRecord>(lector.campos()).inicioSerie;
+		while (lector.siguiente(error)) {
+			if (error) { CONTAR_METRICA(ErroresParseo, 1); continue; }
+			filaTexto(lector.campos().data(), lector.campos().size(), inicio);
+		}
+	}
+	resultado.bytes += lector.bytesLeidos();
+	return resultado;
+}
+
+// Modo de linea de comandos: Proyecto7.0 --series [--dias <desde> <hasta>] [--camion <id>] [--max <n>]
+int ejecutarSeries(int argc, char* argv[]) {
+	size_t desde = 1, hasta = SIZE_MAX, limite = 10;
+	string camion;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--dias" && i + 2 < argc) {
+			desde = strtoull(argv[i + 1], nullptr, 10);
+			hasta = strtoull(argv[i + 2], nullptr, 10);
+			i += 2;
+		}
+		else if (arg == "--camion" && i + 1 < argc) camion = argv[++i];
+		else if (arg == "--max" && i + 1 < argc) limite = strtoull(argv[++i], nullptr, 10);
+		else {
+			cout << "Uso: Proyecto7.0 --series [--dias <desde> <hasta>] [--camion <id>] [--max <n>]\n";
+			return 1;
+		}
+	}
+	if (desde == 0 || hasta < desde) {
+		cout << "!!! ERROR: El rango de dias debe empezar en 1 y no puede ir al reves.\n";
+		return 1;
+	}
+
+	auto inicio = chrono::steady_clock::now();
+	ResultadoSeries r = sumarSeriesKm(desde, hasta, camion);
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+	vector<pair<string, SerieCamion>> filas(r.camiones.begin(), r.camiones.end());
+	sort(filas.begin(), filas.end(), [](const pair<string, SerieCamion>& a, const pair<string, SerieCamion>& b) {
+		return a.second.km != b.second.km ? a.second.km > b.second.km : a.first < b.first;
+	});
+	cout << "\n======= KILOMETRAJE POR CAMION (DIAS " << desde << " A ";
+	if (hasta == SIZE_MAX) cout << "ULTIMO"; else cout << hasta;
+	cout << ", MAS KM PRIMERO) =======\n";
+	cout << left << setw(10) << "CAMION" << right << setw(11) << "REGISTROS" << setw(10) << "DIAS" << setw(16) << "KM"
+		<< setw(12) << "KM/DIA" << setw(12) << "DIA MENOR" << setw(12) << "DIA MAYOR" << "\n";
+	SerieCamion total;
+	for (size_t i = 0; i < filas.size(); ++i) {
+		const SerieCamion& s = filas[i].second;
+		if (i < limite) {
+			cout << left << setw(10) << filas[i].first << right << setw(11) << s.registros << setw(10) << s.dias << setw(16) << Monto{ s.km }
+				<< setw(12) << Monto{ s.dias ? s.km / static_cast<Centavos>(s.dias) : 0 } << setw(12) << Monto{ s.minimo } << setw(12) << Monto{ s.maximo } << "\n";
+		}
+		if (s.dias && (total.dias == 0 || s.minimo < total.minimo)) total.minimo = s.minimo;
+		if (s.dias && (total.dias == 0 || s.maximo > total.maximo)) total.maximo = s.maximo;
+		total.registros += s.registros;
+		total.dias += s.dias;
+		total.km += s.km;
+	}
+	if (filas.size() > limite) cout << "... (" << (filas.size() - limite) << " camiones mas)\n";
+	cout << left << setw(10) << "TOTAL" << right << setw(11) << total.registros << setw(10) << total.dias << setw(16) << Monto{ total.km }
+		<< setw(12) << Monto{ total.dias ? total.km / static_cast<Centavos>(total.dias) : 0 } << setw(12) << Monto{ total.minimo }
+		<< setw(12) << Monto{ total.maximo } << "\n";
+	cout << (r.filasCodificadas + r.filasTexto) << " registros (" << r.filasCodificadas << " desde la serie codificada, " << r.filasTexto
+		<< " desde texto) en " << fixed << setprecision(3) << segundos << " s (" << setprecision(1)
+		<< r.bytes / 1048576.0 / max(segundos, 1e-9) << " MB/s)\n";
+	return 0;
+}
+
+
+// ======================= EXPORTACIÓN COLUMNAR (ARROW IPC) =======================
+// Exporta las tablas de ingresos, taller y kilometraje a archivos Arrow IPC ('.arrow',
+// el formato de archivo de Apache Arrow / Feather v2) que pandas, pyarrow, DuckDB o Polars
+// leen sin parsear texto. Columnas tipadas: los textos como utf8, la serie de cada fila como
+// lista (list<decimal128(18,2)> para dinero, list<double> para km) y el Total del mismo tipo.
+// La tabla se recorre una vez (bloques y CSV) y se corta en lotes de FILAS_POR_LOTE_ARROW
+// filas; cada tanda de lotes se codifica en paralelo y se escribe en orden, así que la
+// memoria depende del tamaño del lote y no del de la tabla.
+
+const size_t FILAS_POR_LOTE_ARROW = 65536;
+const char MAGIA_ARROW[8] = { 'A', 'R', 'R', 'O', 'W', '1', 0, 0 };
+
+// ---------------------- FLATBUFFERS MÍNIMO ----------------------
+// Los metadatos de Arrow (esquema, lotes y pie) son FlatBuffers. Este constructor escribe
+// de adelante hacia atrás del archivo: cada tabla antes de lo que referencia (los
+// desplazamientos de FlatBuffers solo apuntan hacia adelante) y su vtable justo antes de ella.
+
+class ConstructorFlatbuffer {
+public:
+	using Hijo = function<size_t(ConstructorFlatbuffer&)>;
+
+	// Campos de una tabla: escalares o referencias a lo que 'hijo' escriba después
+	struct Tabla {
+		struct Campo {
+			uint16_t id;
+			size_t tam;
+			char bytes[8];
+			Hijo hijo;
+		};
+		vector<Campo> campos;
+
+		template<typename V>
+		Tabla& escalar(uint16_t id, V valor) {
+			Campo c{ id, sizeof(V), {}, nullptr };
+			memcpy(c.bytes, &valor, sizeof(V));
+			campos.push_back(move(c));
+			return *this;
+		}
+		Tabla& referencia(uint16_t id, Hijo hijo) {
+			campos.push_back(Campo{ id, 4, {}, move(hijo) });
+			return *this;
+		}
+	};
+
+private:
+	string buf;
+
+	void alinear(size_t a) { buf.append((a - buf.size() % a) % a, '\0'); }
+	template<typename V>
+	void agregar(V valor) { buf.append(reinterpret_cast<const char*>(&valor), sizeof(V)); }
+	template<typename V>
+	void poner(size_t pos, V valor) { memcpy(&buf[pos], &valor, sizeof(V)); }
+	void enlazar(size_t campo, size_t destino) { poner(campo, static_cast<uint32_t>(destino - campo)); }
+
+public:
+	size_t tabla(const Tabla& t) {
+		// Los campos van de mayor a menor tamaño: cada uno queda alineado sin relleno extra
+		vector<const Tabla::Campo*> orden;
+		uint16_t numIds = 0;
+		for (const auto& c : t.campos) {
+			orden.push_back(&c);
+			numIds = max<uint16_t>(numIds, static_cast<uint16_t>(c.id + 1));
+		}
+		stable_sort(orden.begin(), orden.end(), [](const Tabla::Campo* a, const Tabla::Campo* b) { return a->tam > b->tam; });
+		vector<uint16_t> posiciones(numIds, 0);
+		size_t fin = 4;                  // Primero va el desplazamiento a la vtable
+		for (const auto* c : orden) {
+			fin = (fin + c->tam - 1) / c->tam * c->tam;
+			posiciones[c->id] = static_cast<uint16_t>(fin);
+			fin += c->tam;
+		}
+
+		alinear(2);
+		const size_t vtable = buf.size();
+		agregar(static_cast<uint16_t>(4 + 2 * numIds));
+		agregar(static_cast<uint16_t>(fin));
+		for (uint16_t p : posiciones) agregar(p);
+		alinear(8);
+		const size_t inicio = buf.size();
+		buf.append(fin, '\0');
+		poner(inicio, static_cast<int32_t>(inicio - vtable));
+		for (const auto* c : orden) memcpy(&buf[inicio + posiciones[c->id]], c->bytes, c->hijo ? 0 : c->tam);
+		for (const auto& c : t.campos) {
+			if (c.hijo) enlazar(inicio + posiciones[c.id], c.hijo(*this));
+		}
+		return inicio;
+	}
+
+	size_t texto(string_view s) {
+		alinear(4);
+		const size_t inicio = buf.size();
+		agregar(static_cast<uint32_t>(s.size()));
+		buf.append(s);
+		buf += '\0';
+		return inicio;
+	}
+
+	size_t vectorTablas(const vector<Tabla>& tablas) {
+		alinear(4);
+		const size_t inicio = buf.size();
+		agregar(static_cast<uint32_t>(tablas.size()));
+		const size_t elementos = buf.size();
+		buf.append(4 * tablas.size(), '\0');
+		for (size_t i = 0; i < tablas.size(); ++i) enlazar(elementos + 4 * i, tabla(tablas[i]));
+		return inicio;
+	}
+
+	// Vector de structs de 8 bytes de alineación ('bytes' ya con el formato de cada struct)
+	size_t vectorStructs(string_view bytes, size_t n) {
+		buf.append((8 - (buf.size() + 4) % 8) % 8, '\0');
+		const size_t inicio = buf.size();
+		agregar(static_cast<uint32_t>(n));
+		buf.append(bytes);
+		return inicio;
+	}
+
+	// Buffer completo con 'raiz' como tabla raíz (largo múltiplo de 8)
+	string terminar(const Tabla& raiz) {
+		buf.assign(4, '\0');
+		poner(0, static_cast<uint32_t>(tabla(raiz)));
+		alinear(8);
+		return move(buf);
+	}
+};
+
+// ---------------------- ESQUEMA Y MENSAJES ARROW ----------------------
+// Identificadores del formato (Schema.fbs y Message.fbs de Arrow)
+const int16_t ARROW_METADATOS_V5 = 4;
+const uint8_t ARROW_MENSAJE_ESQUEMA = 1, ARROW_MENSAJE_LOTE = 3;
+const uint8_t ARROW_TIPO_DOBLE = 3, ARROW_TIPO_UTF8 = 5, ARROW_TIPO_DECIMAL = 7, ARROW_TIPO_LISTA = 12;
+
+using TablaFB = ConstructorFlatbuffer::Tabla;
+
+// Field { name, nullable, type, children }: ninguna columna exportada tiene nulos
+TablaFB campoArrow(const string& nombre, uint8_t tipo, TablaFB tablaTipo, vector<TablaFB> hijos = {}) {
+	TablaFB campo;
+	campo.referencia(0, [nombre](ConstructorFlatbuffer& fb) { return fb.texto(nombre); })
+		.escalar<uint8_t>(1, 0)
+		.escalar<uint8_t>(2, tipo)
+		.referencia(3, [tablaTipo](ConstructorFlatbuffer& fb) { return fb.tabla(tablaTipo); })
+		.referencia(5, [hijos](ConstructorFlatbuffer& fb) { return fb.vectorTablas(hijos); });
+	return campo;
+}
+
+// Campo de un valor de la serie: decimal128(18,2) para centavos, double para km
+inline TablaFB campoValorArrow(const string& nombre, Centavos) {
+	TablaFB decimal;
+	decimal.escalar<int32_t>(0, 18).escalar<int32_t>(1, 2).escalar<int32_t>(2, 128);
+	return campoArrow(nombre, ARROW_TIPO_DECIMAL, decimal);
+}
+inline TablaFB campoValorArrow(const string& nombre, double) {
+	TablaFB doble;
+	doble.escalar<int16_t>(0, 2);   // Precision::DOUBLE
+	return campoArrow(nombre, ARROW_TIPO_DOBLE, doble);
+}
+
+// Columnas: los campos de texto del esquema, la serie como lista y el Total
+template<typename T>
+TablaFB esquemaArrow() {
+	using E = EsquemaRegistro<T>;
+	using V = typename E::Valor;
+	vector<TablaFB> campos;
+	for (const auto& c : E::camposTexto) campos.push_back(campoArrow(c.columna, ARROW_TIPO_UTF8, TablaFB{}));
+	string nombreSerie = E::columnaSerie;
+	if (!nombreSerie.empty() && nombreSerie.back() == '_') nombreSerie.pop_back();
+	campos.push_back(campoArrow(nombreSerie, ARROW_TIPO_LISTA, TablaFB{}, { campoValorArrow("item", V{}) }));
+	campos.push_back(campoValorArrow("Total", V{}));
+	TablaFB esquema;
+	esquema.escalar<int16_t>(0, 0)  // Little endian
+		.referencia(1, [campos](ConstructorFlatbuffer& fb) { return fb.vectorTablas(campos); });
+	return esquema;
+}
 
-	cout << "\n[REGISTRO EXITOSO] Camion: " << registroSalida.numeroCamion
-		<< " - Salida registrada a las: " << registroSalida.hora << endl;
-	cout << "Camiones actualmente en patio: " << camionesEnPatio.size() << " de " << MAX_CAMIONES << endl;
+string mensajeArrow(uint8_t tipo, const TablaFB& cabecera, uint64_t bytesCuerpo) {
+	TablaFB mensaje;
+	mensaje.escalar<int16_t>(0, ARROW_METADATOS_V5)
+		.escalar<uint8_t>(1, tipo)
+		.referencia(2, [cabecera](ConstructorFlatbuffer& fb) { return fb.tabla(cabecera); })
+		.escalar<int64_t>(3, static_cast<int64_t>(bytesCuerpo));
+	return ConstructorFlatbuffer().terminar(mensaje);
 }
-void mostrarRegistrosTaller(const vector<TallerRecord>& registros) {
-	cout << "\n======= DATOS ACTUALES DE COSTOS DE TALLER (" << registros.size() << " Registros) =======\n";
-	if (registros.empty()) { cout << "No hay registros guardados para mostrar." << endl; return; }
 
-	// Obtener el máximo de visitas para los encabezados
-	size_t maxVisitas = 0;
-	for (const auto& r : registros) {
-		if (r.costos.size() > maxVisitas) maxVisitas = r.costos.size();
+// Un lote codificado: cuerpo con los buffers de todas las columnas y su descripción
+struct LoteArrow {
+	uint64_t filas = 0;
+	string cuerpo;
+	string nodos;       // FieldNode { length, null_count } por columna (en preorden)
+	string buffers;     // Buffer { offset, length } por buffer
+	size_t numNodos = 0, numBuffers = 0;
+
+	void nodo(uint64_t largo) {
+		int64_t datos[2] = { static_cast<int64_t>(largo), 0 };
+		nodos.append(reinterpret_cast<const char*>(datos), sizeof(datos));
+		++numNodos;
 	}
-
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
-	cout << "| " << left << setw(10) << "CAMION"
-		<< "| " << left << setw(15) << "ENCARGADO"
-		<< "| " << left << setw(15) << "TALLER";
-	for (size_t i = 0; i < maxVisitas; ++i) {
-		cout << "| " << right << setw(7) << "Costo " << (i + 1);
+	void buffer(const void* datos, size_t bytes) {
+		int64_t desc[2] = { static_cast<int64_t>(cuerpo.size()), static_cast<int64_t>(bytes) };
+		buffers.append(reinterpret_cast<const char*>(desc), sizeof(desc));
+		++numBuffers;
+		cuerpo.append(static_cast<const char*>(datos), bytes);
+		cuerpo.append((8 - cuerpo.size() % 8) % 8, '\0');
 	}
-	cout << "| " << right << setw(10) << "TOTAL" << " |\n";
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
+	void sinNulos() { buffer(nullptr, 0); } // Mapa de validez vacío: todos los valores presentes
+
+	string metadatos() const {
+		TablaFB lote;
+		string n = nodos, b = buffers;
+		size_t cuantosNodos = numNodos, cuantosBuffers = numBuffers;
+		lote.escalar<int64_t>(0, static_cast<int64_t>(filas))
+			.referencia(1, [n, cuantosNodos](ConstructorFlatbuffer& fb) { return fb.vectorStructs(n, cuantosNodos); })
+			.referencia(2, [b, cuantosBuffers](ConstructorFlatbuffer& fb) { return fb.vectorStructs(b, cuantosBuffers); });
+		return mensajeArrow(ARROW_MENSAJE_LOTE, lote, cuerpo.size());
+	}
+};
 
-	cout << fixed << setprecision(2);
-	for (const auto& record : registros) {
-		cout << "| " << left << setw(10) << record.camion
-			<< "| " << left << setw(15) << record.encargado
-			<< "| " << left << setw(15) << record.taller;
+inline void agregarValorArrow(string& destino, Centavos v) {
+	int64_t decimal[2] = { v, v < 0 ? -1 : 0 }; // decimal128 en complemento a dos, little endian
+	destino.append(reinterpret_cast<const char*>(decimal), sizeof(decimal));
+}
+inline void agregarValorArrow(string& destino, double v) { destino.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
 
-		for (size_t i = 0; i < maxVisitas; ++i) {
-			if (i < record.costos.size()) {
-				cout << "| " << right << setw(7) << record.costos[i];
-			}
-			else {
-				cout << "| " << right << setw(7) << "-";
-			}
+template<typename T>
+void codificarLoteArrow(const vector<T>& registros, LoteArrow& lote) {
+	using E = EsquemaRegistro<T>;
+	lote = LoteArrow{};
+	lote.filas = registros.size();
+	vector<int32_t> desplazamientos;
+	string datos;
+	for (const auto& c : E::camposTexto) {
+		desplazamientos.assign(1, 0);
+		datos.clear();
+		for (const T& r : registros) {
+			datos += r.*c.miembro;
+			desplazamientos.push_back(static_cast<int32_t>(datos.size()));
 		}
-		cout << "| " << right << setw(10) << record.total << " |" << endl;
+		lote.nodo(registros.size());
+		lote.sinNulos();
+		lote.buffer(desplazamientos.data(), desplazamientos.size() * sizeof(int32_t));
+		lote.buffer(datos.data(), datos.size());
 	}
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
-}
 
-void mostrarRegistrosEnTabla() {
-	ifstream archivo("registro_camiones_pila.csv");
-	if (!archivo.is_open()) {
-		cout << "Aun no hay registros de movimientos de camiones guardados en el archivo CSV." << endl;
-		return;
+	desplazamientos.assign(1, 0);
+	datos.clear();
+	for (const T& r : registros) {
+		for (const auto& v : r.*E::serie) agregarValorArrow(datos, v);
+		desplazamientos.push_back(desplazamientos.back() + static_cast<int32_t>((r.*E::serie).size()));
 	}
+	lote.nodo(registros.size());
+	lote.sinNulos();
+	lote.buffer(desplazamientos.data(), desplazamientos.size() * sizeof(int32_t));
+	lote.nodo(static_cast<uint64_t>(desplazamientos.back()));
+	lote.sinNulos();
+	lote.buffer(datos.data(), datos.size());
+
+	datos.clear();
+	for (const T& r : registros) agregarValorArrow(datos, r.total);
+	lote.nodo(registros.size());
+	lote.sinNulos();
+	lote.buffer(datos.data(), datos.size());
+}
 
-	cout << "\n======== HISTORIAL DE MOVIMIENTOS DE CAMIONES (TABLA) ========\n";
-	cout << "----------------------------------------------------------------------------------" << endl;
-	cout << "| " << left << setw(20) << "FECHA Y HORA"
-		<< "| " << left << setw(10) << "CAMION"
-		<< "| " << left << setw(20) << "CONDUCTOR"
-		<< "| " << left << setw(12) << "MOVIMIENTO" << "|" << endl;
-	cout << "----------------------------------------------------------------------------------" << endl;
+struct ResultadoExportacion {
+	uint64_t filas = 0;
+	uint64_t rechazadas = 0;
+	size_t lotes = 0;
+	uint64_t bytes = 0;
+};
 
-	string linea;
-	// Ignorar la línea de encabezados
-	getline(archivo, linea);
-
-	while (getline(archivo, linea)) {
-		// En un entorno de producción se usaría un parser de CSV más robusto o stringstream
-		size_t pos1 = linea.find(',');
-		string hora = linea.substr(0, pos1);
-		size_t pos2 = linea.find(',', pos1 + 1);
-		string camion = linea.substr(pos1 + 1, pos2 - pos1 - 1);
-		size_t pos3 = linea.find(',', pos2 + 1);
-		string conductor = linea.substr(pos2 + 1, pos3 - pos2 - 1);
-		string movimiento = linea.substr(pos3 + 1);
-
-		cout << "| " << left << setw(20) << hora
-			<< "| " << left << setw(10) << camion
-			<< "| " << left << setw(20) << conductor
-			<< "| " << left << setw(12) << movimiento << "|" << endl;
+/**
+ * @brief Escribe la tabla completa (bloques y CSV) en 'rutaSalida' como archivo Arrow IPC.
+ * Se escribe a un temporal y se renombra al terminar.
+ */
+template<typename T>
+bool exportarArrow(const string& rutaSalida, size_t hilos, size_t filasPorLote, ResultadoExportacion& resultado, string& error) {
+	const string temporal = rutaTemporal(rutaSalida);
+	ofstream out(temporal, ios::binary | ios::trunc);
+	if (!out) { error = "no se pudo crear '" + temporal + "'"; return false; }
+
+	string bloques;          // Block { offset, metaDataLength, bodyLength } de cada lote para el pie
+	auto escribirMensaje = [&](const string& metadatos, const string& cuerpo) {
+		int64_t desplazamiento = static_cast<int64_t>(out.tellp());
+		uint32_t continuacion = 0xFFFFFFFFu;
+		int32_t largo = static_cast<int32_t>(metadatos.size());
+		out.write(reinterpret_cast<const char*>(&continuacion), 4);
+		out.write(reinterpret_cast<const char*>(&largo), 4);
+		out.write(metadatos.data(), static_cast<streamsize>(metadatos.size()));
+		out.write(cuerpo.data(), static_cast<streamsize>(cuerpo.size()));
+		struct { int64_t desplazamiento; int32_t metadatos; int32_t relleno; int64_t cuerpo; } bloque{
+			desplazamiento, 8 + largo, 0, static_cast<int64_t>(cuerpo.size()) };
+		return string(reinterpret_cast<const char*>(&bloque), sizeof(bloque));
+	};
+
+	const TablaFB esquema = esquemaArrow<T>();
+	out.write(MAGIA_ARROW, sizeof(MAGIA_ARROW));
+	escribirMensaje(mensajeArrow(ARROW_MENSAJE_ESQUEMA, esquema, 0), string());
+
+	// Tanda: hasta 'hilos' lotes llenos que se codifican a la vez y se escriben en orden
+	hilos = max<size_t>(1, hilos);
+	vector<vector<T>> tanda(1);
+	vector<LoteArrow> codificados(hilos);
+	auto vaciarTanda = [&]() {
+		if (tanda.back().empty()) tanda.pop_back();
+		vector<thread> trabajadores;
+		for (size_t i = 1; i < tanda.size(); ++i) trabajadores.emplace_back([&, i]() { codificarLoteArrow(tanda[i], codificados[i]); });
+		if (!tanda.empty()) codificarLoteArrow(tanda[0], codificados[0]);
+		for (auto& h : trabajadores) h.join();
+		for (size_t i = 0; i < tanda.size(); ++i) {
+			bloques += escribirMensaje(codificados[i].metadatos(), codificados[i].cuerpo);
+			++resultado.lotes;
+		}
+		tanda.assign(1, vector<T>());
+		tanda.back().reserve(filasPorLote);
+	};
+	tanda.back().reserve(filasPorLote);
+	vector<FilaRechazada> rechazos;
+	resultado.filas = recorrerCSV<T>(EsquemaRegistro<T>::archivo, [&](T& record, size_t) {
+		tanda.back().push_back(move(record));
+		if (tanda.back().size() < filasPorLote) return;
+		if (tanda.size() == hilos) vaciarTanda();
+		else { tanda.emplace_back(); tanda.back().reserve(filasPorLote); }
+	}, &rechazos);
+	vaciarTanda();
+	resultado.rechazadas = rechazos.size();
+
+	// Fin del flujo y pie del archivo (esquema otra vez y la ubicación de cada lote)
+	const uint32_t finFlujo[2] = { 0xFFFFFFFFu, 0 };
+	out.write(reinterpret_cast<const char*>(finFlujo), sizeof(finFlujo));
+	TablaFB pie;
+	size_t numLotes = resultado.lotes;
+	pie.escalar<int16_t>(0, ARROW_METADATOS_V5)
+		.referencia(1, [esquema](ConstructorFlatbuffer& fb) { return fb.tabla(esquema); })
+		.referencia(2, [](ConstructorFlatbuffer& fb) { return fb.vectorStructs(string_view(), 0); })
+		.referencia(3, [bloques, numLotes](ConstructorFlatbuffer& fb) { return fb.vectorStructs(bloques, numLotes); });
+	const string piefb = ConstructorFlatbuffer().terminar(pie);
+	const int32_t largoPie = static_cast<int32_t>(piefb.size());
+	out.write(piefb.data(), static_cast<streamsize>(piefb.size()));
+	out.write(reinterpret_cast<const char*>(&largoPie), sizeof(largoPie));
+	out.write(MAGIA_ARROW, 6);
+	out.flush();
+	resultado.bytes = static_cast<uint64_t>(out.tellp());
+	if (!out) { error = "no se pudo escribir '" + temporal + "'"; out.close(); remove(temporal.c_str()); return false; }
+	out.close();
+	CONTAR_METRICA(BytesEscritos, resultado.bytes);
+
+	error_code ec;
+	filesystem::rename(temporal, rutaSalida, ec);
+	if (ec) { error = ec.message(); filesystem::remove(temporal, ec); return false; }
+	return true;
+}
+
+// Modo de linea de comandos: Proyecto7.0 --exportar [ingresos|taller|km ...] [--salida <dir>] [--filas-lote <n>] [--hilos <n>]
+int ejecutarExportacion(int argc, char* argv[]) {
+	vector<string> tablas;
+	string directorio = ".";
+	size_t filasPorLote = FILAS_POR_LOTE_ARROW;
+	size_t hilos = hilosBloques();
+	const char* uso = "Uso: Proyecto7.0 --exportar [ingresos|taller|km ...] [--salida <dir>] [--filas-lote <n>] [--hilos <n>]\n";
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--salida" && tieneValor) directorio = argv[++i];
+		else if (arg == "--filas-lote" && tieneValor) filasPorLote = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (arg == "--hilos" && tieneValor) hilos = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (arg.rfind("--", 0) != 0) tablas.push_back(rutaTablaHistorica(arg));
+		else { cout << uso; return 1; }
 	}
-	cout << "----------------------------------------------------------------------------------" << endl;
-	archivo.close();
+	if (tablas.empty()) tablas = { NOMBRE_ARCHIVO_INGRESOS, NOMBRE_ARCHIVO_TALLER, NOMBRE_ARCHIVO_KM };
+	error_code ec;
+	filesystem::create_directories(directorio, ec);
+
+	int codigo = 0;
+	for (const string& ruta : tablas) {
+		const string salida = (filesystem::path(directorio) / filesystem::path(ruta).stem()).string() + ".arrow";
+		ResultadoExportacion r;
+		string error;
+		auto inicio = chrono::steady_clock::now();
+		bool exito = ruta == NOMBRE_ARCHIVO_INGRESOS ? exportarArrow<IngresoRecord>(salida, hilos, filasPorLote, r, error)
+			: ruta == NOMBRE_ARCHIVO_TALLER ? exportarArrow<TallerRecord>(salida, hilos, filasPorLote, r, error)
+			: ruta == NOMBRE_ARCHIVO_KM ? exportarArrow<KilometrajeRecord>(salida, hilos, filasPorLote, r, error)
+			: (error = "solo se exportan ingresos, taller y km", false);
+		if (!exito) {
+			cout << "!!! ERROR: '" << ruta << "': " << error << "\n";
+			codigo = 1;
+			continue;
+		}
+		double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		uint64_t origen = tamanoArchivo(ruta) + tamanoArchivo(rutaBloques(ruta));
+		cout << "[EXPORTADO] " << ruta << " -> " << salida << ": " << r.filas << " filas en " << r.lotes << " lotes, "
+			<< fixed << setprecision(1) << r.bytes / 1048576.0 << " MB en " << setprecision(2) << segundos << " s ("
+			<< setprecision(1) << origen / 1048576.0 / max(segundos, 1e-9) << " MB/s leidos)\n";
+		if (r.rechazadas) cout << "[ADVERTENCIA] " << r.rechazadas << " filas mal formadas no se exportaron (vealas con --validar).\n";
+	}
+	return codigo;
 }
 
-void menuCamionesPila() {
+
+// ======================= MENÚ PRINCIPAL Y ORDENAMIENTO =======================
+
+void menuOrdenamientoYLista() {
+	// El CRUD y los reportes actualizan estos acumulados: desde aquí solo los toca este hilo
+	reclamarModulo(Modulo::Ingresos);
+	reclamarModulo(Modulo::Taller);
+	reclamarModulo(Modulo::Kilometraje);
 	int opcion = 0;
-	while (opcion != 4) {
+	while (opcion != 5) {
 		// system("cls"); // Descomentar para limpiar
-		cout << "\n======== REGISTRO DE CAMIONES (PILA: Max " << MAX_CAMIONES << ") ========" << endl;
-		cout << "Camiones actualmente en patio: " << camionesEnPatio.size() << " de " << MAX_CAMIONES << endl;
-		cout << "-----------------------------------------------------------------" << endl;
-		cout << "1. Registrar ENTRADA de camion (PUSH)" << endl;
-		cout << "2. Registrar SALIDA de camion (POP)" << endl;
-		cout << "3. Mostrar Historial de Registros (Tabla)" << endl;
-		cout << "4. Regresar al menu principal" << endl;
+		cout << "\n======== METODOS DE ORDENAMIENTO Y MANIPULACION DE LISTAS ========\n";
+		cout << "1. Metodo Burbuja (Ingresos) - C/ Menu de Listas Completo" << endl;
+		cout << "2. Metodo Seleccion (Costos de Taller) - C/ Menu de Listas Completo" << endl;
+		cout << "3. Metodo Insercion (Kilometraje) - C/ Menu de Listas Completo" << endl;
+		cout << "4. Reportes cruzados (ingreso/km, costo/km y margen)" << endl;
+		cout << "5. Regresar al menu principal" << endl;
 		cout << "Seleccione una opcion: ";
 		cin >> opcion;
 		limpiarBuffer();
@@ -321,18 +6208,18 @@ void menuCamionesPila() {
 
 		switch (opcion) {
 		case 1:
-			registrarEntrada();
-			limpiarPantalla();
+			metodoBurbuja();
 			break;
 		case 2:
-			registrarSalida();
-			limpiarPantalla();
+			metodoSeleccion();
 			break;
 		case 3:
-			mostrarRegistrosEnTabla();
-			limpiarPantalla();
+			metodoInsercion();
 			break;
 		case 4:
+			menuReportes();
+			break;
+		case 5:
 			cout << "Regresando al menu principal..." << endl;
 			break;
 		default:
@@ -344,458 +6231,734 @@ void menuCamionesPila() {
 }
 
 
-// ======================= IMPLEMENTACIÓN CON ESTRUCTURAS =======================
-
-// Función que reemplaza a nomEmpresa(), nomAuditor(), etc.
-int aniosTrabajando(const DatosEmpresa& datos) {
-	return 2025 - datos.anioInicio;
-}
-
-// Función que utiliza la nueva estructura DatosEmpresa
-void mostrarEmpresa(DatosEmpresa& datos) {
-	// Pedir año de inicio del desarrollador (aunque el código original pedía "contratación del desarrollador")
-	cout << "Ingrese el anio de inicio de operaciones de la empresa: ";
-	cin >> datos.anioInicio;
-	limpiarBuffer();
-
-	cout << "\n======= DATOS DE LA EMPRESA =======" << endl;
-	cout << "Empresa: " << datos.nombre << endl;
-	cout << "Auditor: " << datos.auditor << endl;
-	cout << "Especialista 1: " << datos.especialista1 << endl;
-	cout << "Especialista 2: " << datos.especialista2 << endl;
-	// Se utiliza la función y el campo anioInicio de la estructura
-	cout << "Anios trabajando (desde " << datos.anioInicio << "): "
-		<< aniosTrabajando(datos) << endl;
-	cout << "Slogan: " << datos.slogan << endl;
-}
-
-// Función que utiliza la nueva estructura Chofer
-void mostrarChofer(const Chofer& chofer) {
-	cout << "\n--- DATOS DEL CHOFER ---" << endl;
-	cout << "Nombre: " << chofer.nombre << endl;
-	cout << "ID de chofer: " << chofer.id << endl;
-	cout << "Edad: " << chofer.edad << " anios" << endl;
-	cout << "Telefono: " << chofer.telefono << endl;
-	cout << "Codigo Postal: " << chofer.codigoPostal << endl;
-}
-
-// Función que utiliza la nueva estructura UnidadTransporte
-void mostrarUnidad(const UnidadTransporte& unidad) {
-	cout << "\n--- DATOS DE UNIDAD DE TRANSPORTE ---" << endl;
-	cout << "ID de camion: " << unidad.idCamion << endl;
-	cout << "Placas: " << unidad.placas << endl;
-	cout << "Color: " << unidad.color << endl;
-	cout << "Anio: " << unidad.anio << endl;
-	cout << "Chofer: " << unidad.choferAsignado << endl;
-	cout << "Anios en la empresa: " << unidad.aniosEnEmpresa << endl;
-}
 
-// ======================= SUBMENU 5: RECURSIVIDAD (Cálculo de Sueldo) =======================
+// ======================= MOTOR DE VENTAS DE BOLETOS =======================
+// Libro de ventas append-only (ventas_boletos.csv), tabla de descuentos que se carga al
+// iniciar (descuentos_boletos.csv) y totales por vendedor que se actualizan con cada boleto.
+// Lo usan la venta con punteros del menu 4, los lotes desde archivo o stdin y el benchmark.
 
-/**
- * @brief Función recursiva que pide sueldos del mes más reciente al más antiguo.
- * @param mesActual El índice del mes actual (comienza en totalMeses, termina en 1 - el más antiguo).
- * @param totalMeses El número total de meses a calcular (límite superior).
- * @return double El sueldo total acumulado desde el mes más antiguo hasta mesActual.
- */
-double calcularSueldoAcumuladoRecursivo(int mesActual, int totalMeses) {
-	// Nombres de meses para mostrar
-	const vector<string> meses = { "Enero", "Febrero", "Marzo", "Abril", "Mayo", "Junio",
-								   "Julio", "Agosto", "Septiembre", "Octubre", "Noviembre", "Diciembre" };
+const string NOMBRE_ARCHIVO_VENTAS = "ventas_boletos.csv";
+const string NOMBRE_ARCHIVO_DESCUENTOS = "descuentos_boletos.csv";
+const char* const ENCABEZADO_VENTAS = "Folio,Fecha_Hora,Vendedor,Tipo,Porcentaje,Subtotal,Descuento,Total";
 
-	// Cálculo para asignar un nombre de mes de forma cíclica (0 a 11)
-	int indiceMes = (mesActual - 1) % meses.size();
-	string nombreMes = meses[indiceMes];
+struct ReglaDescuento {
+	string clave;         // Lo que se escribe en el lote y en el libro: ESTUDIANTE, INAPAM, ...
+	string descripcion;
+	int64_t centesimas;   // 5000 = 50.00%
+};
 
-	double sueldoMes;
-	double sueldoAcumulado = 0.0;
+struct TotalesVendedor {
+	uint64_t boletos = 0;
+	Centavos subtotal = 0;
+	Centavos descuento = 0;
+	Centavos total = 0;
+};
 
-	// 1. Pedir el sueldo del mes (del más reciente al más antiguo)
-	cout << "Ingrese sueldo para el mes de " << nombreMes << " (Mes #" << mesActual << " de " << totalMeses << "): $";
+struct VentaBoleto {
+	uint64_t folio = 0;
+	int64_t centesimas = 0;
+	Centavos subtotal = 0;
+	Centavos descuento = 0;
+	Centavos total = 0;
+};
 
-	// Lectura de sueldo con manejo de error básico
-	if (!(cin >> sueldoMes)) {
-		cin.clear();
-		limpiarBuffer();
-		cout << "!!! Advertencia: Entrada invalida. Usando sueldo de $0.00 para este mes.\n";
-		sueldoMes = 0.0;
-	}
+struct ResultadoLoteVentas {
+	uint64_t boletos = 0;
+	uint64_t rechazados = 0;
+	Centavos total = 0;
+};
 
-	// 2. Llamada recursiva para el mes anterior
-	if (mesActual > 1) {
-		// La llamada recursiva devuelve la suma de los sueldos de los meses 1 hasta mesActual-1
-		sueldoAcumulado = calcularSueldoAcumuladoRecursivo(mesActual - 1, totalMeses);
-	}
-	else {
-		// Caso Base: mesActual == 1 (el mes más antiguo)
-		cout << "\n--- Sueldos ingresados. Mostrando resultados de mas antiguo a mas reciente ---\n";
-		sueldoAcumulado = 0.0; // La base de la acumulación es 0
+// Fecha_Hora del segundo actual; se formatea una sola vez por segundo (seguro entre hilos)
+class RelojVentas {
+	time_t segundo = -1;
+	char texto[32] = {};
+	size_t longitud = 0;
+public:
+	string_view ahora() {
+		time_t t = time(nullptr);
+		if (t != segundo) {
+			segundo = t;
+			tm local{};
+#ifdef _WIN32
+			localtime_s(&local, &t);
+#else
+			localtime_r(&t, &local);
+#endif
+			longitud = strftime(texto, sizeof(texto), "%Y-%m-%d %H:%M:%S", &local);
+		}
+		return string_view(texto, longitud);
 	}
+};
 
-	// 3. Después de regresar (desenrollando la pila): Imprimir y Acumular
-	sueldoAcumulado += sueldoMes;
-
-	// 3. (Continuación) Imprimir el sueldo y el acumulado (Orden: Antiguo -> Reciente)
-	cout << fixed << setprecision(2);
-	cout << "[Mes: " << nombreMes << " (Mes " << mesActual << ")] Sueldo: $" << setw(10) << sueldoMes
-		<< " | Acumulado: $" << setw(10) << sueldoAcumulado << endl;
-
-	// 4. Retornar el sueldo acumulado (incluyendo el mes actual)
-	return sueldoAcumulado;
+VentaBoleto calcularVenta(uint64_t folio, int64_t centesimas, Centavos subtotal) {
+	VentaBoleto venta;
+	venta.folio = folio;
+	venta.centesimas = centesimas;
+	venta.subtotal = subtotal;
+	venta.descuento = aplicarPorcentaje(subtotal, centesimas);
+	venta.total = subtotal - venta.descuento;
+	return venta;
 }
 
-void menuCalculoSueldoRecursivo() {
-	int totalMeses;
-	string nombreEmpleado = pedirTexto("Ingrese el nombre del empleado para calcular su sueldo acumulado: ");
-
-	do {
-		cout << "Ingrese el numero de meses (N) a calcular (minimo 1, maximo 12): ";
-		// Lectura de totalMeses con manejo de error
-		if (!(cin >> totalMeses)) {
-			cin.clear();
-			limpiarBuffer();
-			totalMeses = 0; // Para que el bucle repita
-		}
-		limpiarBuffer();
-
-		if (totalMeses <= 0 || totalMeses > 12) {
-			cout << "Numero de meses invalido. Debe ser entre 1 y 12.\n";
-		}
-	} while (totalMeses <= 0 || totalMeses > 12);
-
-	// system("cls"); // Descomentar para limpiar
-	cout << "======= CALCULO DE SUELDO ACUMULADO PARA " << nombreEmpleado << " (" << totalMeses << " MESES) =======\n\n";
-
-	// Inicia la recursión desde el mes más reciente (totalMeses) hasta el más antiguo (1)
-	double sueldoFinal = calcularSueldoAcumuladoRecursivo(totalMeses, totalMeses);
-
-	cout << "\n=================================================================\n";
-	cout << "RESULTADO FINAL: El sueldo acumulado total en " << totalMeses
-		<< " meses para " << nombreEmpleado << " es: $" << fixed << setprecision(2) << sueldoFinal << endl;
-	cout << "=================================================================\n";
+// Agrega la fila del libro (mismo orden que ENCABEZADO_VENTAS) al final de 'destino'
+void agregarFilaVenta(string& destino, const VentaBoleto& venta, string_view fecha, string_view vendedor, string_view tipo) {
+	char numero[24];
+	destino.append(numero, to_chars(numero, numero + sizeof(numero), venta.folio).ptr);
+	destino += ',';
+	destino.append(fecha);
+	destino += ',';
+	destino.append(vendedor);
+	destino += ',';
+	destino.append(tipo);
+	for (Centavos monto : { venta.centesimas, venta.subtotal, venta.descuento, venta.total }) {
+		destino += ',';
+		destino.append(numero, formatearCentavos(numero, monto));
+	}
+	destino += '\n';
 }
 
+// 'clave' es un string reutilizable: buscar en el mapa no asigna memoria por boleto
+void acumularTotales(unordered_map<string, TotalesVendedor>& totales, string& clave, string_view vendedor,
+	uint64_t boletos, Centavos subtotal, Centavos descuento, Centavos total) {
+	clave.assign(vendedor);
+	TotalesVendedor& t = totales[clave];
+	t.boletos += boletos;
+	t.subtotal += subtotal;
+	t.descuento += descuento;
+	t.total += total;
+}
 
-// ======================= SUBMENU 6: METODOS DE ORDENAMIENTO Y LISTAS =======================
-
-// --------------------------- UTILIDADES CSV Y LISTAS (BURBUJA) ---------------------------
-
-const string NOMBRE_ARCHIVO_INGRESOS = "ingresos_camiones.csv";
-
-/**
- * @brief Carga todos los registros de ingresos desde el CSV.
- */
-vector<IngresoRecord> cargarIngresosCSV() {
-	vector<IngresoRecord> registros;
-	ifstream archivo(NOMBRE_ARCHIVO_INGRESOS);
-	if (!archivo.is_open()) return registros; // Retorna vector vacío si no existe
-
-	string linea;
-	getline(archivo, linea); // Ignorar encabezados
-
-	while (getline(archivo, linea)) {
-		stringstream ss(linea);
-		string segmento;
-		IngresoRecord record;
-
-		// 1. Camion
-		getline(ss, segmento, ',');
-		record.camion = segmento;
-		// 2. Chofer
-		getline(ss, segmento, ',');
-		record.chofer = segmento;
-
-		// 3. Ingresos (7 días)
-		record.ingresos.clear();
-		for (int i = 0; i < 7; ++i) {
-			if (getline(ss, segmento, ',')) {
-				try {
-					record.ingresos.push_back(stod(segmento));
-				}
-				catch (...) {
-					record.ingresos.push_back(0.0); // Manejo de error
-				}
+class MotorVentas {
+	vector<ReglaDescuento> reglas;
+	unordered_map<string, TotalesVendedor> totales;
+	alignas(64) atomic<uint64_t> siguienteFolio{ 1 }; // Lo comparten todas las terminales: línea propia
+	alignas(64) string rutaLibro;
+	ofstream libro;
+	string pendiente;       // Filas formateadas que aún no se escriben al libro
+	string claveVendedor;
+	RelojVentas reloj;
+
+	static constexpr size_t LIMITE_PENDIENTE = 1 << 20;
+
+public:
+	~MotorVentas() { vaciar(); }
+
+	/**
+	 * @brief Carga la tabla de descuentos (Clave,Descripcion,Porcentaje).
+	 * Si el archivo no existe se crea con las tarifas de siempre para que se pueda editar.
+	 */
+	void cargarReglas(const string& ruta) {
+		reglas.clear();
+		ifstream archivo(ruta);
+		if (!archivo.is_open()) {
+			reglas = {
+				{ "ESTUDIANTE", "Estudiante", 5000 },
+				{ "INAPAM", "INAPAM / Tercera Edad", 2000 },
+				{ "GENERAL", "General / Sin Descuento", 0 },
+			};
+			ofstream nuevo(ruta);
+			nuevo << "Clave,Descripcion,Porcentaje\n";
+			for (const auto& r : reglas) nuevo << r.clave << "," << r.descripcion << "," << Monto{ r.centesimas } << "\n";
+			return;
+		}
+		string linea;
+		getline(archivo, linea); // Ignorar encabezados
+		while (getline(archivo, linea)) {
+			string_view resto(linea), clave, descripcion, porcentaje;
+			ReglaDescuento regla;
+			if (!siguienteCampoCSV(resto, clave) || !siguienteCampoCSV(resto, descripcion) ||
+				!siguienteCampoCSV(resto, porcentaje) || !convertirCentavos(porcentaje, regla.centesimas) ||
+				!porcentajeValido(regla.centesimas)) {
+				if (!linea.empty()) cout << "[ADVERTENCIA] Regla de descuento invalida ignorada: '" << linea << "'\n";
+				continue;
 			}
-			else break; // Si no hay más segmentos
+			regla.clave.assign(clave);
+			regla.descripcion.assign(descripcion);
+			reglas.push_back(move(regla));
 		}
+	}
 
-		// 4. Total (El último segmento después de los 7 ingresos)
-		if (getline(ss, segmento, ',')) {
-			try {
-				record.total = stod(segmento);
-			}
-			catch (...) {
-				record.total = sumaValores(record.ingresos); // Recalcular si falla
+	// Abre el libro en modo append; una pasada sobre lo existente recupera el folio y los totales
+	void abrirLibro(const string& ruta) {
+		vaciar();
+		if (libro.is_open()) libro.close();
+		rutaLibro = ruta;
+		totales.clear();
+		uint64_t folioSiguiente = 1;
+
+		ifstream existente(ruta);
+		bool vacio = true;
+		if (existente.is_open()) {
+			string linea;
+			if (getline(existente, linea)) vacio = false;
+			while (getline(existente, linea)) {
+				string_view resto(linea), campo, vendedor;
+				Centavos subtotal = 0, descuento = 0, total = 0;
+				uint64_t folio = 0;
+				siguienteCampoCSV(resto, campo);
+				from_chars(campo.data(), campo.data() + campo.size(), folio);
+				siguienteCampoCSV(resto, campo);          // Fecha_Hora
+				siguienteCampoCSV(resto, vendedor);
+				siguienteCampoCSV(resto, campo);          // Tipo
+				siguienteCampoCSV(resto, campo);          // Porcentaje
+				bool valido = siguienteCampoCSV(resto, campo) && convertirCentavos(campo, subtotal);
+				valido = valido && siguienteCampoCSV(resto, campo) && convertirCentavos(campo, descuento);
+				valido = valido && siguienteCampoCSV(resto, campo) && convertirCentavos(campo, total);
+				if (!valido) { CONTAR_METRICA(ErroresParseo, 1); continue; }
+				folioSiguiente = max(folioSiguiente, folio + 1);
+				acumularTotales(totales, claveVendedor, vendedor, 1, subtotal, descuento, total);
 			}
 		}
-		else {
-			record.total = sumaValores(record.ingresos);
+		siguienteFolio.store(folioSiguiente, memory_order_relaxed);
+		libro.open(ruta, ios::app | ios::binary);
+		if (!libro.is_open()) {
+			cout << "!!! ERROR: No se pudo abrir el libro de ventas '" << ruta << "'.\n";
+			return;
+		}
+		if (vacio) {
+			libro << ENCABEZADO_VENTAS << "\n";
+			libro.flush();
 		}
-		registros.push_back(record);
 	}
-	archivo.close();
-	return registros;
-}
-// ======================= ESTRUCTURAS DE DATOS PARA LISTAS (CASE 6) =======================
-
-// 1. Método Burbuja (ingresos_camiones.csv)
-struct IngresoRecord {
-	string camion;
-	string chofer;
-	vector<double> ingresos; // Días 1-7
-	double total;
-};
-const string NOMBRE_ARCHIVO_INGRESOS = "ingresos_camiones.csv";
 
-// 2. Método Selección (taller_camiones.csv)
-struct TallerRecord {
-	string camion;
-	string encargado;
-	string taller;
-	vector<double> costos; // Visitas
-	double total;
-};
-const string NOMBRE_ARCHIVO_TALLER = "taller_camiones.csv";
+	const vector<ReglaDescuento>& reglasDescuento() const { return reglas; }
+	const unordered_map<string, TotalesVendedor>& totalesPorVendedor() const { return totales; }
+	const string& archivoLibro() const { return rutaLibro; }
 
-// 3. Método Inserción (kilometraje_camiones.csv)
-struct KilometrajeRecord {
-	string camion;
-	string chofer;
-	vector<double> km; // Días
-	double total;
-};
-const string NOMBRE_ARCHIVO_KM = "kilometraje_camiones.csv";
+	const ReglaDescuento* buscarRegla(string_view clave) const {
+		for (const auto& r : reglas) {
+			if (r.clave == clave) return &r;
+		}
+		return nullptr;
+	}
 
-// ======================= CRUD COMÚN (CARGAR/GUARDAR/ELIMINAR) =======================
+	// Folio único aunque lo pidan varias terminales a la vez
+	uint64_t tomarFolio() { return siguienteFolio.fetch_add(1, memory_order_relaxed); }
+
+	/**
+	 * @brief Registra un boleto: asigna folio, aplica el descuento, lo agrega al libro
+	 * (en memoria hasta vaciar()) y actualiza los totales del vendedor.
+	 * @param tipo Clave de la regla, o "PERSONALIZADO" con 'centesimas' capturadas a mano.
+	 */
+	VentaBoleto registrar(string_view vendedor, string_view tipo, int64_t centesimas, Centavos subtotal) {
+		VentaBoleto venta = calcularVenta(tomarFolio(), centesimas, subtotal);
+		agregarFilaVenta(pendiente, venta, reloj.ahora(), vendedor, tipo);
+		if (pendiente.size() >= LIMITE_PENDIENTE) vaciar();
+		acumularTotales(totales, claveVendedor, vendedor, 1, venta.subtotal, venta.descuento, venta.total);
+		CONTAR_METRICA(VentasRegistradas, 1);
+		return venta;
+	}
 
-// --------------------------- INGRESOS (BURBUJA) ---------------------------
+	/**
+	 * @brief Integra lo que juntó una terminal: sus filas del libro y sus totales parciales.
+	 * Durante una sesión concurrente solo el agregador llama a esta función.
+	 */
+	void integrar(string& filas, unordered_map<string, TotalesVendedor>& parciales) {
+		pendiente += filas;
+		for (const auto& p : parciales) {
+			acumularTotales(totales, claveVendedor, p.first, p.second.boletos, p.second.subtotal, p.second.descuento, p.second.total);
+		}
+		if (pendiente.size() >= LIMITE_PENDIENTE) vaciar();
+	}
 
-vector<IngresoRecord> cargarIngresosCSV() {
-	vector<IngresoRecord> registros;
-	ifstream archivo(NOMBRE_ARCHIVO_INGRESOS);
-	if (!archivo.is_open()) return registros;
-	string linea;
-	getline(archivo, linea); // Ignorar encabezados
+	// Escribe al libro lo pendiente (una sola escritura por bloque de filas). false si el disco
+	// la rechazó: el fallo se anota en el escritor y los menús lo avisan (reportarFallosEscritura)
+	bool vaciar() {
+		if (pendiente.empty() || !libro.is_open()) return pendiente.empty();
+		libro.write(pendiente.data(), static_cast<streamsize>(pendiente.size()));
+		libro.flush();
+		const bool exito = static_cast<bool>(libro);
+		if (exito) CONTAR_METRICA(BytesEscritos, pendiente.size());
+		else {
+			libro.clear(); // Las ventas siguientes lo vuelven a intentar
+			escritorArchivos.anotarFallo(rutaLibro);
+		}
+		pendiente.clear();
+		return exito;
+	}
+};
 
-	while (getline(archivo, linea)) {
-		stringstream ss(linea);
-		string segmento;
-		IngresoRecord record;
+MotorVentas motorVentas;
 
-		getline(ss, record.camion, ',');
-		getline(ss, record.chofer, ',');
+// Se llama una vez al iniciar el programa (menu interactivo o modo --ventas)
+void iniciarMotorVentas() {
+	motorVentas.cargarReglas(NOMBRE_ARCHIVO_DESCUENTOS);
+	motorVentas.abrirLibro(NOMBRE_ARCHIVO_VENTAS);
+}
 
-		record.ingresos.clear();
-		for (int i = 0; i < 7; ++i) {
-			if (getline(ss, segmento, ',')) {
-				try {
-					record.ingresos.push_back(stod(segmento));
-				}
-				catch (...) { record.ingresos.push_back(0.0); }
+// ---------------------- VENTAS CONCURRENTES (VARIAS TERMINALES) ----------------------
+// Cada taquilla vende en su propio hilo sobre su propia TerminalVentas: las filas del libro
+// y los totales por vendedor se acumulan ahí sin candados compartidos. El folio sale de un
+// contador atómico del motor. Un hilo agregador recoge cada cierto tiempo lo acumulado por
+// cada terminal (intercambiando buffers) y lo integra al motor y al libro.
+
+struct alignas(64) TerminalVentas {   // alignas: dos terminales nunca comparten línea de caché
+	MotorVentas* motor = nullptr;
+	mutex candado;                    // Solo lo usan esta terminal y el agregador
+	string filas;                     // Filas del libro aún no integradas
+	unordered_map<string, TotalesVendedor> parciales;
+	string claveVendedor;
+	RelojVentas reloj;
+	uint64_t boletos = 0;             // Solo lo lee la propia terminal
+	Centavos cobrado = 0;
+
+	const ReglaDescuento* buscarRegla(string_view clave) const { return motor->buscarRegla(clave); }
+
+	VentaBoleto registrar(string_view vendedor, string_view tipo, int64_t centesimas, Centavos subtotal);
+	void vaciar() {}                  // El agregador es quien escribe al libro
+};
+
+class SesionVentasConcurrente {
+	MotorVentas& motor;
+	vector<unique_ptr<TerminalVentas>> terminales;
+	thread agregador;
+	mutex candadoAgregador;
+	condition_variable despertar;
+	bool detenida = false;
+	chrono::milliseconds periodo;
+
+	// Intercambia los buffers de cada terminal por unos vacíos e integra lo recogido
+	void recolectar(string& filas, unordered_map<string, TotalesVendedor>& parciales) {
+		for (auto& t : terminales) {
+			{
+				lock_guard<mutex> guardia(t->candado);
+				swap(filas, t->filas);
+				swap(parciales, t->parciales);
 			}
-			else break;
+			motor.integrar(filas, parciales);
+			filas.clear();
+			parciales.clear();
 		}
+		motor.vaciar();
+	}
 
-		if (getline(ss, segmento, ',')) {
-			try { record.total = stod(segmento); }
-			catch (...) { record.total = sumaValores(record.ingresos); }
+public:
+	SesionVentasConcurrente(MotorVentas& m, size_t numTerminales, chrono::milliseconds periodoAgregador = chrono::milliseconds(50))
+		: motor(m), periodo(periodoAgregador) {
+		for (size_t i = 0; i < numTerminales; ++i) {
+			terminales.push_back(make_unique<TerminalVentas>());
+			terminales.back()->motor = &motor;
 		}
-		else { record.total = sumaValores(record.ingresos); }
-		registros.push_back(record);
+		agregador = thread([this]() {
+			string filas;
+			unordered_map<string, TotalesVendedor> parciales;
+			unique_lock<mutex> guardia(candadoAgregador);
+			bool salir = false;
+			while (!salir) {
+				// Si ya se pidió detener, esta es la última pasada: recoge lo que quede
+				salir = despertar.wait_for(guardia, periodo, [this]() { return detenida; });
+				guardia.unlock();
+				recolectar(filas, parciales);
+				guardia.lock();
+			}
+		});
 	}
-	archivo.close();
-	return registros;
-}
-void guardarIngresosCSV_Sobrescribir(const vector<IngresoRecord>& registros) {
-	ofstream archivo(NOMBRE_ARCHIVO_INGRESOS, ios::out);
-	if (archivo.is_open()) {
-		archivo << "Camion,Chofer,Dia_1,Dia_2,Dia_3,Dia_4,Dia_5,Dia_6,Dia_7,Total\n";
-		archivo << fixed << setprecision(2);
-		for (const auto& record : registros) {
-			archivo << record.camion << "," << record.chofer;
-			for (double val : record.ingresos) archivo << "," << val;
-			archivo << "," << record.total << "\n";
+	~SesionVentasConcurrente() { detener(); }
+	SesionVentasConcurrente(const SesionVentasConcurrente&) = delete;
+	SesionVentasConcurrente& operator=(const SesionVentasConcurrente&) = delete;
+
+	size_t numTerminales() const { return terminales.size(); }
+	TerminalVentas& terminal(size_t i) { return *terminales[i]; }
+
+	// Espera al agregador; al regresar todo lo vendido ya está en el motor y en el libro
+	void detener() {
+		{
+			lock_guard<mutex> guardia(candadoAgregador);
+			if (detenida) return;
+			detenida = true;
 		}
-		archivo.close();
-		cout << "[CSV ACTUALIZADO] La tabla de registros ha sido sobrescrita en '" << NOMBRE_ARCHIVO_INGRESOS << "'.\n";
+		despertar.notify_one();
+		agregador.join();
 	}
-	else {
-		cout << "!!! ERROR: No se pudo abrir el archivo para sobrescribir los datos.\n";
+};
+
+VentaBoleto TerminalVentas::registrar(string_view vendedor, string_view tipo, int64_t centesimas, Centavos subtotal) {
+	VentaBoleto venta = calcularVenta(motor->tomarFolio(), centesimas, subtotal);
+	string_view fecha = reloj.ahora();
+	{
+		lock_guard<mutex> guardia(candado);
+		agregarFilaVenta(filas, venta, fecha, vendedor, tipo);
+		acumularTotales(parciales, claveVendedor, vendedor, 1, venta.subtotal, venta.descuento, venta.total);
 	}
+	++boletos;
+	cobrado += venta.total;
+	CONTAR_METRICA(VentasRegistradas, 1);
+	return venta;
 }
-void mostrarRegistrosIngresos(const vector<IngresoRecord>& registros) {
-	cout << "\n======= DATOS ACTUALES DE INGRESOS (" << registros.size() << " Registros) =======\n";
-	if (registros.empty()) { cout << "No hay registros guardados para mostrar." << endl; return; }
 
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
-	cout << "| " << left << setw(10) << "CAMION"
-		<< "| " << left << setw(15) << "CHOFER"
-		<< "| " << right << setw(7) << "Dia 1"
-		<< "| " << right << setw(7) << "Dia 2"
-		<< "| " << right << setw(7) << "Dia 3"
-		<< "| " << right << setw(7) << "Dia 4"
-		<< "| " << right << setw(7) << "Dia 5"
-		<< "| " << right << setw(7) << "Dia 6"
-		<< "| " << right << setw(7) << "Dia 7"
-		<< "| " << right << setw(10) << "TOTAL" << " |\n";
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
+/**
+ * @brief Procesa un lote de boletos, una linea por boleto: Vendedor,Tipo,Subtotal
+ * (el encabezado es opcional). 'Tipo' es la clave de una regla de descuento.
+ * Las lineas invalidas se reportan y se omiten; el resto se registra en 'destino'
+ * (el motor directamente o una terminal de una sesión concurrente).
+ */
+template<typename Destino>
+ResultadoLoteVentas procesarLoteVentas(istream& entrada, Destino& destino, bool reportarErrores = true) {
+	MEDIR_OPERACION(ProcesarLoteVentas);
+	ResultadoLoteVentas resultado;
+	string linea;
+	uint64_t numeroLinea = 0;
+	while (getline(entrada, linea)) {
+		++numeroLinea;
+		if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+		if (linea.empty() || (numeroLinea == 1 && linea.rfind("Vendedor", 0) == 0)) continue;
+
+		string_view resto(linea), vendedor, tipo, subtotalTexto;
+		Centavos subtotal = 0;
+		const ReglaDescuento* regla = nullptr;
+		bool valido = siguienteCampoCSV(resto, vendedor) && !vendedor.empty()
+			&& siguienteCampoCSV(resto, tipo) && (regla = destino.buscarRegla(tipo)) != nullptr
+			&& siguienteCampoCSV(resto, subtotalTexto) && convertirCentavos(subtotalTexto, subtotal) && subtotal >= 0;
+		if (!valido) {
+			++resultado.rechazados;
+			CONTAR_METRICA(ErroresParseo, 1);
+			if (reportarErrores && resultado.rechazados <= 10) {
+				cout << "[ADVERTENCIA] Linea " << numeroLinea << " rechazada: '" << linea << "'\n";
+			}
+			continue;
+		}
+		resultado.total += destino.registrar(vendedor, regla->clave, regla->centesimas, subtotal).total;
+		++resultado.boletos;
+	}
+	destino.vaciar();
+	return resultado;
+}
 
-	cout << fixed << setprecision(2);
-	for (const auto& record : registros) {
-		cout << "| " << left << setw(10) << record.camion
-			<< "| " << left << setw(15) << record.chofer;
+void mostrarResultadoLote(const ResultadoLoteVentas& r, double segundos) {
+	FormatoFlujo formato(cout);
+	cout << "[LOTE PROCESADO] " << r.boletos << " boletos registrados, " << r.rechazados << " lineas rechazadas.\n";
+	cout << "Total cobrado: $" << Monto{ r.total } << " en " << fixed << setprecision(3) << segundos << " s ("
+		<< setprecision(0) << r.boletos / max(segundos, 1e-9) << " boletos/s)\n";
+}
 
-		for (double ingreso : record.ingresos) {
-			cout << "| " << right << setw(7) << ingreso;
-		}
-		cout << "| " << right << setw(10) << record.total << " |" << endl;
+void mostrarTotalesVendedor(const MotorVentas& motor) {
+	cout << "\n======= TOTALES POR VENDEDOR (" << motor.archivoLibro() << ") =======\n";
+	const auto& totales = motor.totalesPorVendedor();
+	if (totales.empty()) { cout << "No hay ventas registradas." << endl; return; }
+
+	vector<const pair<const string, TotalesVendedor>*> orden;
+	orden.reserve(totales.size());
+	for (const auto& t : totales) orden.push_back(&t);
+	sort(orden.begin(), orden.end(), [](const auto* a, const auto* b) { return a->second.total > b->second.total; });
+
+	TotalesVendedor general;
+	cout << left << setw(20) << "VENDEDOR" << right << setw(10) << "BOLETOS" << setw(16) << "SUBTOTAL"
+		<< setw(14) << "DESCUENTO" << setw(16) << "TOTAL" << "\n";
+	for (const auto* t : orden) {
+		cout << left << setw(20) << t->first << right << setw(10) << t->second.boletos << setw(16) << Monto{ t->second.subtotal }
+			<< setw(14) << Monto{ t->second.descuento } << setw(16) << Monto{ t->second.total } << "\n";
+		general.boletos += t->second.boletos;
+		general.subtotal += t->second.subtotal;
+		general.descuento += t->second.descuento;
+		general.total += t->second.total;
 	}
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
+	cout << left << setw(20) << "TOTAL" << right << setw(10) << general.boletos << setw(16) << Monto{ general.subtotal }
+		<< setw(14) << Monto{ general.descuento } << setw(16) << Monto{ general.total } << "\n";
 }
 
-void eliminarRegistroIngreso(vector<IngresoRecord>& registros) {
-	cout << "\n======= ELIMINAR REGISTRO DE INGRESO =======\n";
-	string camion = pedirTexto("Ingrese el numero de CAMION a eliminar: ");
-	string chofer = pedirTexto("Ingrese el nombre del CHOFER del registro a eliminar: ");
-	size_t tam_antes = registros.size();
+void mostrarReglasDescuento(const MotorVentas& motor) {
+	cout << "\n======= REGLAS DE DESCUENTO (" << NOMBRE_ARCHIVO_DESCUENTOS << ") =======\n";
+	for (const auto& r : motor.reglasDescuento()) {
+		cout << left << setw(14) << r.clave << setw(28) << r.descripcion << right << setw(7) << Monto{ r.centesimas } << "%\n";
+	}
+}
 
-	registros.erase(
-		remove_if(registros.begin(), registros.end(),
-			[camion, chofer](const IngresoRecord& r) {
-				return r.camion == camion && r.chofer == chofer;
-			}),
-		registros.end()
-	);
-	size_t tam_despues = registros.size();
+// Procesa cada lote en su propia terminal (un hilo por archivo) y los integra al libro
+ResultadoLoteVentas procesarLotesConcurrentes(const vector<string>& rutas, MotorVentas& motor) {
+	ResultadoLoteVentas general;
+	vector<ResultadoLoteVentas> resultados(rutas.size());
+	SesionVentasConcurrente sesion(motor, rutas.size());
+	vector<thread> hilos;
+	for (size_t i = 0; i < rutas.size(); ++i) {
+		hilos.emplace_back([&, i]() {
+			ifstream lote(rutas[i]);
+			if (lote.is_open()) resultados[i] = procesarLoteVentas(lote, sesion.terminal(i), false);
+			else resultados[i].rechazados = 1;
+		});
+	}
+	for (auto& h : hilos) h.join();
+	sesion.detener();
+	for (size_t i = 0; i < rutas.size(); ++i) {
+		cout << "  Terminal " << (i + 1) << " (" << rutas[i] << "): " << resultados[i].boletos << " boletos, "
+			<< resultados[i].rechazados << " rechazados\n";
+		general.boletos += resultados[i].boletos;
+		general.rechazados += resultados[i].rechazados;
+		general.total += resultados[i].total;
+	}
+	return general;
+}
 
-	if (tam_despues < tam_antes) {
-		cout << "\n[ELIMINACION EXITOSA] Se eliminaron " << (tam_antes - tam_despues) << " registros.\n";
-		guardarIngresosCSV_Sobrescribir(registros);
+// Modo de linea de comandos: Proyecto7.0 --ventas <archivo|-> [<archivo> ...]
+// '-' lee el lote de stdin; con varios archivos cada uno se vende en una terminal concurrente.
+int ejecutarLoteVentas(int argc, char* argv[]) {
+	if (argc < 3) {
+		cout << "Uso: Proyecto7.0 --ventas <archivo|-> [<archivo> ...]\n"
+			<< "  Cada linea: Vendedor,Tipo,Subtotal (Tipo = clave en " << NOMBRE_ARCHIVO_DESCUENTOS << ")\n"
+			<< "  Con varios archivos, cada uno se procesa en paralelo como una terminal distinta.\n";
+		return 1;
+	}
+	iniciarMotorVentas();
+	auto inicio = chrono::steady_clock::now();
+	ResultadoLoteVentas r;
+	if (argc > 3) {
+		r = procesarLotesConcurrentes(vector<string>(argv + 2, argv + argc), motorVentas);
 	}
 	else {
-		cout << "\n[ADVERTENCIA] No se encontro ningun registro con Camion: " << camion << " y Chofer: " << chofer << ".\n";
+		string origen = argv[2];
+		ifstream archivo;
+		if (origen != "-") {
+			archivo.open(origen);
+			if (!archivo.is_open()) {
+				cout << "!!! ERROR: No se pudo abrir el lote '" << origen << "'.\n";
+				return 1;
+			}
+		}
+		r = procesarLoteVentas(origen == "-" ? cin : archivo, motorVentas);
 	}
+	mostrarResultadoLote(r, chrono::duration<double>(chrono::steady_clock::now() - inicio).count());
+	if (reportarFallosEscritura()) return 1;
+	return r.rechazados ? 2 : 0;
 }
-// Adaptador para Metodo Selección (Taller)
-void menuListaTallerCompleto(const string& metodoUsado) {
-	bool regresar = menuListaGenerico<TallerRecord>(
-		metodoUsado,
-		cargarTallerCSV,
-		mostrarRegistrosTaller,
-		eliminarRegistroTaller,
-		actualizarRegistroTaller,
-		ordenarRegistrosTaller
-	);
-	if (regresar) {
-		metodoSeleccion();
+
+
+// ======================= VENTAS CON PUNTEROS =======================
+void menuVentasPunteros() {
+	cout << "\n======= MODULO DE VENTAS (USO DE PUNTEROS) =======" << endl;
+	cout << "Bienvenido al sistema de venta de boletos." << endl;
+
+	// 1. Declaración de variables locales
+	string vendedor;
+	uint64_t numVenta = 0;
+	Centavos totalVenta = 0;
+	int64_t porcentajeDescuento = 0; // En centésimas: 5000 = 50.00%
+	Centavos montoFinal = 0;
+
+	// 2. Declaración de PUNTEROS
+	string* pVendedor = &vendedor;
+	uint64_t* pNumVenta = &numVenta;
+	Centavos* pTotalVenta = &totalVenta;
+	int64_t* pPorcentaje = &porcentajeDescuento;
+	Centavos* pFinal = &montoFinal;
+
+	// 3. Solicitar datos usando punteros (Requisito de imagen)
+	cout << "Ingrese el nombre del vendedor (Taquillero): ";
+	// Usamos getline con el contenido apuntado por pVendedor
+	getline(cin, *pVendedor);
+	replace(pVendedor->begin(), pVendedor->end(), ',', ' '); // La coma separa columnas en el libro
+
+	// El numero de venta (folio) lo asigna el libro de ventas al registrar el boleto
+	*pTotalVenta = pedirMonto("Ingrese el total de la venta (Costo del Boleto): $");
+	if (*pTotalVenta < 0) { // Igual que en los lotes: un subtotal negativo no es una venta
+		cout << "!!! ERROR: El total de la venta no puede ser negativo. La venta no se registro." << endl;
+		return;
 	}
-}
-// Adaptador para Metodo Inserción (Kilometraje)
-void menuListaKilometrajeCompleto(const string& metodoUsado) {
-	bool regresar = menuListaGenerico<KilometrajeRecord>(
-		metodoUsado,
-		cargarKmCSV,
-		mostrarRegistrosKm,
-		eliminarRegistroKm,
-		actualizarRegistroKm,
-		ordenarRegistrosKm
-	);
-	if (regresar) {
-		metodoInsercion();
+
+	// 4. Definir porcentaje de descuento (Requisito: DEFINIR EL PORCENTAJE)
+	// Las opciones salen de la tabla de descuentos; la ultima es el porcentaje manual
+	const vector<ReglaDescuento>& reglas = motorVentas.reglasDescuento();
+	cout << "\n--- Seleccione tipo de descuento ---" << endl;
+	for (size_t i = 0; i < reglas.size(); ++i) {
+		cout << (i + 1) << ". " << reglas[i].descripcion << " (" << Monto{ reglas[i].centesimas } << "%)" << endl;
 	}
-}
-// Adaptador para Metodo Burbuja (Ingresos)
-void menuListaIngresosCompleto(const string& metodoUsado) {
-	// Las lambdas envuelven las funciones de actualización y ordenamiento específicas.
-	// La función cargar() se llama automáticamente dentro del bucle del menú genérico.
-	bool regresar = menuListaGenerico<IngresoRecord>(
-		metodoUsado,
-		cargarIngresosCSV,
-		mostrarRegistrosIngresos,
-		eliminarRegistroIngreso,
-		actualizarRegistroIngreso,
-		ordenarRegistrosIngreso
-	);
-	// Si regresa es true, volvemos a llamar a metodoBurbuja, si no, salimos y volvemos al menu principal.
-	if (regresar) {
-		metodoBurbuja(); // Llama a la función principal para agregar un nuevo registro
+	cout << (reglas.size() + 1) << ". Otro porcentaje personalizado" << endl;
+
+	int opcDesc = pedirEntero("Opcion: ");
+	string tipoDescuento = "PERSONALIZADO";
+	if (opcDesc >= 1 && static_cast<size_t>(opcDesc) <= reglas.size()) {
+		*pPorcentaje = reglas[opcDesc - 1].centesimas;
+		tipoDescuento = reglas[opcDesc - 1].clave;
+	}
+	else if (static_cast<size_t>(opcDesc) == reglas.size() + 1) {
+		// Mismo formato de dos decimales que un monto: "12.5" -> 1250 centésimas
+		*pPorcentaje = pedirMonto("Ingrese el porcentaje manual (ej. 10 para 10%): ");
+		if (!porcentajeValido(*pPorcentaje)) {
+			cout << "Porcentaje fuera de rango (0 a 100). Se aplicara 0% descuento." << endl;
+			*pPorcentaje = 0;
+		}
+	}
+	else {
+		cout << "Opcion no valida. Se aplicara 0% descuento." << endl;
+		*pPorcentaje = 0;
 	}
-}
-// ======================= MENUS DE LISTAS COMPLETOS =======================
 
-/**
- * @brief Menú de listas genérico adaptado a cada tipo de registro.
- * La lógica de carga, guardado, eliminación y visualización debe ser inyectada.
- * La lógica de Búsqueda, Actualización y Ordenamiento es específica.
- * @return true si se debe regresar al menú de ordenamiento (para agregar un nuevo registro), false para salir.
- */
-template<typename T, typename C, typename S, typename E, typename U, typename O>
-bool menuListaGenerico(const string& metodoUsado, C cargar, S mostrar, E eliminar, U actualizar, O ordenar) {
-	int opcion = 0;
-	bool regresarMenuOrdenamiento = false;
+	// 5. Calcular total usando punteros
+	// Descuento = Total * Porcentaje (entero, redondeado al centavo)
+	Centavos descuentoAplicado = aplicarPorcentaje(*pTotalVenta, *pPorcentaje);
 
-	while (opcion != 9) {
-		vector<T> registros = cargar();
+	// Total Final = Total - Descuento
+	*pFinal = *pTotalVenta - descuentoAplicado;
 
-		cout << "\n======== MENU DE LISTAS DE REGISTROS (" << metodoUsado << ") ========\n";
-		cout << "Registros actuales: " << registros.size() << endl;
-		cout << "--------------------------------------------------------" << endl;
-		cout << "1. Mostrar todos los registros actuales" << endl;
-		cout << "2. Agregar un nuevo registro (Regresar al Menu Ordenamiento)" << endl;
-		cout << "3. Eliminar un registro" << endl;
-		cout << "--------------------------------------------------------" << endl;
-		cout << "4. Búsqueda: Encontrar un elemento en la lista" << endl;
-		cout << "5. Actualización: Modificar el valor de un elemento en la lista" << endl;
-		cout << "6. Ordenamiento: Organizar los elementos en un orden específico" << endl;
-		cout << "7. Tamaño: Obtener cuántos elementos tiene la lista" << endl;
-		cout << "8. Verificar si está vacía: Comprobar si la lista no contiene ningún elemento" << endl;
-		cout << "9. Regresar al Menu Principal" << endl;
-		cout << "Seleccione una opcion: ";
-		cin >> opcion;
-		limpiarBuffer();
+	// 6. Registrar en el libro de ventas (asigna el folio y actualiza los totales del vendedor)
+	*pNumVenta = motorVentas.registrar(*pVendedor, tipoDescuento, *pPorcentaje, *pTotalVenta).folio;
+	const bool escrita = motorVentas.vaciar();
+
+	// 7. Mostrar resultados
+	cout << "\n========== TICKET DE VENTA ==========" << endl;
+	cout << "Vendedor: " << *pVendedor << endl;
+	cout << "Folio Venta: " << *pNumVenta << endl;
+	cout << "Subtotal: $" << Monto{ *pTotalVenta } << endl;
+	cout << "Descuento aplicado (" << Monto{ *pPorcentaje } << "%): -$" << Monto{ descuentoAplicado } << endl;
+	cout << "TOTAL A PAGAR: $" << Monto{ *pFinal } << endl;
+	cout << "=====================================" << endl;
+
+	// Pausa para que el usuario pueda leer
+	if (escrita) cout << "\nVenta registrada correctamente en '" << motorVentas.archivoLibro() << "'." << endl;
+	else reportarFallosEscritura();
+}
 
-		// vector<T> registros_operacion = cargar(); // Recargar para operaciones, aunque ya se hizo arriba
+void menuVentas() {
+	asegurarModulo(Modulo::Ventas);
+	int opcion = 0;
+	while (opcion != 5) {
+		reportarFallosEscritura();
+		cout << "\n======= MODULO DE VENTAS DE BOLETOS =======" << endl;
+		cout << "1. Vender un boleto (Punteros)" << endl;
+		cout << "2. Procesar lote de boletos desde archivo" << endl;
+		cout << "3. Totales por vendedor" << endl;
+		cout << "4. Reglas de descuento vigentes" << endl;
+		cout << "5. Regresar al menu principal" << endl;
+		opcion = pedirEntero("Seleccione una opcion: ");
 
 		switch (opcion) {
 		case 1:
-			mostrar(registros);
+			menuVentasPunteros();
 			limpiarPantalla();
 			break;
-		case 2:
-			regresarMenuOrdenamiento = true;
-			opcion = 9; // Salir del bucle
+		case 2: {
+			string ruta = pedirTexto("Archivo del lote (Vendedor,Tipo,Subtotal por linea): ");
+			ifstream lote(ruta);
+			if (!lote.is_open()) {
+				cout << "!!! ERROR: No se pudo abrir el lote '" << ruta << "'.\n";
+			}
+			else {
+				auto inicio = chrono::steady_clock::now();
+				ResultadoLoteVentas r = procesarLoteVentas(lote, motorVentas);
+				mostrarResultadoLote(r, chrono::duration<double>(chrono::steady_clock::now() - inicio).count());
+			}
+			limpiarPantalla();
 			break;
+		}
 		case 3:
-			eliminar(registros);
+			mostrarTotalesVendedor(motorVentas);
 			limpiarPantalla();
 			break;
 		case 4:
-			buscarRegistro<T>(registros, metodoUsado);
+			mostrarReglasDescuento(motorVentas);
 			limpiarPantalla();
 			break;
 		case 5:
-			actualizar(registros);
-			limpiarPantalla();
-			break;
-		case 6:
-			ordenar(registros); // Muestra la lista ordenada dentro de la función
-			limpiarPantalla();
 			break;
-		case 7:
-			cout << "\n[TAMAÑO] La lista contiene " << registros.size() << " elementos.\n";
+		default:
+			cout << "Opcion invalida. Intente de nuevo." << endl;
+		}
+	}
+}
+
+
+// ======================= DIAGNOSTICOS (MENU 8) =======================
+
+// Percentil aproximado a partir del histograma (limite superior de la cubeta)
+uint64_t percentilHistograma(const uint64_t cubetas[], uint64_t total, double fraccion) {
+	if (total == 0) return 0;
+	uint64_t objetivo = static_cast<uint64_t>(ceil(total * fraccion));
+	uint64_t acumulado = 0;
+	for (size_t c = 0; c < NUM_CUBETAS_METRICA; ++c) {
+		acumulado += cubetas[c];
+		if (acumulado >= objetivo) return c == 0 ? 0 : (uint64_t(1) << c);
+	}
+	return uint64_t(1) << (NUM_CUBETAS_METRICA - 1);
+}
+
+void escribirReporteMetricas(ostream& out) {
+	uint64_t llamadas[NUM_OPERACIONES_METRICA] = {};
+	uint64_t nanos[NUM_OPERACIONES_METRICA] = {};
+	uint64_t maximo[NUM_OPERACIONES_METRICA] = {};
+	uint64_t histograma[NUM_OPERACIONES_METRICA][NUM_CUBETAS_METRICA] = {};
+	uint64_t contadores[NUM_CONTADORES_METRICA] = {};
+	RegistroMetricas::instancia().acumular(llamadas, nanos, maximo, histograma, contadores);
+
+	out << "======= DIAGNOSTICOS: METRICAS DE RENDIMIENTO =======\n";
+	out << "Generado: " << obtenerHoraActual() << "\n";
+	out << "---------------------------------------------------------------------------------------------\n";
+	out << "| " << left << setw(22) << "OPERACION"
+		<< "| " << right << setw(9) << "LLAMADAS"
+		<< "| " << right << setw(12) << "TOTAL (ms)"
+		<< "| " << right << setw(11) << "PROM (us)"
+		<< "| " << right << setw(11) << "P50 (us)"
+		<< "| " << right << setw(11) << "P99 (us)"
+		<< "| " << right << setw(11) << "MAX (us)" << " |\n";
+	out << "---------------------------------------------------------------------------------------------\n";
+	out << fixed << setprecision(2);
+	for (size_t op = 0; op < NUM_OPERACIONES_METRICA; ++op) {
+		uint64_t n = llamadas[op];
+		out << "| " << left << setw(22) << NOMBRES_OPERACION_METRICA[op]
+			<< "| " << right << setw(9) << n
+			<< "| " << right << setw(12) << nanos[op] / 1e6
+			<< "| " << right << setw(11) << (n ? nanos[op] / 1e3 / n : 0.0)
+			<< "| " << right << setw(11) << min(percentilHistograma(histograma[op], n, 0.50), maximo[op]) / 1e3
+			<< "| " << right << setw(11) << min(percentilHistograma(histograma[op], n, 0.99), maximo[op]) / 1e3
+			<< "| " << right << setw(11) << maximo[op] / 1e3 << " |\n";
+	}
+	out << "---------------------------------------------------------------------------------------------\n";
+	for (size_t c = 0; c < NUM_CONTADORES_METRICA; ++c) {
+		out << left << setw(28) << NOMBRES_CONTADOR_METRICA[c] << ": " << contadores[c] << "\n";
+	}
+	uint64_t filas = contadores[static_cast<size_t>(ContadorMetrica::FilasLeidas)];
+	if (filas > 0) {
+		out << left << setw(28) << "Asignaciones por fila" << ": " << setprecision(2)
+			<< static_cast<double>(contadores[static_cast<size_t>(ContadorMetrica::AsignacionesCarga)]) / filas << "\n";
+	}
+}
+
+const string NOMBRE_ARCHIVO_DIAGNOSTICO = "diagnostico_metricas.txt";
+
+void menuDiagnosticos() {
+	int opcion = 0;
+	while (opcion != 5) {
+		cout << "\n======== DIAGNOSTICOS ========" << endl;
+#if !METRICAS_HABILITADAS
+		cout << "(Metricas deshabilitadas en compilacion: METRICAS_HABILITADAS=0)" << endl;
+#endif
+		cout << "1. Mostrar metricas de rendimiento" << endl;
+		cout << "2. Guardar metricas en archivo (" << NOMBRE_ARCHIVO_DIAGNOSTICO << ")" << endl;
+		cout << "3. Reiniciar metricas" << endl;
+		cout << "4. Perfil de arranque (modulos y precarga)" << endl;
+		cout << "5. Regresar al menu principal" << endl;
+		cout << "Seleccione una opcion: ";
+		cin >> opcion;
+		limpiarBuffer();
+
+		switch (opcion) {
+		case 1:
+			cout << "\n";
+			escribirReporteMetricas(cout);
 			limpiarPantalla();
 			break;
-		case 8:
-			if (registros.empty()) {
-				cout << "\n[ESTADO] La lista ESTA vacia.\n";
+		case 2: {
+			ofstream archivo(NOMBRE_ARCHIVO_DIAGNOSTICO, ios::app);
+			if (archivo.is_open()) {
+				escribirReporteMetricas(archivo);
+				archivo << "\n";
+				cout << "[DIAGNOSTICO GUARDADO] Metricas agregadas a '" << NOMBRE_ARCHIVO_DIAGNOSTICO << "'.\n";
 			}
 			else {
-				cout << "\n[ESTADO] La lista NO esta vacia. Contiene " << registros.size() << " elementos.\n";
+				cout << "!!! ERROR: No se pudo abrir el archivo de diagnostico.\n";
 			}
 			limpiarPantalla();
 			break;
-		case 9:
-			cout << "Regresando al Menu Principal...\n";
+		}
+		case 3:
+			RegistroMetricas::instancia().reiniciar();
+			cout << "[METRICAS REINICIADAS]\n";
+			limpiarPantalla();
+			break;
+		case 4:
+			cout << "\n";
+			mostrarPerfilArranque();
+			limpiarPantalla();
+			break;
+		case 5:
+			cout << "Regresando al menu principal..." << endl;
 			break;
 		default:
 			cout << "Opcion invalida. Intente de nuevo." << endl;
@@ -803,835 +6966,2583 @@ bool menuListaGenerico(const string& metodoUsado, C cargar, S mostrar, E elimina
 			break;
 		}
 	}
-	return regresarMenuOrdenamiento;
 }
-void ordenarRegistrosKm(vector<KilometrajeRecord>& registros) {
-	cout << "\n======= ORDENAR REGISTROS DE KILOMETRAJE =======\n";
-	cout << "Ordenar por: 1. Camion (Texto) | 2. Chofer (Texto) | 3. Total (Numerico): ";
-	int campo = pedirEntero("");
-	cout << "¿Orden Ascendente (1) o Descendente (2)?: ";
-	int orden = pedirEntero("");
-	bool asc = (orden == 1);
 
-	if (campo == 1) { // Camion
-		sort(registros.begin(), registros.end(), [asc](const KilometrajeRecord& a, const KilometrajeRecord& b) {
-			return asc ? (a.camion < b.camion) : (a.camion > b.camion);
-			});
+
+// ======================= VERSIONES DE TABLAS (INSTANTÁNEAS MVCC) =======================
+// Las tablas residentes (modo servidor) se leen sin candados: un lector toma la versión
+// vigente y la recorre aunque mientras tanto se publiquen otras. Cada versión es una lista
+// de segmentos inmutables de hasta FILAS_POR_SEGMENTO registros; una edición copia solo los
+// segmentos que toca (los demás se comparten con la versión anterior) y publica la nueva con
+// un intercambio atómico del puntero.
+// Las versiones reemplazadas se liberan por épocas: cada hilo lector anuncia en su ranura la
+// época en que empezó a leer, y una versión retirada en la época E se borra cuando ya no hay
+// ningún lector anunciado en una época <= E.
+
+const size_t FILAS_POR_SEGMENTO = 1024;
+const size_t MAX_HILOS_LECTORES = 256;
+
+// Ranura que ocupa un hilo lector: se reserva la primera vez que lee y se libera cuando termina
+struct RanuraLector {
+	atomic<bool>* ocupada = nullptr;
+	size_t indice = 0;
+	size_t anidadas = 0;
+	~RanuraLector() { if (ocupada) ocupada->store(false, memory_order_release); }
+};
+thread_local RanuraLector ranuraLector;
+
+class DominioEpocas {
+	struct alignas(64) Ranura {       // alignas: cada lector escribe en su propia línea de caché
+		atomic<uint64_t> epoca{ 0 };  // 0: el hilo no está leyendo
+		atomic<bool> ocupada{ false };
+	};
+	array<Ranura, MAX_HILOS_LECTORES> ranuras;
+	atomic<uint64_t> epocaGlobal{ 1 };
+
+	Ranura& ranuraPropia() {
+		RanuraLector& propia = ranuraLector;
+		if (!propia.ocupada) {
+			for (size_t i = 0;; i = (i + 1) % MAX_HILOS_LECTORES) {
+				bool libre = false;
+				if (ranuras[i].ocupada.compare_exchange_strong(libre, true)) { propia.indice = i; break; }
+				if (i + 1 == MAX_HILOS_LECTORES) this_thread::yield(); // Todas ocupadas: se espera una
+			}
+			propia.ocupada = &ranuras[propia.indice].ocupada;
+		}
+		return ranuras[propia.indice];
 	}
-	else if (campo == 2) { // Chofer
-		sort(registros.begin(), registros.end(), [asc](const KilometrajeRecord& a, const KilometrajeRecord& b) {
-			return asc ? (a.chofer < b.chofer) : (a.chofer > b.chofer);
-			});
+
+public:
+	// Anuncia que el hilo empieza a leer (se puede anidar: solo cuenta la lectura exterior)
+	void entrar() {
+		Ranura& r = ranuraPropia();
+		if (ranuraLector.anidadas++ == 0) r.epoca.store(epocaGlobal.load()); // seq_cst: antes de leer el puntero
 	}
-	else if (campo == 3) { // Total
-		sort(registros.begin(), registros.end(), [asc](const KilometrajeRecord& a, const KilometrajeRecord& b) {
-			return asc ? (a.total < b.total) : (a.total > b.total);
-			});
+	void salir() {
+		if (--ranuraLector.anidadas == 0) ranuras[ranuraLector.indice].epoca.store(0, memory_order_release);
 	}
-	else {
-		cout << "[ADVERTENCIA] Opcion de campo invalida. No se realizo el ordenamiento.\n";
-		return;
+
+	// Época en que se retira lo que se acaba de despublicar
+	uint64_t avanzar() { return epocaGlobal.fetch_add(1); }
+
+	// Época más antigua que algún lector sigue usando (UINT64_MAX si no hay lectores)
+	uint64_t epocaMinimaActiva() const {
+		uint64_t minima = UINT64_MAX;
+		for (const Ranura& r : ranuras) {
+			uint64_t e = r.epoca.load();
+			if (e != 0) minima = min(minima, e);
+		}
+		return minima;
 	}
-	cout << "[ORDENAMIENTO] Lista ordenada por campo seleccionado " << (asc ? "ASCENDENTE" : "DESCENDENTE") << " (Temporalmente).\n";
-	mostrarRegistrosKm(registros);
-}
-// --- Operaciones de Ordenamiento ---
-void ordenarRegistrosIngreso(vector<IngresoRecord>& registros) {
-	cout << "\n======= ORDENAR REGISTROS DE INGRESO =======\n";
-	cout << "Ordenar por: 1. Camion (Texto) | 2. Chofer (Texto) | 3. Total (Numerico): ";
-	int campo = pedirEntero("");
-	cout << "¿Orden Ascendente (1) o Descendente (2)?: ";
-	int orden = pedirEntero("");
-	bool asc = (orden == 1);
+};
 
-	if (campo == 1) { // Camion
-		sort(registros.begin(), registros.end(), [asc](const IngresoRecord& a, const IngresoRecord& b) {
-			return asc ? (a.camion < b.camion) : (a.camion > b.camion);
-			});
-		cout << "[ORDENAMIENTO] Lista ordenada por Camion " << (asc ? "ASCENDENTE" : "DESCENDENTE") << " (Temporalmente).\n";
+DominioEpocas dominioEpocas;
+
+template<typename T>
+class TablaVersionada {
+public:
+	using Segmento = vector<T>;
+
+	struct Version {
+		vector<shared_ptr<const Segmento>> segmentos;
+		size_t filas = 0;
+		uint64_t numero = 0;
+
+		template<typename Funcion>
+		void recorrer(Funcion f) const {
+			for (const auto& s : segmentos) for (const T& r : *s) f(r);
+		}
+		vector<T> aplanar() const {
+			vector<T> todos;
+			todos.reserve(filas);
+			recorrer([&todos](const T& r) { todos.push_back(r); });
+			return todos;
+		}
+	};
+
+	// Vista de una versión: mientras exista, esa versión no se libera
+	class Instantanea {
+		const Version* version;
+	public:
+		explicit Instantanea(const TablaVersionada& tabla) {
+			dominioEpocas.entrar();
+			version = tabla.actual.load(); // seq_cst: después de anunciar la época
+		}
+		~Instantanea() { dominioEpocas.salir(); }
+		Instantanea(const Instantanea&) = delete;
+		Instantanea& operator=(const Instantanea&) = delete;
+		const Version& operator*() const { return *version; }
+		const Version* operator->() const { return version; }
+	};
+
+	// Acceso de escritura a una versión nueva (copia los segmentos al tocarlos)
+	class Editor {
+		friend class TablaVersionada;
+		Version nueva;
+		vector<bool> propios;             // Segmento ya copiado en esta edición
+
+		Segmento& propio(size_t s) {
+			if (!propios[s]) {
+				nueva.segmentos[s] = make_shared<Segmento>(*nueva.segmentos[s]);
+				propios[s] = true;
+			}
+			return const_cast<Segmento&>(*nueva.segmentos[s]);
+		}
+
+	public:
+		explicit Editor(const Version& base) : nueva(base), propios(base.segmentos.size(), false) {}
+
+		size_t size() const { return nueva.filas; }
+		size_t numSegmentos() const { return nueva.segmentos.size(); }
+		size_t filasSegmento(size_t s) const { return nueva.segmentos[s]->size(); }
+
+		// Recorre con permiso de editar: f(const T&) decide y 'editar' da la copia escribible
+		template<typename Funcion>
+		void recorrer(Funcion f) {
+			for (size_t s = 0; s < nueva.segmentos.size(); ++s) {
+				for (size_t i = 0; i < nueva.segmentos[s]->size(); ++i) f(s, i, (*nueva.segmentos[s])[i]);
+			}
+		}
+		T& editar(size_t segmento, size_t indice) { return propio(segmento)[indice]; }
+
+		// Quita los registros para los que 'quitar' regresa true; cuántos se quitaron
+		template<typename Condicion>
+		size_t eliminarSi(Condicion quitar) {
+			size_t antes = nueva.filas;
+			for (size_t s = 0; s < nueva.segmentos.size(); ++s) {
+				const Segmento& actual = *nueva.segmentos[s];
+				if (none_of(actual.begin(), actual.end(), quitar)) continue;
+				Segmento& seg = propio(s);
+				seg.erase(remove_if(seg.begin(), seg.end(), quitar), seg.end());
+			}
+			for (size_t s = nueva.segmentos.size(); s-- > 0;) {
+				if (!nueva.segmentos[s]->empty()) continue;
+				nueva.segmentos.erase(nueva.segmentos.begin() + s);
+				propios.erase(propios.begin() + s);
+			}
+			nueva.filas = 0;
+			for (const auto& s : nueva.segmentos) nueva.filas += s->size();
+			return antes - nueva.filas;
+		}
+
+		void agregar(T registro) {
+			if (nueva.segmentos.empty() || nueva.segmentos.back()->size() >= FILAS_POR_SEGMENTO) {
+				nueva.segmentos.push_back(make_shared<Segmento>());
+				propios.push_back(true);
+			}
+			propio(nueva.segmentos.size() - 1).push_back(move(registro));
+			++nueva.filas;
+		}
+	};
+
+private:
+	atomic<const Version*> actual;
+	mutex candadoEscritura;               // Los escritores se turnan; los lectores no lo usan
+	vector<pair<uint64_t, const Version*>> retiradas;
+	uint64_t liberadas = 0;
+
+	// Con candadoEscritura: publica 'nueva' y libera lo que ningún lector puede estar viendo
+	void publicar(Version&& nueva) {
+		nueva.numero = actual.load()->numero + 1;
+		const Version* anterior = actual.exchange(new Version(move(nueva)));
+		retiradas.emplace_back(dominioEpocas.avanzar(), anterior);
+		uint64_t minima = dominioEpocas.epocaMinimaActiva();
+		auto fin = remove_if(retiradas.begin(), retiradas.end(), [&](const pair<uint64_t, const Version*>& r) {
+			if (r.first >= minima) return false;
+			delete r.second;
+			++liberadas;
+			return true;
+		});
+		retiradas.erase(fin, retiradas.end());
 	}
-	else if (campo == 2) { // Chofer
-		sort(registros.begin(), registros.end(), [asc](const IngresoRecord& a, const IngresoRecord& b) {
-			return asc ? (a.chofer < b.chofer) : (a.chofer > b.chofer);
-			});
-		cout << "[ORDENAMIENTO] Lista ordenada por Chofer " << (asc ? "ASCENDENTE" : "DESCENDENTE") << " (Temporalmente).\n";
+
+public:
+	TablaVersionada() : actual(new Version()) {}
+	~TablaVersionada() {
+		for (auto& r : retiradas) delete r.second;
+		delete actual.load();
 	}
-	else if (campo == 3) { // Total
-		sort(registros.begin(), registros.end(), [asc](const IngresoRecord& a, const IngresoRecord& b) {
-			return asc ? (a.total < b.total) : (a.total > b.total);
-			});
-		cout << "[ORDENAMIENTO] Lista ordenada por Total " << (asc ? "ASCENDENTE" : "DESCENDENTE") << " (Temporalmente).\n";
+	TablaVersionada(const TablaVersionada&) = delete;
+	TablaVersionada& operator=(const TablaVersionada&) = delete;
+
+	Instantanea leer() const { return Instantanea(*this); }
+
+	void reemplazarTodo(vector<T>&& registros) {
+		lock_guard<mutex> guardia(candadoEscritura);
+		Version nueva;
+		for (size_t i = 0; i < registros.size(); i += FILAS_POR_SEGMENTO) {
+			size_t fin = min(registros.size(), i + FILAS_POR_SEGMENTO);
+			nueva.segmentos.push_back(make_shared<Segmento>(make_move_iterator(registros.begin() + i), make_move_iterator(registros.begin() + fin)));
+		}
+		nueva.filas = registros.size();
+		publicar(move(nueva));
 	}
-	else {
-		cout << "[ADVERTENCIA] Opcion de campo invalida. No se realizo el ordenamiento.\n";
+
+	/**
+	 * @brief Edita una copia de la versión vigente y la publica si 'f(editor)' regresa true.
+	 * Antes de publicarla, 'persistir(version)' la guarda con el turno de escritura tomado (así
+	 * se guardan en orden); si regresa false la copia se descarta y los lectores no la ven.
+	 * @return true si se publicó una versión nueva.
+	 */
+	template<typename Funcion, typename Persistir>
+	bool modificar(Funcion f, Persistir persistir) {
+		lock_guard<mutex> guardia(candadoEscritura);
+		Editor editor(*actual.load());
+		if (!f(editor) || !persistir(static_cast<const Version&>(editor.nueva))) return false;
+		publicar(move(editor.nueva));
+		return true;
 	}
-	mostrarRegistrosIngresos(registros); // Mostrar resultado
-}
 
-void ordenarRegistrosTaller(vector<TallerRecord>& registros) {
-	cout << "\n======= ORDENAR REGISTROS DE TALLER =======\n";
-	cout << "Ordenar por: 1. Camion (Texto) | 2. Taller (Texto) | 3. Total (Numerico): ";
-	int campo = pedirEntero("");
-	cout << "¿Orden Ascendente (1) o Descendente (2)?: ";
-	int orden = pedirEntero("");
-	bool asc = (orden == 1);
+	// Versiones reemplazadas que todavía esperan a algún lector
+	size_t pendientesDeLiberar() {
+		lock_guard<mutex> guardia(candadoEscritura);
+		return retiradas.size();
+	}
+	uint64_t versionesLiberadas() {
+		lock_guard<mutex> guardia(candadoEscritura);
+		return liberadas;
+	}
+};
 
-	if (campo == 1) { // Camion
-		sort(registros.begin(), registros.end(), [asc](const TallerRecord& a, const TallerRecord& b) {
-			return asc ? (a.camion < b.camion) : (a.camion > b.camion);
-			});
+// ======================= SERVIDOR DE CONSULTAS (SOCKET UNIX) =======================
+// Modo demonio: las tres tablas quedan en memoria y varios clientes locales consultan a la
+// vez por un socket Unix. Un hilo atiende todas las conexiones con epoll (sin bloquearse en
+// ninguna) y un grupo de hilos resuelve las consultas. Las lecturas usan instantáneas de las
+// tablas (ver VERSIONES DE TABLAS): ni esperan a las ediciones ni las hacen esperar.
+//
+// Protocolo: una consulta por linea, campos separados por TAB y terminada en '\n':
+//   PING
+//   ESTADO
+//   BUSCAR   <tabla> <valor> [<max>]   registros con algun campo de texto igual a <valor>
+//   TOP      <tabla> <k>               los k registros de mayor Total
+//   AGREGADO <tabla> [<camion>]        filas, suma, minimo, maximo y promedio del Total
+//   AGREGAR  <tabla> <campo>...        campos de texto y serie en el orden del CSV (Total opcional)
+//   ELIMINAR <tabla> <clave>...        todos los registros con esas claves (camion y chofer/taller)
+//   ACTUALIZAR <tabla> <clave>... <valor>...  nueva serie del primer registro con esas claves
+//   PATIO    <ENTRADA|SALIDA> <camion> <conductor>
+// <tabla> es ingresos, taller o km. La respuesta empieza con "OK <lineas> <total>\n" seguida
+// de <lineas> lineas CSV (<total> es el numero de coincidencias, puede ser mayor), o es
+// una sola linea "ERR <motivo>\n". Cada conexion recibe sus respuestas en orden.
+
+const char RUTA_SOCKET_SERVIDOR[] = "proyecto7.sock";
+const size_t MAX_LINEA_SERVIDOR = 64 * 1024;
+const size_t MAX_FILAS_RESPUESTA = 1000;
+
+struct TablasServidor {
+	TablaVersionada<IngresoRecord> ingresos;
+	TablaVersionada<TallerRecord> taller;
+	TablaVersionada<KilometrajeRecord> km;
+	mutex candadoPatio;                  // La pila del patio es la global del menu 7
+	atomic<uint64_t> consultas{ 0 };
+
+	void cargar() {
+		ingresos.reemplazarTodo(cargarCSV<IngresoRecord>());
+		mostrarResumenRechazos<IngresoRecord>(3);
+		taller.reemplazarTodo(cargarCSV<TallerRecord>());
+		mostrarResumenRechazos<TallerRecord>(3);
+		km.reemplazarTodo(cargarCSV<KilometrajeRecord>());
+		mostrarResumenRechazos<KilometrajeRecord>(3);
 	}
-	else if (campo == 2) { // Taller
-		sort(registros.begin(), registros.end(), [asc](const TallerRecord& a, const TallerRecord& b) {
-			return asc ? (a.taller < b.taller) : (a.taller > b.taller);
-			});
+	TablaVersionada<IngresoRecord>& de(const IngresoRecord*) { return ingresos; }
+	TablaVersionada<TallerRecord>& de(const TallerRecord*) { return taller; }
+	TablaVersionada<KilometrajeRecord>& de(const KilometrajeRecord*) { return km; }
+};
+
+// Respuesta en construcción: las filas se acumulan y el encabezado se antepone al final
+struct RespuestaServidor {
+	ostringstream filas;
+	size_t lineas = 0;
+
+	RespuestaServidor() { filas << fixed << setprecision(2); }
+	string terminar(uint64_t total) const { return "OK " + to_string(lineas) + " " + to_string(total) + "\n" + filas.str(); }
+	static string error(const string& motivo) { return "ERR " + motivo + "\n"; }
+};
+
+// Arma un registro con los campos del protocolo (texto y serie en el orden del CSV)
+template<typename T>
+bool registroDesdeCampos(const vector<string_view>& campos, size_t inicio, T& r, string& error) {
+	using E = EsquemaRegistro<T>;
+	const size_t numTexto = size(E::camposTexto);
+	if (campos.size() < inicio + numTexto) { error = "faltan campos de texto"; return false; }
+	for (size_t i = 0; i < numTexto; ++i) (r.*E::camposTexto[i].miembro).assign(campos[inicio + i]);
+
+	auto& serie = r.*E::serie;
+	serie.clear();
+	for (size_t k = inicio + numTexto; k < campos.size(); ++k) {
+		typename E::Valor valor{};
+		if (!convertirValor(campos[k], valor)) { error = "valor no numerico '" + string(campos[k]) + "'"; return false; }
+		serie.push_back(valor);
 	}
-	else if (campo == 3) { // Total
-		sort(registros.begin(), registros.end(), [asc](const TallerRecord& a, const TallerRecord& b) {
-			return asc ? (a.total < b.total) : (a.total > b.total);
-			});
+	if (E::longitudFija != 0 && serie.size() == E::longitudFija + 1) serie.pop_back(); // Trae el Total: se recalcula
+	if (serie.empty() || (E::longitudFija != 0 && serie.size() != E::longitudFija)) {
+		error = "se esperaban " + (E::longitudFija ? to_string(E::longitudFija) : string("1 o mas")) + " valores";
+		return false;
 	}
-	else {
-		cout << "[ADVERTENCIA] Opcion de campo invalida. No se realizo el ordenamiento.\n";
-		return;
+	r.total = sumaSerie(serie);
+	return true;
+}
+
+// Ediciones: cada una guarda la versión nueva con el turno de escritura tomado y la publica
+// solo si se guardó; si no, la tabla en memoria sigue igual al archivo y se responde ERR
+template<typename T>
+string editarTablaServidor(TablaVersionada<T>& tabla, const vector<string_view>& campos) {
+	using E = EsquemaRegistro<T>;
+	const string_view comando = campos[0];
+	RespuestaServidor respuesta;
+
+	if (comando == "AGREGAR") {
+		T nuevo;
+		string error;
+		if (!registroDesdeCampos(campos, 2, nuevo, error)) return RespuestaServidor::error(error);
+		escribirRegistroCSV(respuesta.filas, nuevo);
+		respuesta.lineas = 1;
+		size_t filas = 0;
+		bool publicado = tabla.modificar([&](typename TablaVersionada<T>::Editor& editor) {
+			editor.agregar(nuevo);
+			return true;
+		}, [&](const typename TablaVersionada<T>::Version& v) {
+			reportarFallosEscritura(); // El servidor no tiene menú: el aviso sale con el siguiente guardado
+			filas = v.filas;
+			return guardarCSV_Append(nuevo);
+		});
+		if (!publicado) return RespuestaServidor::error("no se pudo guardar '" + E::archivo + "'; la tabla no cambio");
+		return respuesta.terminar(filas);
+	}
+
+	array<string, E::claves.size()> claves;
+	if (campos.size() < 2 + claves.size()) return RespuestaServidor::error("faltan las claves");
+	for (size_t i = 0; i < claves.size(); ++i) claves[i] = string(campos[2 + i]);
+	auto persistir = [](const typename TablaVersionada<T>::Version& v) {
+		reportarFallosEscritura();
+		return guardarCSV_Sobrescribir(v.aplanar());
+	};
+	const string noGuardado = "no se pudo guardar '" + E::archivo + "'; la tabla no cambio";
+
+	if (comando == "ELIMINAR") {
+		size_t eliminados = 0;
+		bool publicado = tabla.modificar([&](typename TablaVersionada<T>::Editor& editor) {
+			editor.recorrer([&](size_t, size_t, const T& r) { if (coincideClaves(r, claves)) registroRetirado(r); });
+			eliminados = editor.eliminarSi([&claves](const T& r) { return coincideClaves(r, claves); });
+			return eliminados > 0;
+		}, persistir);
+		if (eliminados == 0) return RespuestaServidor::error("no hay registros con " + describirClaves<T>(claves));
+		if (!publicado) return RespuestaServidor::error(noGuardado);
+		return respuesta.terminar(eliminados);
+	}
+
+	if (comando == "ACTUALIZAR") {
+		// Los valores nuevos van después de las claves; se arma un registro solo para convertirlos
+		vector<string_view> conTexto(campos.begin(), campos.begin() + 2);
+		for (size_t i = 0; i < size(E::camposTexto); ++i) conTexto.emplace_back();
+		conTexto.insert(conTexto.end(), campos.begin() + 2 + claves.size(), campos.end());
+		T valores;
+		string error;
+		if (!registroDesdeCampos(conTexto, 2, valores, error)) return RespuestaServidor::error(error);
+		bool encontrado = false;
+		bool publicado = tabla.modificar([&](typename TablaVersionada<T>::Editor& editor) {
+			editor.recorrer([&](size_t s, size_t i, const T& r) {
+				if (encontrado || !coincideClaves(r, claves)) return;
+				encontrado = true;
+				registroRetirado(r);
+				T& editado = editor.editar(s, i);
+				editado.*E::serie = valores.*E::serie;
+				editado.total = valores.total;
+				registroAgregado(editado);
+				escribirRegistroCSV(respuesta.filas, editado);
+			});
+			return encontrado;
+		}, persistir);
+		if (!encontrado) return RespuestaServidor::error("no hay registros con " + describirClaves<T>(claves));
+		if (!publicado) return RespuestaServidor::error(noGuardado);
+		respuesta.lineas = 1;
+		return respuesta.terminar(1);
 	}
-	cout << "[ORDENAMIENTO] Lista ordenada por campo seleccionado " << (asc ? "ASCENDENTE" : "DESCENDENTE") << " (Temporalmente).\n";
-	mostrarRegistrosTaller(registros);
+	return RespuestaServidor::error("consulta invalida para la tabla");
 }
 
-// --------------------------- KILOMETRAJE (INSERCIÓN) ---------------------------
-
-vector<KilometrajeRecord> cargarKmCSV() {
-	vector<KilometrajeRecord> registros;
-	ifstream archivo(NOMBRE_ARCHIVO_KM);
-	if (!archivo.is_open()) return registros;
-	string linea;
-	getline(archivo, linea); // Ignorar encabezados
-
-	while (getline(archivo, linea)) {
-		stringstream ss(linea);
-		string segmento;
-		KilometrajeRecord record;
-
-		getline(ss, record.camion, ',');
-		getline(ss, record.chofer, ',');
-
-		record.km.clear();
-		while (getline(ss, segmento, ',')) {
-			try {
-				if (ss.peek() == EOF || ss.peek() == '\n') { // Último elemento es el total
-					record.total = stod(segmento);
-					break;
-				}
-				record.km.push_back(stod(segmento));
-			}
-			catch (...) { record.km.push_back(0.0); }
-		}
-		registros.push_back(record);
+template<typename T>
+string consultarTablaServidor(TablasServidor& tablas, const vector<string_view>& campos) {
+	const string_view comando = campos[0];
+	TablaVersionada<T>& tabla = tablas.de(static_cast<const T*>(nullptr));
+	if (comando == "AGREGAR" || comando == "ELIMINAR" || comando == "ACTUALIZAR") return editarTablaServidor(tabla, campos);
+
+	RespuestaServidor respuesta;
+	auto version = tabla.leer(); // Toda la consulta ve la misma versión
+	if (comando == "BUSCAR" && campos.size() >= 3) {
+		size_t maximo = campos.size() >= 4 ? strtoull(string(campos[3]).c_str(), nullptr, 10) : 50;
+		maximo = min(maximo, MAX_FILAS_RESPUESTA);
+		uint64_t total = 0;
+		version->recorrer([&](const T& r) {
+			bool coincide = false;
+			for (const auto& campo : EsquemaRegistro<T>::camposTexto) coincide = coincide || r.*campo.miembro == campos[2];
+			if (!coincide) return;
+			if (++total <= maximo) { escribirRegistroCSV(respuesta.filas, r); ++respuesta.lineas; }
+		});
+		return respuesta.terminar(total);
 	}
-	archivo.close();
-	return registros;
+	if (comando == "TOP" && campos.size() >= 3) {
+		size_t k = min<size_t>(strtoull(string(campos[2]).c_str(), nullptr, 10), MAX_FILAS_RESPUESTA);
+		k = min(k, version->filas);
+		vector<const T*> mayores;
+		mayores.reserve(version->filas);
+		version->recorrer([&mayores](const T& r) { mayores.push_back(&r); });
+		partial_sort(mayores.begin(), mayores.begin() + k, mayores.end(), [](const T* a, const T* b) { return a->total > b->total; });
+		for (size_t i = 0; i < k; ++i) escribirRegistroCSV(respuesta.filas, *mayores[i]);
+		respuesta.lineas = k;
+		return respuesta.terminar(k);
+	}
+	if (comando == "AGREGADO") {
+		const bool porCamion = campos.size() >= 3;
+		uint64_t filas = 0;
+		using Valor = typename EsquemaRegistro<T>::Valor;
+		Valor suma{}, minimo{}, maximo{};
+		version->recorrer([&](const T& r) {
+			if (porCamion && r.camion != campos[2]) return;
+			if (filas == 0 || r.total < minimo) minimo = r.total;
+			if (filas == 0 || r.total > maximo) maximo = r.total;
+			suma += r.total;
+			++filas;
+		});
+		respuesta.filas << "filas,suma,minimo,maximo,promedio\n" << filas << "," << valorImprimible(suma) << ","
+			<< valorImprimible(minimo) << "," << valorImprimible(maximo) << ","
+			<< valorImprimible(filas ? suma / static_cast<Valor>(filas) : Valor{}) << "\n";
+		respuesta.lineas = 2;
+		return respuesta.terminar(filas);
+	}
+	return RespuestaServidor::error("consulta invalida para la tabla");
 }
-void guardarKmCSV_Sobrescribir(const vector<KilometrajeRecord>& registros) {
-	ofstream archivo(NOMBRE_ARCHIVO_KM, ios::out);
-	if (archivo.is_open()) {
-		// Encabezados dinámicos
-		archivo << "Camion,Chofer";
-		if (!registros.empty()) {
-			for (size_t i = 0; i < registros[0].km.size(); ++i) {
-				archivo << ",Km_Dia_" << (i + 1);
-			}
-		}
-		else {
-			archivo << ",Km_Dia_1"; // Poner al menos uno si está vacío
-		}
-		archivo << ",Total\n";
 
-		archivo << fixed << setprecision(2);
-		for (const auto& record : registros) {
-			archivo << record.camion << "," << record.chofer;
-			for (double val : record.km) archivo << "," << val;
-			archivo << "," << record.total << "\n";
-		}
-		archivo.close();
-		cout << "[CSV ACTUALIZADO] La tabla de registros ha sido sobrescrita en '" << NOMBRE_ARCHIVO_KM << "'.\n";
+// Entrada o salida del patio; mismas reglas que el menu 7 (pila con limite de MAX_CAMIONES)
+string movimientoPatioServidor(TablasServidor& tablas, const vector<string_view>& campos) {
+	if (campos.size() < 4 || (campos[1] != "ENTRADA" && campos[1] != "SALIDA")) {
+		return RespuestaServidor::error("uso: PATIO <ENTRADA|SALIDA> <camion> <conductor>");
+	}
+	RegistroCamion movimiento;
+	movimiento.numeroCamion = string(campos[2]);
+	movimiento.conductor = string(campos[3]);
+	movimiento.tipoMovimiento = string(campos[1]);
+
+	lock_guard<mutex> guardia(tablas.candadoPatio);
+	if (movimiento.tipoMovimiento == "ENTRADA") {
+		if (camionesEnPatio.size() >= MAX_CAMIONES) return RespuestaServidor::error("el patio esta lleno");
+		MEDIR_OPERACION(RegistrarEntrada);
+		movimiento.hora = obtenerHoraActual();
+		camionesEnPatio.push(movimiento);
 	}
 	else {
-		cout << "!!! ERROR: No se pudo abrir el archivo para sobrescribir los datos.\n";
+		if (camionesEnPatio.empty()) return RespuestaServidor::error("el patio esta vacio");
+		MEDIR_OPERACION(RegistrarSalida);
+		camionesEnPatio.pop();
+		movimiento.hora = obtenerHoraActual();
 	}
-}
-void eliminarRegistroTaller(vector<TallerRecord>& registros) {
-	cout << "\n======= ELIMINAR REGISTRO DE TALLER =======\n";
-	string camion = pedirTexto("Ingrese el numero de CAMION a eliminar: ");
-	string taller = pedirTexto("Ingrese el nombre del TALLER del registro a eliminar: ");
-	size_t tam_antes = registros.size();
+	guardarMovimientoCSV(movimiento);
 
-	registros.erase(
-		remove_if(registros.begin(), registros.end(),
-			[camion, taller](const TallerRecord& r) {
-				return r.camion == camion && r.taller == taller;
-			}),
-		registros.end()
-	);
-	size_t tam_despues = registros.size();
+	RespuestaServidor respuesta;
+	respuesta.filas << movimiento.hora << "," << movimiento.numeroCamion << "," << movimiento.conductor << ","
+		<< movimiento.tipoMovimiento << "," << camionesEnPatio.size() << "\n";
+	respuesta.lineas = 1;
+	return respuesta.terminar(1);
+}
 
-	if (tam_despues < tam_antes) {
-		cout << "\n[ELIMINACION EXITOSA] Se eliminaron " << (tam_antes - tam_despues) << " registros.\n";
-		guardarTallerCSV_Sobrescribir(registros);
+string responderConsulta(TablasServidor& tablas, string_view linea) {
+	MEDIR_OPERACION(ConsultaServidor);
+	tablas.consultas.fetch_add(1, memory_order_relaxed);
+	vector<string_view> campos;
+	while (!linea.empty()) {
+		size_t tab = linea.find('\t');
+		campos.push_back(linea.substr(0, tab));
+		linea = (tab == string_view::npos) ? string_view() : linea.substr(tab + 1);
 	}
-	else {
-		cout << "\n[ADVERTENCIA] No se encontro ningun registro con Camion: " << camion << " y Taller: " << taller << ".\n";
+	if (campos.empty()) return RespuestaServidor::error("consulta vacia");
+
+	const string_view comando = campos[0];
+	if (comando == "PING") return RespuestaServidor().terminar(0);
+	if (comando == "PATIO") return movimientoPatioServidor(tablas, campos);
+	if (comando == "ESTADO") {
+		// tabla,filas,version,versiones retenidas por lectores
+		RespuestaServidor respuesta;
+		auto estado = [&respuesta](const char* nombre, auto& tabla) {
+			auto version = tabla.leer();
+			respuesta.filas << nombre << "," << version->filas << "," << version->numero << "," << tabla.pendientesDeLiberar() << "\n";
+		};
+		estado("ingresos", tablas.ingresos);
+		estado("taller", tablas.taller);
+		estado("km", tablas.km);
+		respuesta.filas << "consultas," << tablas.consultas.load(memory_order_relaxed) << "\n";
+		respuesta.lineas = 4;
+		return respuesta.terminar(4);
 	}
+	if (campos.size() < 2) return RespuestaServidor::error("falta la tabla");
+	const string ruta = rutaTablaHistorica(string(campos[1]));
+	if (ruta == NOMBRE_ARCHIVO_INGRESOS) return consultarTablaServidor<IngresoRecord>(tablas, campos);
+	if (ruta == NOMBRE_ARCHIVO_TALLER) return consultarTablaServidor<TallerRecord>(tablas, campos);
+	if (ruta == NOMBRE_ARCHIVO_KM) return consultarTablaServidor<KilometrajeRecord>(tablas, campos);
+	return RespuestaServidor::error("tabla desconocida '" + string(campos[1]) + "'");
 }
 
-void mostrarRegistrosKm(const vector<KilometrajeRecord>& registros) {
-	cout << "\n======= DATOS ACTUALES DE KILOMETRAJE (" << registros.size() << " Registros) =======\n";
-	if (registros.empty()) { cout << "No hay registros guardados para mostrar." << endl; return; }
+#ifdef __linux__
 
-	size_t maxDias = 0;
-	for (const auto& r : registros) {
-		if (r.km.size() > maxDias) maxDias = r.km.size();
-	}
+// Lo usa el manejador de SIGINT/SIGTERM para despertar al ciclo de eventos
+int avisoDetenerServidor = -1;
+volatile sig_atomic_t servidorDetenido = 0;
 
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
-	cout << "| " << left << setw(10) << "CAMION"
-		<< "| " << left << setw(15) << "CHOFER";
-	for (size_t i = 0; i < maxDias; ++i) {
-		cout << "| " << right << setw(7) << "Dia " << (i + 1);
-	}
-	cout << "| " << right << setw(10) << "TOTAL" << " |\n";
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
+void detenerServidorPorSenal(int) {
+	servidorDetenido = 1;
+	uint64_t uno = 1;
+	if (avisoDetenerServidor >= 0 && write(avisoDetenerServidor, &uno, sizeof(uno)) < 0) {}
+}
 
-	cout << fixed << setprecision(2);
-	for (const auto& record : registros) {
-		cout << "| " << left << setw(10) << record.camion
-			<< "| " << left << setw(15) << record.chofer;
+class ServidorConsultas {
+	// Identificadores de epoll: 0 es el socket que escucha, 1 el aviso de los trabajadores
+	static constexpr uint64_t ID_ESCUCHA = 0, ID_AVISO = 1;
+
+	struct Conexion {
+		int fd = -1;
+		string entrada;           // Bytes recibidos sin linea completa
+		string salida;            // Respuestas pendientes de enviar
+		deque<string> pendientes; // Consultas completas esperando a que termine la anterior
+		bool ocupada = false;     // Hay una consulta de esta conexion en un trabajador
+		bool esperaEscritura = false;
+	};
+
+	TablasServidor& tablas;
+	string ruta;
+	int escucha = -1, epoll = -1, aviso = -1;
+	uint64_t siguienteId = 2;
+	unordered_map<uint64_t, Conexion> conexiones; // Solo la toca el hilo del ciclo
+
+	mutex candadoTrabajos;
+	condition_variable hayTrabajo;
+	deque<pair<uint64_t, string>> trabajos;
+	bool detenido = false;
+	mutex candadoListos;
+	vector<pair<uint64_t, string>> listos;
+	vector<thread> trabajadores;
+
+	bool registrar(int fd, uint64_t id, uint32_t eventos, int operacion = EPOLL_CTL_ADD) {
+		epoll_event ev{};
+		ev.events = eventos;
+		ev.data.u64 = id;
+		return epoll_ctl(epoll, operacion, fd, &ev) == 0;
+	}
 
-		for (size_t i = 0; i < maxDias; ++i) {
-			if (i < record.km.size()) {
-				cout << "| " << right << setw(7) << record.km[i];
-			}
-			else {
-				cout << "| " << right << setw(7) << "-";
+	void trabajar() {
+		unique_lock<mutex> guardia(candadoTrabajos);
+		while (true) {
+			hayTrabajo.wait(guardia, [this]() { return detenido || !trabajos.empty(); });
+			if (trabajos.empty()) return;
+			auto trabajo = move(trabajos.front());
+			trabajos.pop_front();
+			guardia.unlock();
+			string respuesta = responderConsulta(tablas, trabajo.second);
+			{
+				lock_guard<mutex> guardiaListos(candadoListos);
+				listos.emplace_back(trabajo.first, move(respuesta));
 			}
+			uint64_t uno = 1;
+			if (write(aviso, &uno, sizeof(uno)) < 0) {}
+			guardia.lock();
 		}
-		cout << "| " << right << setw(10) << record.total << " |" << endl;
 	}
-	cout << "----------------------------------------------------------------------------------------------------------------\n";
-}
-
-void eliminarRegistroKm(vector<KilometrajeRecord>& registros) {
-	cout << "\n======= ELIMINAR REGISTRO DE KILOMETRAJE =======\n";
-	string camion = pedirTexto("Ingrese el numero de CAMION a eliminar: ");
-	string chofer = pedirTexto("Ingrese el nombre del CHOFER del registro a eliminar: ");
-	size_t tam_antes = registros.size();
-
-	registros.erase(
-		remove_if(registros.begin(), registros.end(),
-			[camion, chofer](const KilometrajeRecord& r) {
-				return r.camion == camion && r.chofer == chofer;
-			}),
-		registros.end()
-	);
-	size_t tam_despues = registros.size();
 
-	if (tam_despues < tam_antes) {
-		cout << "\n[ELIMINACION EXITOSA] Se eliminaron " << (tam_antes - tam_despues) << " registros.\n";
-		guardarKmCSV_Sobrescribir(registros);
-	}
-	else {
-		cout << "\n[ADVERTENCIA] No se encontro ningun registro con Camion: " << camion << " y Chofer: " << chofer << ".\n";
+	// Manda la siguiente consulta de la conexion si no tiene una en curso
+	void despachar(uint64_t id, Conexion& c) {
+		if (c.ocupada || c.pendientes.empty()) return;
+		c.ocupada = true;
+		{
+			lock_guard<mutex> guardia(candadoTrabajos);
+			trabajos.emplace_back(id, move(c.pendientes.front()));
+		}
+		c.pendientes.pop_front();
+		hayTrabajo.notify_one();
 	}
-}
 
+	void cerrar(uint64_t id) {
+		auto it = conexiones.find(id);
+		if (it == conexiones.end()) return;
+		epoll_ctl(epoll, EPOLL_CTL_DEL, it->second.fd, nullptr);
+		close(it->second.fd);
+		conexiones.erase(it); // Si tenia una consulta en curso, su respuesta se descarta al llegar
+	}
 
-// ======================= OPERACIONES AVANZADAS DE LISTA =======================
+	// Escribe lo que se pueda sin bloquear; lo que sobre espera a EPOLLOUT
+	bool enviar(uint64_t id, Conexion& c) {
+		size_t enviado = 0;
+		while (enviado < c.salida.size()) {
+			ssize_t n = send(c.fd, c.salida.data() + enviado, c.salida.size() - enviado, MSG_NOSIGNAL);
+			if (n > 0) { enviado += static_cast<size_t>(n); continue; }
+			if (n < 0 && errno == EINTR) continue;
+			if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			return false;
+		}
+		c.salida.erase(0, enviado);
+		bool esperar = !c.salida.empty();
+		if (esperar != c.esperaEscritura) {
+			c.esperaEscritura = esperar;
+			registrar(c.fd, id, EPOLLIN | EPOLLRDHUP | (esperar ? EPOLLOUT : 0u), EPOLL_CTL_MOD);
+		}
+		return true;
+	}
 
-// --- Operaciones de Búsqueda ---
-template<typename T>
-void buscarRegistro(const vector<T>& registros, const string& tipoRegistro) {
-	if (registros.empty()) { cout << "La lista esta vacia. No se puede buscar." << endl; return; }
+	bool recibir(uint64_t id, Conexion& c) {
+		char buffer[16 * 1024];
+		while (true) {
+			ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+			if (n > 0) { c.entrada.append(buffer, static_cast<size_t>(n)); continue; }
+			if (n < 0 && errno == EINTR) continue;
+			if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			return false; // 0: el cliente cerro
+		}
+		size_t inicio = 0, salto;
+		while ((salto = c.entrada.find('\n', inicio)) != string::npos) {
+			size_t fin = (salto > inicio && c.entrada[salto - 1] == '\r') ? salto - 1 : salto;
+			c.pendientes.emplace_back(c.entrada, inicio, fin - inicio);
+			inicio = salto + 1;
+		}
+		c.entrada.erase(0, inicio);
+		if (c.entrada.size() > MAX_LINEA_SERVIDOR) return false;
+		despachar(id, c);
+		return true;
+	}
 
-	cout << "\n======= BUSQUEDA DE REGISTRO (" << tipoRegistro << ") =======\n";
-	string busqueda = pedirTexto("Ingrese el valor de busqueda (Camion o Chofer/Encargado): ");
-	int count = 0;
+	void aceptar() {
+		while (true) {
+			int fd = accept4(escucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+			if (fd < 0) return; // EAGAIN: ya no hay mas en espera
+			uint64_t id = siguienteId++;
+			if (!registrar(fd, id, EPOLLIN | EPOLLRDHUP)) { close(fd); continue; }
+			conexiones[id].fd = fd;
+		}
+	}
 
-	for (const auto& r : registros) {
-		bool encontrado = false;
-		if constexpr (is_same_v<T, IngresoRecord>) {
-			if (r.camion == busqueda || r.chofer == busqueda) encontrado = true;
+	void entregarListos(vector<pair<uint64_t, string>>& entregas) {
+		uint64_t contador;
+		if (read(aviso, &contador, sizeof(contador)) < 0) {}
+		{
+			lock_guard<mutex> guardia(candadoListos);
+			swap(entregas, listos);
+		}
+		for (auto& entrega : entregas) {
+			auto it = conexiones.find(entrega.first);
+			if (it == conexiones.end()) continue;
+			Conexion& c = it->second;
+			c.ocupada = false;
+			c.salida += entrega.second;
+			despachar(entrega.first, c);
+			if (!enviar(entrega.first, c)) cerrar(entrega.first);
 		}
-		else if constexpr (is_same_v<T, TallerRecord>) {
-			if (r.camion == busqueda || r.encargado == busqueda || r.taller == busqueda) encontrado = true;
+		entregas.clear();
+	}
+
+public:
+	ServidorConsultas(TablasServidor& t, string rutaSocket) : tablas(t), ruta(move(rutaSocket)) {}
+	~ServidorConsultas() {
+		{
+			lock_guard<mutex> guardia(candadoTrabajos);
+			detenido = true;
 		}
-		else if constexpr (is_same_v<T, KilometrajeRecord>) {
-			if (r.camion == busqueda || r.chofer == busqueda) encontrado = true;
+		hayTrabajo.notify_all();
+		for (auto& t : trabajadores) t.join();
+		for (auto& par : conexiones) close(par.second.fd);
+		if (escucha >= 0) { close(escucha); unlink(ruta.c_str()); }
+		if (epoll >= 0) close(epoll);
+		if (aviso >= 0) { avisoDetenerServidor = -1; close(aviso); }
+	}
+	ServidorConsultas(const ServidorConsultas&) = delete;
+	ServidorConsultas& operator=(const ServidorConsultas&) = delete;
+
+	bool iniciar(size_t numHilos, string& error) {
+		sockaddr_un direccion{};
+		direccion.sun_family = AF_UNIX;
+		if (ruta.size() >= sizeof(direccion.sun_path)) { error = "ruta del socket demasiado larga"; return false; }
+		memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+		unlink(ruta.c_str()); // Un socket de una ejecucion anterior que no se cerro bien
+
+		escucha = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		epoll = epoll_create1(EPOLL_CLOEXEC);
+		aviso = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (escucha < 0 || epoll < 0 || aviso < 0) { error = strerror(errno); return false; }
+		if (bind(escucha, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) < 0 || listen(escucha, 128) < 0) {
+			error = string("no se pudo escuchar en '") + ruta + "': " + strerror(errno);
+			close(escucha);
+			escucha = -1;
+			return false;
 		}
+		if (!registrar(escucha, ID_ESCUCHA, EPOLLIN) || !registrar(aviso, ID_AVISO, EPOLLIN)) { error = strerror(errno); return false; }
+		avisoDetenerServidor = aviso;
+		for (size_t i = 0; i < numHilos; ++i) trabajadores.emplace_back([this]() { trabajar(); });
+		return true;
+	}
 
-		if (encontrado) {
-			cout << "\n[ENCONTRADO #" << (++count) << "]\n";
-			if constexpr (is_same_v<T, IngresoRecord>) {
-				cout << "  Camion: " << r.camion << ", Chofer: " << r.chofer << ", Total Ingresos: " << fixed << setprecision(2) << r.total << endl;
-			}
-			else if constexpr (is_same_v<T, TallerRecord>) {
-				cout << "  Camion: " << r.camion << ", Encargado: " << r.encargado << ", Taller: " << r.taller << ", Total Costos: " << fixed << setprecision(2) << r.total << endl;
-			}
-			else if constexpr (is_same_v<T, KilometrajeRecord>) {
-				cout << "  Camion: " << r.camion << ", Chofer: " << r.chofer << ", Total KM: " << fixed << setprecision(2) << r.total << endl;
+	// Atiende hasta recibir SIGINT o SIGTERM
+	void atender() {
+		epoll_event eventos[64];
+		vector<pair<uint64_t, string>> entregas;
+		while (!servidorDetenido) {
+			int n = epoll_wait(epoll, eventos, 64, -1);
+			if (n < 0 && errno != EINTR) break;
+			for (int i = 0; i < n; ++i) {
+				uint64_t id = eventos[i].data.u64;
+				if (id == ID_ESCUCHA) { aceptar(); continue; }
+				if (id == ID_AVISO) { entregarListos(entregas); continue; }
+				auto it = conexiones.find(id);
+				if (it == conexiones.end()) continue;
+				bool sigue = true;
+				if (eventos[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) sigue = recibir(id, it->second);
+				if (sigue && (eventos[i].events & EPOLLOUT)) sigue = enviar(id, it->second);
+				if (!sigue) cerrar(id);
 			}
 		}
 	}
 
-	if (count == 0) {
-		cout << "[NO ENCONTRADO] No se encontraron registros que coincidan con la busqueda: '" << busqueda << "'.\n";
+	size_t numConexiones() const { return conexiones.size(); }
+};
+
+// ---------------------- CLIENTE Y PRUEBA DE CARGA ----------------------
+
+// Conexion bloqueante de un cliente: manda una consulta y lee su respuesta completa
+class ClienteServidor {
+	int fd = -1;
+	string buffer;
+	size_t inicio = 0;
+
+	bool leerLinea(string& linea) {
+		while (true) {
+			size_t salto = buffer.find('\n', inicio);
+			if (salto != string::npos) {
+				linea.assign(buffer, inicio, salto - inicio);
+				inicio = salto + 1;
+				return true;
+			}
+			buffer.erase(0, inicio);
+			inicio = 0;
+			char bloque[16 * 1024];
+			ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+			if (n < 0 && errno == EINTR) continue;
+			if (n <= 0) return false;
+			buffer.append(bloque, static_cast<size_t>(n));
+		}
 	}
-	else {
-		cout << "\n[RESUMEN] Se encontraron " << count << " registros coincidentes.\n";
+
+public:
+	~ClienteServidor() { if (fd >= 0) close(fd); }
+
+	bool conectar(const string& ruta, string& error) {
+		sockaddr_un direccion{};
+		direccion.sun_family = AF_UNIX;
+		if (ruta.size() >= sizeof(direccion.sun_path)) { error = "ruta del socket demasiado larga"; return false; }
+		memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+		fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) < 0) {
+			error = string("no se pudo conectar a '") + ruta + "': " + strerror(errno);
+			return false;
+		}
+		return true;
 	}
-}
 
-// --- Operaciones de Actualización ---
-void actualizarRegistroIngreso(vector<IngresoRecord>& registros) {
-	cout << "\n======= ACTUALIZAR REGISTRO DE INGRESO =======\n";
-	string camion = pedirTexto("Ingrese el numero de CAMION a actualizar: ");
-	string chofer = pedirTexto("Ingrese el nombre del CHOFER a actualizar: ");
+	// 'respuesta' recibe el encabezado y las lineas; false si se perdio la conexion
+	bool consultar(const string& consulta, string& respuesta, bool& exito) {
+		string linea = consulta + "\n";
+		for (size_t enviado = 0; enviado < linea.size();) {
+			ssize_t n = send(fd, linea.data() + enviado, linea.size() - enviado, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR) continue;
+			if (n <= 0) return false;
+			enviado += static_cast<size_t>(n);
+		}
+		if (!leerLinea(linea)) return false;
+		respuesta = linea + "\n";
+		exito = linea.rfind("OK ", 0) == 0;
+		size_t lineas = exito ? strtoull(linea.c_str() + 3, nullptr, 10) : 0;
+		for (size_t i = 0; i < lineas; ++i) {
+			if (!leerLinea(linea)) return false;
+			respuesta += linea;
+			respuesta += '\n';
+		}
+		return true;
+	}
+};
 
-	auto it = find_if(registros.begin(), registros.end(),
-		[camion, chofer](const IngresoRecord& r) {
-			return r.camion == camion && r.chofer == chofer;
-		});
+#endif // __linux__
 
-	if (it != registros.end()) {
-		cout << "[ENCONTRADO] Actualizando registro de Camion: " << camion << ", Chofer: " << chofer << endl;
-		IngresoRecord& r = *it;
+// Las consultas de la linea de comandos usan '|' en lugar de TAB para poder escribirlas en la terminal
+string consultaDesdeArgumento(string texto) {
+	replace(texto.begin(), texto.end(), '|', '\t');
+	return texto;
+}
 
-		for (size_t i = 0; i < r.ingresos.size(); ++i) {
-			r.ingresos[i] = pedirDouble("  Nuevo ingreso para Dia " + to_string(i + 1) + " (Anterior: " + to_string(r.ingresos[i]) + "): ");
+// Modo de linea de comandos: Proyecto7.0 --servidor [--socket <ruta>] [--hilos <n>]
+int ejecutarServidor(int argc, char* argv[]) {
+	string ruta = RUTA_SOCKET_SERVIDOR;
+	size_t hilos = hilosBloques();
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--socket" && tieneValor) ruta = argv[++i];
+		else if (arg == "--hilos" && tieneValor) hilos = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else {
+			cout << "Uso: Proyecto7.0 --servidor [--socket <ruta>] [--hilos <n>]\n";
+			return 1;
 		}
-
-		r.total = sumaValores(r.ingresos);
-		guardarIngresosCSV_Sobrescribir(registros);
-		cout << "[ACTUALIZACION EXITOSA] Total recalculado: " << fixed << setprecision(2) << r.total << endl;
 	}
-	else {
-		cout << "[ADVERTENCIA] No se encontro el registro para actualizar.\n";
+#ifdef __linux__
+	TablasServidor tablas;
+	auto inicio = chrono::steady_clock::now();
+	tablas.cargar();
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+	ServidorConsultas servidor(tablas, ruta);
+	string error;
+	if (!servidor.iniciar(hilos, error)) {
+		cout << "!!! ERROR: " << error << "\n";
+		return 1;
 	}
+	signal(SIGINT, detenerServidorPorSenal);
+	signal(SIGTERM, detenerServidorPorSenal);
+	cout << "[SERVIDOR] " << tablas.ingresos.leer()->filas << " ingresos, " << tablas.taller.leer()->filas << " taller y "
+		<< tablas.km.leer()->filas << " km cargados en " << fixed << setprecision(2) << segundos << " s.\n"
+		<< "[SERVIDOR] Escuchando en '" << ruta << "' con " << hilos << " hilos (Ctrl+C para detener).\n" << flush;
+	servidor.atender();
+	if (!escritorArchivos.sincronizar()) {
+		reportarFallosEscritura();
+		cout << "!!! ERROR: Algunos cambios no se pudieron escribir en disco.\n";
+	}
+	cout << "[SERVIDOR] Detenido despues de " << tablas.consultas.load() << " consultas.\n";
+	return 0;
+#else
+	cout << "[ADVERTENCIA] El modo servidor usa epoll y sockets Unix; solo esta disponible en Linux.\n";
+	return 1;
+#endif
 }
 
-void actualizarRegistroTaller(vector<TallerRecord>& registros) {
-	cout << "\n======= ACTUALIZAR REGISTRO DE TALLER =======\n";
-	string camion = pedirTexto("Ingrese el numero de CAMION a actualizar: ");
-	string taller = pedirTexto("Ingrese el nombre del TALLER a actualizar: ");
-
-	auto it = find_if(registros.begin(), registros.end(),
-		[camion, taller](const TallerRecord& r) {
-			return r.camion == camion && r.taller == taller;
-		});
-
-	if (it != registros.end()) {
-		cout << "[ENCONTRADO] Actualizando registro de Camion: " << camion << ", Taller: " << taller << endl;
-		TallerRecord& r = *it;
-
-		for (size_t i = 0; i < r.costos.size(); ++i) {
-			r.costos[i] = pedirDouble("  Nuevo costo para Visita " + to_string(i + 1) + " (Anterior: " + to_string(r.costos[i]) + "): ");
+/**
+ * @brief Modos de linea de comandos del cliente:
+ *   --cliente [--socket <ruta>] <consulta>          (campos separados por '|'; imprime la respuesta)
+ *   --carga-servidor [--socket <ruta>] [--clientes <n>] [--segundos <s>] [--consulta <c>]...
+ * La prueba de carga reparte las consultas (en ronda) entre 'n' conexiones que esperan cada
+ * respuesta antes de mandar la siguiente, e informa consultas por segundo y latencias.
+ */
+int ejecutarClienteServidor(int argc, char* argv[]) {
+	const bool carga = string(argv[1]) == "--carga-servidor";
+	string ruta = RUTA_SOCKET_SERVIDOR;
+	size_t clientes = 8;
+	double segundos = 5;
+	vector<string> consultas;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--socket" && tieneValor) ruta = argv[++i];
+		else if (carga && arg == "--clientes" && tieneValor) clientes = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (carga && arg == "--segundos" && tieneValor) segundos = max(0.1, atof(argv[++i]));
+		else if (carga && arg == "--consulta" && tieneValor) consultas.push_back(consultaDesdeArgumento(argv[++i]));
+		else if (!carga && arg.rfind("--", 0) != 0) consultas.push_back(consultaDesdeArgumento(arg));
+		else {
+			cout << "Uso: Proyecto7.0 --cliente [--socket <ruta>] <consulta>\n"
+				<< "     Proyecto7.0 --carga-servidor [--socket <ruta>] [--clientes <n>] [--segundos <s>] [--consulta <c>]...\n"
+				<< "     (campos de la consulta separados por '|', ej. \"BUSCAR|ingresos|100|10\")\n";
+			return 1;
 		}
-		r.encargado = pedirTexto("  Nuevo nombre del Encargado (Anterior: " + r.encargado + "): ");
+	}
+#ifdef __linux__
+	string error;
+	if (!carga) {
+		if (consultas.size() != 1) { cout << "!!! ERROR: indique una consulta.\n"; return 1; }
+		ClienteServidor cliente;
+		string respuesta;
+		bool exito = false;
+		if (!cliente.conectar(ruta, error)) { cout << "!!! ERROR: " << error << "\n"; return 1; }
+		if (!cliente.consultar(consultas[0], respuesta, exito)) { cout << "!!! ERROR: se perdio la conexion.\n"; return 1; }
+		cout << respuesta;
+		return exito ? 0 : 2;
+	}
 
-		r.total = sumaValores(r.costos);
-		guardarTallerCSV_Sobrescribir(registros);
-		cout << "[ACTUALIZACION EXITOSA] Total recalculado: " << fixed << setprecision(2) << r.total << endl;
+	if (consultas.empty()) {
+		consultas = { "PING", "BUSCAR\tingresos\t100\t10", "TOP\tingresos\t10", "AGREGADO\tkm\t100", "AGREGADO\ttaller" };
 	}
-	else {
-		cout << "[ADVERTENCIA] No se encontro el registro para actualizar.\n";
+	struct ResultadoCliente {
+		vector<uint64_t> nanos;
+		uint64_t errores = 0;
+		bool desconectado = false;
+	};
+	vector<ResultadoCliente> resultados(clientes);
+	vector<thread> hilos;
+	atomic<bool> fallo{ false };
+	const auto inicio = chrono::steady_clock::now();
+	const auto limite = inicio + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(segundos));
+	for (size_t c = 0; c < clientes; ++c) {
+		hilos.emplace_back([&, c]() {
+			ResultadoCliente& resultado = resultados[c];
+			ClienteServidor cliente;
+			string errorConexion, respuesta;
+			if (!cliente.conectar(ruta, errorConexion)) {
+				if (!fallo.exchange(true)) cout << "!!! ERROR: " << errorConexion << "\n";
+				resultado.desconectado = true;
+				return;
+			}
+			for (size_t i = c; chrono::steady_clock::now() < limite; ++i) {
+				bool exito = false;
+				auto antes = chrono::steady_clock::now();
+				if (!cliente.consultar(consultas[i % consultas.size()], respuesta, exito)) { resultado.desconectado = true; return; }
+				resultado.nanos.push_back(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - antes).count()));
+				if (!exito) ++resultado.errores;
+			}
+		});
 	}
+	for (auto& h : hilos) h.join();
+	double transcurrido = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+	vector<uint64_t> nanos;
+	uint64_t errores = 0, desconectados = 0;
+	for (auto& r : resultados) {
+		nanos.insert(nanos.end(), r.nanos.begin(), r.nanos.end());
+		errores += r.errores;
+		desconectados += r.desconectado;
+	}
+	if (nanos.empty()) { cout << "!!! ERROR: no se completo ninguna consulta.\n"; return 1; }
+	sort(nanos.begin(), nanos.end());
+	auto percentil = [&nanos](double fraccion) {
+		size_t i = static_cast<size_t>(ceil(fraccion * nanos.size()));
+		return nanos[min(nanos.size() - 1, i ? i - 1 : 0)] / 1e3;
+	};
+	FormatoFlujo formato(cout);
+	cout << "\n======= PRUEBA DE CARGA DEL SERVIDOR =======\n"
+		<< clientes << " clientes, " << consultas.size() << " consultas distintas, " << fixed << setprecision(2) << transcurrido << " s\n"
+		<< "Consultas: " << nanos.size() << " (" << errores << " con ERR, " << desconectados << " conexiones perdidas)\n"
+		<< "QPS: " << setprecision(0) << nanos.size() / transcurrido << "\n" << setprecision(1)
+		<< "Latencia (us): p50 " << percentil(0.50) << " | p90 " << percentil(0.90) << " | p99 " << percentil(0.99)
+		<< " | p99.9 " << percentil(0.999) << " | max " << nanos.back() / 1e3 << "\n";
+	return desconectados ? 1 : 0;
+#else
+	(void)clientes; (void)segundos;
+	cout << "[ADVERTENCIA] El cliente del servidor usa sockets Unix; solo esta disponible en Linux.\n";
+	return 1;
+#endif
 }
 
-void actualizarRegistroKm(vector<KilometrajeRecord>& registros) {
-	cout << "\n======= ACTUALIZAR REGISTRO DE KILOMETRAJE =======\n";
-	string camion = pedirTexto("Ingrese el numero de CAMION a actualizar: ");
-	string chofer = pedirTexto("Ingrese el nombre del CHOFER a actualizar: ");
 
-	auto it = find_if(registros.begin(), registros.end(),
-		[camion, chofer](const KilometrajeRecord& r) {
-			return r.camion == camion && r.chofer == chofer;
-		});
+// ======================= GENERADOR DE DATOS SINTÉTICOS (PRUEBAS DE CARGA) =======================
+// Modo de linea de comandos: Proyecto7.0 --generar-datos [opciones]
+// Escribe los cuatro CSV con exactamente el formato de las funciones guardar*,
+// de forma determinista a partir de una semilla, para dimensionar el hardware.
 
-	if (it != registros.end()) {
-		cout << "[ENCONTRADO] Actualizando registro de Camion: " << camion << ", Chofer: " << chofer << endl;
-		KilometrajeRecord& r = *it;
+// Los archivos se escriben en binario; en Windows se respeta el salto de linea de ofstream.
+#ifdef _WIN32
+const char SALTO_LINEA_CSV[] = "\r\n";
+#else
+const char SALTO_LINEA_CSV[] = "\n";
+#endif
 
-		for (size_t i = 0; i < r.km.size(); ++i) {
-			r.km[i] = pedirDouble("  Nuevo KM para Dia " + to_string(i + 1) + " (Anterior: " + to_string(r.km[i]) + "): ");
-		}
+struct OpcionesGenerador {
+	string directorio = ".";
+	uint64_t semilla = 20250101;
+	uint64_t filas = 1000000;        // Filas por tabla (limite)
+	uint64_t bytesPorTabla = 0;      // 0 = sin limite de tamaño (solo filas)
+	size_t numCamiones = 2000;
+	size_t numChoferes = 3000;
+};
+
+// Generador SplitMix64: rapido, de 64 bits y reproducible en cualquier plataforma.
+struct GeneradorAleatorio {
+	uint64_t estado;
 
-		r.total = sumaValores(r.km);
-		guardarKmCSV_Sobrescribir(registros);
-		cout << "[ACTUALIZACION EXITOSA] Total recalculado: " << fixed << setprecision(2) << r.total << endl;
+	explicit GeneradorAleatorio(uint64_t semilla) : estado(semilla) {}
+
+	uint64_t siguiente() {
+		uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
 	}
-	else {
-		cout << "[ADVERTENCIA] No se encontro el registro para actualizar.\n";
+	// Uniforme en [0, 1)
+	double uniforme() {
+		return (siguiente() >> 11) * (1.0 / 9007199254740992.0);
 	}
-}
-// ---------- MÉTODO BURBUJA (Adaptado para List Menu) ----------
-void burbujaDesc(vector<double>& ingresos) {
-	for (size_t i = 0; i < ingresos.size() - 1; i++) {
-		for (size_t j = 0; j < ingresos.size() - i - 1; j++) {
-			if (ingresos[j] < ingresos[j + 1]) {
-				swap(ingresos[j], ingresos[j + 1]);
-			}
+	// Entero uniforme en [minimo, maximo] (ancho menor a 2^32; multiplicacion en lugar de modulo)
+	int64_t rango(int64_t minimo, int64_t maximo) {
+		uint64_t ancho = static_cast<uint64_t>(maximo - minimo) + 1;
+		return minimo + static_cast<int64_t>(((siguiente() >> 32) * ancho) >> 32);
+	}
+};
+
+// Distribucion Zipf (sesgada): pocos camiones/choferes concentran la mayoria de las filas.
+// Se muestrea en O(1) con el metodo de alias de Vose.
+class DistribucionZipf {
+	vector<double> probabilidad;
+	vector<uint32_t> alias;
+public:
+	DistribucionZipf(size_t n, double exponente) : probabilidad(n), alias(n) {
+		vector<double> pesos(n);
+		double suma = 0.0;
+		for (size_t k = 0; k < n; ++k) {
+			pesos[k] = 1.0 / pow(static_cast<double>(k + 1), exponente);
+			suma += pesos[k];
+		}
+		vector<uint32_t> chicos, grandes;
+		for (size_t k = 0; k < n; ++k) {
+			pesos[k] = pesos[k] * n / suma;
+			(pesos[k] < 1.0 ? chicos : grandes).push_back(static_cast<uint32_t>(k));
 		}
+		while (!chicos.empty() && !grandes.empty()) {
+			uint32_t c = chicos.back(); chicos.pop_back();
+			uint32_t g = grandes.back();
+			probabilidad[c] = pesos[c];
+			alias[c] = g;
+			pesos[g] -= 1.0 - pesos[c];
+			if (pesos[g] < 1.0) { grandes.pop_back(); chicos.push_back(g); }
+		}
+		for (uint32_t k : grandes) { probabilidad[k] = 1.0; alias[k] = k; }
+		for (uint32_t k : chicos) { probabilidad[k] = 1.0; alias[k] = k; }
 	}
-}
-// ======================= METODOS DE ORDENAMIENTO (CASE 6) =======================
+	size_t muestra(GeneradorAleatorio& rng) const {
+		size_t k = static_cast<size_t>(rng.rango(0, static_cast<int64_t>(probabilidad.size()) - 1));
+		return rng.uniforme() < probabilidad[k] ? k : alias[k];
+	}
+};
 
-string obtenerNombreDia(int indice, const vector<string>& diasSemana, bool esSemanaActual) {
-	if (esSemanaActual && indice >= 0 && indice < diasSemana.size()) {
-		return diasSemana[indice];
+/**
+ * @brief Escritura secuencial con un buffer grande propio (evita el formateo de iostream).
+ * Los montos se manejan en centavos para que el Total sea exactamente la suma de lo impreso.
+ */
+class EscritorBufferado {
+	FILE* archivo;
+	vector<char> buffer;
+	size_t usado = 0;
+	uint64_t escritos = 0;
+	bool fallo = false;           // Algún fwrite o el fclose no escribió todo (disco lleno, cuota, E/S)
+public:
+	explicit EscritorBufferado(const string& ruta, size_t capacidad = 8 << 20)
+		: archivo(fopen(ruta.c_str(), "wb")), buffer(capacidad) {}
+	~EscritorBufferado() { cerrar(); }
+
+	bool abierto() const { return archivo != nullptr; }
+	bool fallido() const { return fallo; }
+	uint64_t bytesEscritos() const { return escritos + usado; }
+
+	void vaciar() {
+		if (archivo && usado > 0 && fwrite(buffer.data(), 1, usado, archivo) != usado) fallo = true;
+		escritos += usado;
+		usado = 0;
 	}
-	return "Dia " + to_string(indice + 1);
-}
-// Se mantiene la funcion de guardar original para APPENDAR el registro (solo para Burbuja)
-void guardarIngresosCSV_Append(string camion, string chofer, const vector<double>& ingresos, double total) {
-	const string nombreArchivo = NOMBRE_ARCHIVO_INGRESOS;
-	bool archivoVacio = false;
-	ifstream verificar(nombreArchivo);
-	if (verificar.is_open()) {
-		verificar.seekg(0, ios::end);
-		if (verificar.tellg() == 0) archivoVacio = true;
-		verificar.close();
+	// false si alguna escritura o el cierre fallaron: el archivo quedó incompleto
+	bool cerrar() {
+		if (!archivo) return !fallo;
+		vaciar();
+		if (fclose(archivo) != 0) fallo = true;
+		archivo = nullptr;
+		return !fallo;
 	}
-	else {
-		archivoVacio = true;
+	// Garantiza espacio contiguo para 'n' bytes
+	void reservar(size_t n) {
+		if (usado + n > buffer.size()) vaciar();
 	}
-
-	ofstream archivo(nombreArchivo, ios::app);
-	if (archivo.is_open()) {
-		if (archivoVacio) {
-			archivo << "Camion,Chofer,Dia_1,Dia_2,Dia_3,Dia_4,Dia_5,Dia_6,Dia_7,Total\n";
+	void texto(const string& s) {
+		reservar(s.size());
+		memcpy(buffer.data() + usado, s.data(), s.size());
+		usado += s.size();
+	}
+	void texto(const char* s) {
+		size_t n = strlen(s);
+		reservar(n);
+		memcpy(buffer.data() + usado, s, n);
+		usado += n;
+	}
+	void caracter(char c) {
+		reservar(1);
+		buffer[usado++] = c;
+	}
+	void entero(uint64_t valor, int anchoMinimo = 1) {
+		// Dos digitos por iteracion con tabla "00".."99"
+		static const char DIGITOS[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+		char tmp[24];
+		int n = 24;
+		while (valor >= 100) {
+			size_t par = (valor % 100) * 2;
+			valor /= 100;
+			tmp[--n] = DIGITOS[par + 1];
+			tmp[--n] = DIGITOS[par];
 		}
-		archivo << fixed << setprecision(2);
-		archivo << camion << "," << chofer;
-		for (double val : ingresos) archivo << "," << val;
-		archivo << "," << total << "\n";
-		archivo.close();
+		if (valor >= 10) {
+			tmp[--n] = DIGITOS[valor * 2 + 1];
+			tmp[--n] = DIGITOS[valor * 2];
+		}
+		else {
+			tmp[--n] = static_cast<char>('0' + valor);
+		}
+		while (24 - n < anchoMinimo) tmp[--n] = '0';
+		reservar(24 - n);
+		memcpy(buffer.data() + usado, tmp + n, 24 - n);
+		usado += 24 - n;
 	}
-	else {
-		cout << "No se pudo abrir el archivo para guardar los datos.\n";
+	// Equivalente a 'fixed << setprecision(2)' para montos no negativos en centavos
+	void centavos(uint64_t valor) {
+		entero(valor / 100);
+		caracter('.');
+		entero(valor % 100, 2);
 	}
-}
-
-void metodoBurbuja() {
-	string camion, chofer;
-	cout << "\n======= METODO BURBUJA: REGISTRO DE INGRESOS (ORDENAMIENTO DESCENDENTE) =======\n";
-	cout << "Ingrese el numero de camion: ";
-	cin >> camion;
-	limpiarBuffer();
-	cout << "Ingrese el nombre del chofer: ";
-	getline(cin, chofer);
-
-	vector<double> ingresos(7);
-	char resp;
-	cout << "¿Los ingresos corresponden a los 7 dias de una semana actual (Lunes a Domingo)? (S/N): ";
-	cin >> resp;
-	limpiarBuffer();
+	void finLinea() { texto(SALTO_LINEA_CSV); }
+};
 
-	bool esSemanaActual = (toupper(resp) == 'S');
-	vector<string> diasSemana = { "Lunes", "Martes", "Miercoles", "Jueves", "Viernes", "Sabado", "Domingo" };
+// Catalogos para construir nombres realistas
+const char* const NOMBRES_GEN[] = { "Juan", "Maria", "Jose", "Ana", "Luis", "Carmen", "Carlos", "Laura", "Jorge", "Rosa",
+	"Miguel", "Elena", "Pedro", "Sofia", "Raul", "Lucia", "Arturo", "Patricia", "Hector", "Diana" };
+const char* const APELLIDOS_GEN[] = { "Perez", "Garcia", "Lopez", "Martinez", "Hernandez", "Gonzalez", "Ramirez", "Torres",
+	"Flores", "Rivera", "Gomez", "Diaz", "Cruz", "Morales", "Ortiz", "Reyes", "Castillo", "Vargas", "Mendoza", "Ruiz" };
+const char* const TALLERES_GEN[] = { "Taller Norte", "Taller Sur", "Diesel Express", "Frenos del Valle", "Mecanica Central",
+	"Servicio Pesado", "Llantas y Mas", "Motores Padilla", "Taller Montano", "Refacciones Rubio" };
+
+string nombrePersonaSintetico(size_t indice) {
+	const size_t nN = size(NOMBRES_GEN), nA = size(APELLIDOS_GEN);
+	string nombre = string(NOMBRES_GEN[indice % nN]) + " " + APELLIDOS_GEN[(indice / nN) % nA];
+	size_t resto = indice / (nN * nA);
+	if (resto > 0) nombre += string(" ") + APELLIDOS_GEN[(resto - 1) % nA];
+	if (resto > nA) nombre += " " + to_string(resto / nA);
+	return nombre;
+}
 
-	cout << "\nIngrese los ingresos por cada dia de la semana:\n";
-	for (size_t i = 0; i < ingresos.size(); i++) {
-		ingresos[i] = pedirDouble(obtenerNombreDia(i, diasSemana, esSemanaActual) + " (" + to_string(i + 1) + "): ");
+// Catalogo comun a las cuatro tablas (mismos camiones y choferes en todas)
+struct CatalogoSintetico {
+	vector<string> camiones;
+	vector<string> choferes;
+	vector<size_t> choferPrincipal; // Chofer habitual de cada camion
+	DistribucionZipf zipfCamiones;
+	DistribucionZipf zipfChoferes;
+
+	CatalogoSintetico(const OpcionesGenerador& op)
+		: zipfCamiones(op.numCamiones, 1.1), zipfChoferes(op.numChoferes, 1.05) {
+		GeneradorAleatorio rng(op.semilla ^ 0xC0FFEEULL);
+		for (size_t i = 0; i < op.numCamiones; ++i) {
+			camiones.push_back(to_string(100 + i));
+			choferPrincipal.push_back(static_cast<size_t>(rng.rango(0, op.numChoferes - 1)));
+		}
+		for (size_t i = 0; i < op.numChoferes; ++i) choferes.push_back(nombrePersonaSintetico(i));
 	}
-
-	double total = sumaValores(ingresos);
-	burbujaDesc(ingresos); // Ordenar
-
-	cout << "\n======= INGRESOS ORDENADOS (MAYOR A MENOR) =======\n";
-	cout << "Camion: " << camion << ", Chofer: " << chofer << endl;
-	cout << fixed << setprecision(2);
-	cout << "Dia\t\tIngreso\n";
-	for (size_t i = 0; i < ingresos.size(); i++) {
-		cout << obtenerNombreDia(i, diasSemana, esSemanaActual) << "\t" << ingresos[i] << "\n";
+	size_t camion(GeneradorAleatorio& rng) const { return zipfCamiones.muestra(rng); }
+	// El 85% de las veces maneja el chofer habitual; si no, uno cualquiera (sesgado)
+	const string& choferDe(size_t camion, GeneradorAleatorio& rng) const {
+		if (rng.uniforme() < 0.85) return choferes[choferPrincipal[camion]];
+		return choferes[zipfChoferes.muestra(rng)];
 	}
-	cout << "---------------------------------\nTOTAL:\t\t" << total << "\n";
-
-	// 1. Guardar el registro en el archivo CSV (APPEND)
-	guardarIngresosCSV_Append(camion, chofer, ingresos, total);
-	cout << "Registro guardado en '" << NOMBRE_ARCHIVO_INGRESOS << "'.\n";
+};
 
-	// 2. Mostrar el menu de listas inmediatamente
-	limpiarPantalla();
-	menuListaIngresosCompleto("METODO BURBUJA");
+bool limiteAlcanzado(const OpcionesGenerador& op, uint64_t filas, const EscritorBufferado& out) {
+	if (filas >= op.filas || out.fallido()) return true;
+	return op.bytesPorTabla > 0 && out.bytesEscritos() >= op.bytesPorTabla;
 }
 
-// ---------- MÉTODO SELECCIÓN (Adaptado para List Menu) ----------
-void seleccionAsc(vector<double>& costos) {
-	for (size_t i = 0; i < costos.size() - 1; i++) {
-		size_t minIndex = i;
-		for (size_t j = i + 1; j < costos.size(); j++) {
-			if (costos[j] < costos[minIndex]) minIndex = j;
-		}
-		swap(costos[i], costos[minIndex]);
+// Serie de montos en centavos con longitud fija o variable (escribe la fila completa)
+template<typename GenValor>
+void escribirSerie(EscritorBufferado& out, size_t longitud, GenValor generarValor) {
+	uint64_t total = 0;
+	for (size_t i = 0; i < longitud; ++i) {
+		uint64_t v = generarValor();
+		total += v;
+		out.caracter(',');
+		out.centavos(v);
 	}
+	out.caracter(',');
+	out.centavos(total);
+	out.finLinea();
 }
 
-void guardarTallerCSV_Append(string camion, string encargado, string taller, const vector<double>& costos, double total) {
-	const string nombreArchivo = NOMBRE_ARCHIVO_TALLER;
-	bool archivoVacio = false;
-	ifstream verificar(nombreArchivo);
-	if (verificar.is_open()) {
-		verificar.seekg(0, ios::end);
-		if (verificar.tellg() == 0) archivoVacio = true;
-		verificar.close();
-	}
-	else {
-		archivoVacio = true;
+// Longitud de serie con distribucion geometrica truncada a [1, maximo]
+size_t longitudGeometrica(GeneradorAleatorio& rng, double p, size_t maximo) {
+	size_t n = 1;
+	while (n < maximo && rng.uniforme() > p) ++n;
+	return n;
+}
+
+bool generarIngresosSinteticos(const OpcionesGenerador& op, const CatalogoSintetico& cat, const string& ruta, uint64_t& filas) {
+	EscritorBufferado out(ruta);
+	if (!out.abierto()) return false;
+	GeneradorAleatorio rng(op.semilla * 4 + 1);
+	out.texto("Camion,Chofer,Semana,Dia_1,Dia_2,Dia_3,Dia_4,Dia_5,Dia_6,Dia_7,Total");
+	out.finLinea();
+	while (!limiteAlcanzado(op, filas, out)) {
+		size_t c = cat.camion(rng);
+		out.texto(cat.camiones[c]);
+		out.caracter(',');
+		out.texto(cat.choferDe(c, rng));
+		// Semanas de 2024 y 2025 (ambos años tienen 52 semanas ISO)
+		int64_t k = rng.rango(0, 103);
+		out.caracter(',');
+		out.entero(2024 + k / 52, 4);
+		out.texto("-W");
+		out.entero(k % 52 + 1, 2);
+		// Ingreso diario de 0 a 25,000.00 con dias sin servicio (~10%)
+		escribirSerie(out, 7, [&rng]() -> uint64_t {
+			return rng.uniforme() < 0.10 ? 0 : static_cast<uint64_t>(rng.rango(150000, 2500000));
+		});
+		++filas;
 	}
+	return out.cerrar();
+}
 
-	ofstream archivo(nombreArchivo, ios::app);
-	if (archivo.is_open()) {
-		if (archivoVacio) {
-			archivo << "Camion,Encargado,Taller";
-			for (size_t i = 1; i <= costos.size(); ++i) archivo << ",Costo_" << i;
-			archivo << ",Total\n";
+bool generarTallerSintetico(const OpcionesGenerador& op, const CatalogoSintetico& cat, const string& ruta, uint64_t& filas) {
+	EscritorBufferado out(ruta);
+	if (!out.abierto()) return false;
+	GeneradorAleatorio rng(op.semilla * 4 + 2);
+	while (!limiteAlcanzado(op, filas, out)) {
+		size_t visitas = longitudGeometrica(rng, 0.35, 12);
+		// Como guardarTallerCSV_Sobrescribir: el encabezado se dimensiona con el primer registro
+		if (filas == 0) {
+			out.texto("Camion,Encargado,Taller");
+			for (size_t i = 1; i <= visitas; ++i) { out.texto(",Costo_"); out.entero(i); }
+			out.texto(",Total");
+			out.finLinea();
 		}
-		archivo << fixed << setprecision(2);
-		archivo << camion << "," << encargado << "," << taller;
-		for (double val : costos) archivo << "," << val;
-		archivo << "," << total << "\n";
-		archivo.close();
-	}
-	else {
-		cout << "No se pudo abrir el archivo para guardar los datos.\n";
+		size_t c = cat.camion(rng);
+		out.texto(cat.camiones[c]);
+		out.caracter(',');
+		out.texto(cat.choferes[cat.zipfChoferes.muestra(rng)]);
+		out.caracter(',');
+		out.texto(TALLERES_GEN[rng.rango(0, size(TALLERES_GEN) - 1)]);
+		// Costos de 500.00 a 60,000.00 con cola pesada (reparaciones mayores)
+		escribirSerie(out, visitas, [&rng]() -> uint64_t {
+			uint64_t base = static_cast<uint64_t>(rng.rango(50000, 800000));
+			return rng.uniforme() < 0.05 ? base * 7 : base;
+		});
+		++filas;
 	}
+	return out.cerrar();
 }
-// --------------------------- TALLER (SELECCIÓN) ---------------------------
 
-vector<TallerRecord> cargarTallerCSV() {
-	vector<TallerRecord> registros;
-	ifstream archivo(NOMBRE_ARCHIVO_TALLER);
-	if (!archivo.is_open()) return registros;
-	string linea;
-	getline(archivo, linea); // Ignorar encabezados
-
-	while (getline(archivo, linea)) {
-		stringstream ss(linea);
-		string segmento;
-		TallerRecord record;
-
-		getline(ss, record.camion, ',');
-		getline(ss, record.encargado, ',');
-		getline(ss, record.taller, ',');
-
-		record.costos.clear();
-		while (getline(ss, segmento, ',')) {
-			try {
-				if (ss.peek() == EOF || ss.peek() == '\n') { // Último elemento es el total
-					record.total = stod(segmento);
-					break;
-				}
-				record.costos.push_back(stod(segmento));
-			}
-			catch (...) { record.costos.push_back(0.0); }
+bool generarKmSintetico(const OpcionesGenerador& op, const CatalogoSintetico& cat, const string& ruta, uint64_t& filas) {
+	EscritorBufferado out(ruta);
+	if (!out.abierto()) return false;
+	GeneradorAleatorio rng(op.semilla * 4 + 3);
+	while (!limiteAlcanzado(op, filas, out)) {
+		size_t dias = longitudGeometrica(rng, 0.08, 31);
+		if (filas == 0) {
+			out.texto("Camion,Chofer");
+			for (size_t i = 1; i <= dias; ++i) { out.texto(",Km_Dia_"); out.entero(i); }
+			out.texto(",Total");
+			out.finLinea();
 		}
-		registros.push_back(record);
+		size_t c = cat.camion(rng);
+		out.texto(cat.camiones[c]);
+		out.caracter(',');
+		out.texto(cat.choferDe(c, rng));
+		// Kilometraje diario de 0 a 900 km, con dos decimales
+		escribirSerie(out, dias, [&rng]() -> uint64_t {
+			return rng.uniforme() < 0.15 ? 0 : static_cast<uint64_t>(rng.rango(2000, 90000));
+		});
+		++filas;
 	}
-	archivo.close();
-	return registros;
+	return out.cerrar();
 }
-void guardarTallerCSV_Sobrescribir(const vector<TallerRecord>& registros) {
-	ofstream archivo(NOMBRE_ARCHIVO_TALLER, ios::out);
-	if (archivo.is_open()) {
-		// Encabezados dinámicos para los costos
-		archivo << "Camion,Encargado,Taller";
-		if (!registros.empty()) {
-			for (size_t i = 0; i < registros[0].costos.size(); ++i) {
-				archivo << ",Costo_" << (i + 1);
-			}
+
+// Mismo formato que obtenerHoraActual(): "%Y-%m-%d %H:%M:%S"
+void escribirFechaHora(EscritorBufferado& out, int64_t segundosEpoch) {
+	int anio; unsigned mes, dia;
+	int64_t dias = segundosEpoch / 86400;
+	int64_t seg = segundosEpoch % 86400;
+	civilDesdeDias(dias, anio, mes, dia);
+	out.entero(anio, 4); out.caracter('-'); out.entero(mes, 2); out.caracter('-'); out.entero(dia, 2);
+	out.caracter(' ');
+	out.entero(seg / 3600, 2); out.caracter(':'); out.entero((seg / 60) % 60, 2); out.caracter(':'); out.entero(seg % 60, 2);
+}
+
+// Flujo intercalado de ENTRADA/SALIDA que respeta la pila del patio (LIFO, maximo MAX_CAMIONES)
+bool generarPilaSintetica(const OpcionesGenerador& op, const CatalogoSintetico& cat, const string& ruta, uint64_t& filas) {
+	EscritorBufferado out(ruta);
+	if (!out.abierto()) return false;
+	GeneradorAleatorio rng(op.semilla * 4 + 4);
+	out.texto("Fecha_Hora,Camion,Conductor,Movimiento");
+	out.finLinea();
+
+	vector<pair<size_t, const string*>> patio; // (camion, conductor) en orden de entrada
+	int64_t reloj = 1735689600; // 2025-01-01 00:00:00
+	while (!limiteAlcanzado(op, filas, out)) {
+		reloj += rng.rango(30, 1800);
+		bool entrada = patio.empty() || (patio.size() < static_cast<size_t>(MAX_CAMIONES) && rng.uniforme() < 0.5);
+		escribirFechaHora(out, reloj);
+		out.caracter(',');
+		if (entrada) {
+			size_t c = cat.camion(rng);
+			const string& conductor = cat.choferDe(c, rng);
+			patio.emplace_back(c, &conductor);
+			out.texto(cat.camiones[c]);
+			out.caracter(',');
+			out.texto(conductor);
+			out.texto(",ENTRADA");
 		}
 		else {
-			archivo << ",Costo_1"; // Poner al menos uno si está vacío
+			out.texto(cat.camiones[patio.back().first]);
+			out.caracter(',');
+			out.texto(*patio.back().second);
+			out.texto(",SALIDA");
+			patio.pop_back();
 		}
-		archivo << ",Total\n";
+		out.finLinea();
+		++filas;
+	}
+	return out.cerrar();
+}
 
-		archivo << fixed << setprecision(2);
-		for (const auto& record : registros) {
-			archivo << record.camion << "," << record.encargado << "," << record.taller;
-			for (double val : record.costos) archivo << "," << val;
-			archivo << "," << record.total << "\n";
-		}
-		archivo.close();
-		cout << "[CSV ACTUALIZADO] La tabla de registros ha sido sobrescrita en '" << NOMBRE_ARCHIVO_TALLER << "'.\n";
+// Registros de choferes (ids 1..N) en el formato de tamaño fijo del menu 2
+bool generarChoferesSinteticos(const OpcionesGenerador& op, const CatalogoSintetico& cat, const string& ruta, uint64_t& filas) {
+	filesystem::remove(ruta);
+	RegistroChoferes registro;
+	if (!registro.abrir(ruta)) return false;
+	GeneradorAleatorio rng(op.semilla * 4 + 5);
+	for (size_t i = 0; i < cat.choferes.size(); ++i) {
+		Chofer c{ cat.choferes[i], static_cast<int>(i + 1), static_cast<int>(rng.rango(21, 65)),
+			"55" + to_string(rng.rango(10000000, 99999999)), static_cast<int>(rng.rango(1000, 99999)) };
+		if (registro.guardar(c) == ResultadoRegistro::ErrorEscritura) return false;
 	}
-	else {
-		cout << "!!! ERROR: No se pudo abrir el archivo para sobrescribir los datos.\n";
+	filas = registro.tamano();
+	return true;
+}
+
+// Una unidad por camion del catalogo, con placas unicas y su chofer habitual asignado
+bool generarUnidadesSinteticas(const OpcionesGenerador& op, const CatalogoSintetico& cat, const string& ruta, uint64_t& filas) {
+	filesystem::remove(ruta);
+	RegistroUnidades registro;
+	if (!registro.abrir(ruta)) return false;
+	GeneradorAleatorio rng(op.semilla * 4 + 6);
+	const char* colores[] = { "Blanco", "Rojo", "Azul", "Gris", "Verde", "Negro" };
+	for (size_t i = 0; i < cat.camiones.size(); ++i) {
+		// Multiplicar por un primo que no divide a 9,000,000 da placas distintas para cada camion
+		int placas = static_cast<int>((uint64_t(i) * 2654435761ULL) % 9000000 + 1000000);
+		UnidadTransporte u{ 100 + static_cast<int>(i), placas, colores[rng.rango(0, 5)], static_cast<int>(rng.rango(2005, 2025)),
+			cat.choferes[cat.choferPrincipal[i]], static_cast<int>(rng.rango(0, 20)) };
+		if (registro.guardar(u) == ResultadoRegistro::ErrorEscritura) return false;
 	}
+	filas = registro.tamano();
+	return true;
 }
 
-void metodoSeleccion() {
-	string camion, encargado, taller;
-	cout << "\n======= METODO SELECCION: REGISTRO DE COSTOS DE TALLER (ORDENAMIENTO ASCENDENTE) =======\n";
-	cout << "Ingrese el numero de camion: ";
-	cin >> camion;
-	limpiarBuffer();
-	cout << "Ingrese el nombre del encargado: ";
-	getline(cin, encargado);
-	cout << "Ingrese el nombre del taller: ";
-	getline(cin, taller);
+void mostrarUsoGenerador() {
+	cout << "Uso: Proyecto7.0 --generar-datos [opciones]\n"
+		<< "  --dir <ruta>        Directorio de salida (por defecto: actual)\n"
+		<< "  --semilla <n>       Semilla del generador (misma semilla = mismos archivos)\n"
+		<< "  --filas <n>         Filas por tabla (por defecto: 1000000)\n"
+		<< "  --gb <n>            Tamaño total aproximado en GB (se reparte entre las 4 tablas)\n"
+		<< "  --camiones <n>      Numero de camiones distintos (por defecto: 2000)\n"
+		<< "  --choferes <n>      Numero de choferes distintos (por defecto: 3000)\n";
+}
 
-	int visitas;
-	visitas = pedirEntero("¿Cuantas veces fue al taller este mes?: ");
-	if (visitas <= 0) {
-		cout << "El numero de visitas debe ser un valor positivo.\n";
-		limpiarPantalla();
-		return;
+int ejecutarGeneradorDatos(int argc, char* argv[]) {
+	OpcionesGenerador op;
+	bool limitePorTamano = false;
+	for (int i = 2; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--dir" && tieneValor) op.directorio = argv[++i];
+		else if (arg == "--semilla" && tieneValor) op.semilla = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--filas" && tieneValor) op.filas = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--gb" && tieneValor) {
+			op.bytesPorTabla = static_cast<uint64_t>(atof(argv[++i]) * 1024.0 * 1024.0 * 1024.0 / 4.0);
+			limitePorTamano = true;
+		}
+		else if (arg == "--camiones" && tieneValor) op.numCamiones = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (arg == "--choferes" && tieneValor) op.numChoferes = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else { mostrarUsoGenerador(); return 1; }
 	}
+	if (limitePorTamano) op.filas = numeric_limits<uint64_t>::max();
 
-	vector<double> costos(visitas);
-	cout << "\nIngrese los costos por cada reparacion:\n";
-	for (size_t i = 0; i < costos.size(); i++) {
-		costos[i] = pedirDouble("Costo de la reparacion #" + to_string(i + 1) + ": ");
+	error_code ec;
+	filesystem::create_directories(op.directorio, ec);
+	if (ec) {
+		cout << "!!! ERROR: No se pudo crear el directorio '" << op.directorio << "': " << ec.message() << "\n";
+		return 1;
+	}
+	auto ruta = [&op](const string& nombre) { return (filesystem::path(op.directorio) / nombre).string(); };
+
+	CatalogoSintetico catalogo(op);
+	// 'generar' regresa false si el archivo no se pudo abrir o quedó incompleto
+	struct Trabajo { string archivo; bool (*generar)(const OpcionesGenerador&, const CatalogoSintetico&, const string&, uint64_t&); uint64_t filas; bool exito; };
+	vector<Trabajo> trabajos = {
+		{ NOMBRE_ARCHIVO_INGRESOS, generarIngresosSinteticos, 0, false },
+		{ NOMBRE_ARCHIVO_TALLER, generarTallerSintetico, 0, false },
+		{ NOMBRE_ARCHIVO_KM, generarKmSintetico, 0, false },
+		{ "registro_camiones_pila.csv", generarPilaSintetica, 0, false },
+		{ NOMBRE_ARCHIVO_CHOFERES, generarChoferesSinteticos, 0, false },
+		{ NOMBRE_ARCHIVO_UNIDADES, generarUnidadesSinteticas, 0, false },
+	};
+
+	cout << "Generando datos sinteticos en '" << op.directorio << "' (semilla " << op.semilla << ")...\n";
+	auto inicio = chrono::steady_clock::now();
+	// Cada tabla tiene su propio flujo aleatorio, asi que se generan en paralelo sin perder determinismo
+	vector<thread> hilos;
+	for (auto& t : trabajos) {
+		hilos.emplace_back([&t, &op, &catalogo, &ruta]() { t.exito = t.generar(op, catalogo, ruta(t.archivo), t.filas); });
 	}
+	for (auto& h : hilos) h.join();
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+	uint64_t bytesTotales = 0;
+	int codigo = 0;
+	for (const auto& t : trabajos) {
+		uint64_t bytes = tamanoArchivo(ruta(t.archivo));
+		bytesTotales += bytes;
+		cout << "  " << left << setw(28) << t.archivo << right << setw(12) << t.filas << " filas "
+			<< setw(10) << fixed << setprecision(1) << bytes / 1048576.0 << " MB\n";
+	}
+	for (const auto& t : trabajos) {
+		if (t.exito) continue;
+		cout << "!!! ERROR: No se pudo escribir '" << ruta(t.archivo) << "' completo (no se abrio o el disco rechazo la escritura).\n";
+		codigo = 1;
+	}
+	cout << "Total: " << fixed << setprecision(1) << bytesTotales / 1048576.0 << " MB en " << setprecision(2) << segundos
+		<< " s (" << setprecision(1) << (bytesTotales / 1048576.0) / max(segundos, 1e-9) << " MB/s)\n";
+	return codigo;
+}
 
-	seleccionAsc(costos);
-	double total = sumaValores(costos);
 
-	cout << "\n======= COSTOS ORDENADOS (MENOR A MAYOR) =======\n";
-	cout << fixed << setprecision(2);
-	cout << "Visita\tCosto\n";
-	for (size_t i = 0; i < costos.size(); i++) {
-		cout << (i + 1) << "\t" << costos[i] << "\n";
+// ======================= BENCHMARKS (LINEA DE COMANDOS) =======================
+// Modo de linea de comandos: Proyecto7.0 --benchmark <nombre> [opciones]
+// Cada benchmark valida su resultado contra una referencia exacta antes de reportar el rendimiento.
+
+// Compara la suma ingenua y la compensada de double contra la suma entera de centavos
+int benchmarkSuma(uint64_t n, uint64_t semilla) {
+	GeneradorAleatorio rng(semilla);
+	vector<Centavos> montos(n);
+	vector<double> montosDouble(n);
+	Centavos exacto = 0;
+	for (size_t i = 0; i < n; ++i) {
+		montos[i] = static_cast<Centavos>(rng.rango(1, 5000000)); // 0.01 .. 50,000.00
+		montosDouble[i] = montos[i] / 100.0;
+		exacto += montos[i];
 	}
-	cout << "---------------------------------\nTOTAL:\t" << total << "\n";
+	const int repeticiones = max<int>(1, static_cast<int>(200000000 / max<uint64_t>(n, 1)));
+
+	cout << "Suma de " << n << " montos (" << repeticiones << " repeticiones), total exacto: " << Monto{ exacto } << "\n";
+	bool correcto = true;
+	volatile Centavos cero = 0; // Escritura opaca por repetición: impide que el compilador reutilice la suma
+	// Ejecuta 'sumar' las veces indicadas y reporta su error en centavos y su velocidad
+	auto medir = [&](const char* nombre, auto sumar, bool debeSerExacta) {
+		Centavos resultado = 0;
+		auto inicio = chrono::steady_clock::now();
+		for (int r = 0; r < repeticiones; ++r) {
+			montos[r % n] += cero;
+			montosDouble[r % n] += cero;
+			resultado = sumar();
+		}
+		double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		int64_t errorCentavos = llabs(resultado - exacto);
+		if (debeSerExacta && errorCentavos != 0) correcto = false;
+		double mb = static_cast<double>(n) * sizeof(Centavos) * repeticiones / 1048576.0;
+		cout << "  " << left << setw(12) << nombre << right << setw(22) << Monto{ resultado }
+			<< "  error: " << setw(6) << errorCentavos << " centavos  "
+			<< setw(10) << fixed << setprecision(1) << mb / max(segundos, 1e-9) << " MB/s\n";
+	};
+	medir("ingenua", [&]() { double s = 0.0; for (double x : montosDouble) s += x; return llround(s * 100.0); }, false);
+	medir("compensada", [&]() { return llround(sumaValores(montosDouble) * 100.0); }, true);
+	medir("centavos", [&]() { return sumaMontos(montos); }, true);
+	if (!correcto) cout << "!!! ERROR: una suma compensada o de centavos no coincide con el total exacto.\n";
+	return correcto ? 0 : 1;
+}
 
-	guardarTallerCSV_Append(camion, encargado, taller, costos, total);
-	cout << "Registro guardado en '" << NOMBRE_ARCHIVO_TALLER << "'.\n";
+// Lote sintetico de 'n' boletos procesado contra un libro temporal; valida que los totales
+// por vendedor cuadren con lo cobrado y con lo escrito en el libro
+int benchmarkVentas(uint64_t n, uint64_t semilla) {
+	filesystem::path dir = filesystem::temp_directory_path() / ("bench_ventas_" + to_string(semilla));
+	filesystem::remove_all(dir);
+	filesystem::create_directories(dir);
+
+	MotorVentas motor;
+	motor.cargarReglas((dir / NOMBRE_ARCHIVO_DESCUENTOS).string());
+	motor.abrirLibro((dir / NOMBRE_ARCHIVO_VENTAS).string());
+	const auto& reglas = motor.reglasDescuento();
+
+	GeneradorAleatorio rng(semilla);
+	string lote = "Vendedor,Tipo,Subtotal\n";
+	lote.reserve(n * 32);
+	char buffer[24];
+	Centavos esperado = 0;
+	for (uint64_t i = 0; i < n; ++i) {
+		const ReglaDescuento& regla = reglas[rng.rango(0, reglas.size() - 1)];
+		Centavos subtotal = static_cast<Centavos>(rng.rango(5000, 150000)); // 50.00 .. 1500.00
+		esperado += subtotal - aplicarPorcentaje(subtotal, regla.centesimas);
+		lote += "Taquilla_";
+		lote.append(buffer, to_chars(buffer, buffer + sizeof(buffer), rng.rango(1, 50)).ptr);
+		lote += ',';
+		lote += regla.clave;
+		lote += ',';
+		lote.append(buffer, formatearCentavos(buffer, subtotal));
+		lote += '\n';
+	}
 
-	limpiarPantalla();
-	menuListaTallerCompleto("METODO SELECCION");
+	istringstream entrada(move(lote));
+	auto inicio = chrono::steady_clock::now();
+	ResultadoLoteVentas r = procesarLoteVentas(entrada, motor);
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	mostrarResultadoLote(r, segundos);
+
+	Centavos porVendedor = 0;
+	for (const auto& t : motor.totalesPorVendedor()) porVendedor += t.second.total;
+	// Se vuelve a abrir el libro: la pasada de recuperación debe llegar a los mismos totales
+	motor.abrirLibro((dir / NOMBRE_ARCHIVO_VENTAS).string());
+	Centavos releido = 0;
+	for (const auto& t : motor.totalesPorVendedor()) releido += t.second.total;
+
+	cout << "Esperado: $" << Monto{ esperado } << "  por vendedor: $" << Monto{ porVendedor }
+		<< "  releido del libro: $" << Monto{ releido } << "\n";
+	filesystem::remove_all(dir);
+	bool correcto = r.boletos == n && r.total == esperado && porVendedor == esperado && releido == esperado;
+	if (!correcto) cout << "!!! ERROR: los totales del motor de ventas no cuadran.\n";
+	return correcto ? 0 : 1;
 }
 
-// ---------- MÉTODO INSERCIÓN (Sin Menu de Listas aún) ----------
-// ---------- MÉTODO INSERCIÓN (Adaptado para List Menu) ----------
-void insercionAsc(vector<double>& km) {
-	for (size_t i = 1; i < km.size(); i++) {
-		double key = km[i];
-		int j = static_cast<int>(i) - 1;
-		while (j >= 0 && km[j] > key) {
-			km[j + 1] = km[j];
-			j--;
+// Escalamiento de las ventas concurrentes: 'n' boletos repartidos entre 1, 2, 4, ... terminales.
+// Cada corrida usa un libro temporal nuevo y valida folios y totales contra lo cobrado.
+int benchmarkTerminales(uint64_t n, uint64_t semilla, size_t maxHilos) {
+	filesystem::path dir = filesystem::temp_directory_path() / ("bench_terminales_" + to_string(semilla));
+	vector<string> vendedores;
+	for (int v = 1; v <= 50; ++v) vendedores.push_back("Taquilla_" + to_string(v));
+
+	cout << "Ventas concurrentes: " << n << " boletos por corrida\n";
+	cout << right << setw(10) << "TERMINALES" << setw(14) << "SEGUNDOS" << setw(16) << "BOLETOS/S" << setw(12) << "ESCALA" << "\n";
+	bool correcto = true;
+	double base = 0.0;
+	for (size_t hilos = 1; hilos <= maxHilos; hilos = (hilos * 2 <= maxHilos || hilos == maxHilos) ? hilos * 2 : maxHilos) {
+		filesystem::remove_all(dir);
+		filesystem::create_directories(dir);
+		MotorVentas motor;
+		motor.cargarReglas((dir / NOMBRE_ARCHIVO_DESCUENTOS).string());
+		motor.abrirLibro((dir / NOMBRE_ARCHIVO_VENTAS).string());
+		const auto& reglas = motor.reglasDescuento();
+
+		auto inicio = chrono::steady_clock::now();
+		SesionVentasConcurrente sesion(motor, hilos);
+		vector<thread> terminales;
+		for (size_t t = 0; t < hilos; ++t) {
+			terminales.emplace_back([&, t]() {
+				GeneradorAleatorio rng(semilla * 1000 + t);
+				TerminalVentas& terminal = sesion.terminal(t);
+				uint64_t propios = n / hilos + (t < n % hilos ? 1 : 0);
+				for (uint64_t i = 0; i < propios; ++i) {
+					const ReglaDescuento& regla = reglas[rng.rango(0, reglas.size() - 1)];
+					terminal.registrar(vendedores[rng.rango(0, vendedores.size() - 1)], regla.clave, regla.centesimas,
+						static_cast<Centavos>(rng.rango(5000, 150000)));
+				}
+			});
 		}
-		km[j + 1] = key;
+		for (auto& h : terminales) h.join();
+		sesion.detener();
+		double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+		Centavos cobrado = 0, enMotor = 0;
+		uint64_t boletos = 0;
+		for (size_t t = 0; t < hilos; ++t) cobrado += sesion.terminal(t).cobrado;
+		for (const auto& v : motor.totalesPorVendedor()) { enMotor += v.second.total; boletos += v.second.boletos; }
+		uint64_t folioSiguiente = motor.tomarFolio();
+		motor.abrirLibro((dir / NOMBRE_ARCHIVO_VENTAS).string()); // Relectura: mismos totales desde el disco
+		Centavos releido = 0;
+		for (const auto& v : motor.totalesPorVendedor()) releido += v.second.total;
+		if (boletos != n || folioSiguiente != n + 1 || enMotor != cobrado || releido != cobrado) {
+			cout << "!!! ERROR: con " << hilos << " terminales los folios o totales no cuadran.\n";
+			correcto = false;
+		}
+
+		double porSegundo = n / max(segundos, 1e-9);
+		if (hilos == 1) base = porSegundo;
+		FormatoFlujo formato(cout);
+		cout << setw(10) << hilos << setw(14) << fixed << setprecision(3) << segundos << setw(16) << setprecision(0) << porSegundo
+			<< setw(11) << setprecision(2) << porSegundo / max(base, 1e-9) << "x\n";
+		if (hilos == maxHilos) break;
+	}
+	filesystem::remove_all(dir);
+	return correcto ? 0 : 1;
+}
+
+// Acumulados de nómina: secuencial contra paralelo, con muchos empleados de 1 a 10 años
+// y con un solo empleado que tiene todos los meses (un solo segmento que cruza todos los bloques)
+int benchmarkNomina(uint64_t n, uint64_t semilla, size_t hilos) {
+	GeneradorAleatorio rng(semilla);
+	bool correcto = true;
+	for (int caso = 0; caso < 2; ++caso) {
+		NominaEmpleados nomina;
+		nomina.sueldos.reserve(n);
+		while (nomina.sueldos.size() < n) {
+			size_t meses = caso == 0 ? min<uint64_t>(rng.rango(12, 120), n - nomina.sueldos.size()) : n;
+			for (size_t m = 0; m < meses; ++m) nomina.sueldos.push_back(static_cast<Centavos>(rng.rango(800000, 6000000)));
+			nomina.agregar("Empleado_" + to_string(nomina.numEmpleados() + 1));
+		}
+
+		auto inicio = chrono::steady_clock::now();
+		vector<Centavos> secuencial = acumularNomina(nomina);
+		double segSecuencial = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		inicio = chrono::steady_clock::now();
+		vector<Centavos> paralelo = acumularNominaParalelo(nomina, hilos);
+		double segParalelo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+		bool iguales = secuencial == paralelo;
+		correcto = correcto && iguales;
+		double mb = n * sizeof(Centavos) / 1048576.0;
+		cout << (caso == 0 ? "Plantilla: " : "Un empleado: ") << nomina.numEmpleados() << " empleados, " << n << " meses-sueldo\n"
+			<< "  secuencial " << fixed << setprecision(1) << setw(10) << mb / max(segSecuencial, 1e-9) << " MB/s\n"
+			<< "  paralelo   " << setw(10) << mb / max(segParalelo, 1e-9) << " MB/s (" << hilos << " hilos)  "
+			<< (iguales ? "resultados identicos" : "!!! ERROR: los acumulados no coinciden") << "\n";
 	}
+	return correcto ? 0 : 1;
 }
 
-void guardarKmCSV_Append(string camion, string chofer, const vector<double>& km, double total) {
-	const string nombreArchivo = NOMBRE_ARCHIVO_KM;
-	bool archivoVacio = false;
-	ifstream verificar(nombreArchivo);
-	if (verificar.is_open()) {
-		verificar.seekg(0, ios::end);
-		if (verificar.tellg() == 0) archivoVacio = true;
-		verificar.close();
+// Sobrescribe la misma tabla 'n' veces seguidas (como varias ediciones en el menu): cuánto
+// espera el menu por guardado escribiendo directo y con el escritor asíncrono
+int benchmarkGuardado(uint64_t n, uint64_t semilla) {
+	n = min<uint64_t>(n, 200);
+	filesystem::path dir = filesystem::temp_directory_path() / ("bench_guardado_" + to_string(semilla));
+	filesystem::remove_all(dir);
+	filesystem::create_directories(dir);
+	const string ruta = (dir / NOMBRE_ARCHIVO_INGRESOS).string();
+
+	GeneradorAleatorio rng(semilla);
+	ostringstream tabla;
+	tabla << fixed << setprecision(2);
+	escribirEncabezadoCSV<IngresoRecord>(tabla, 7);
+	IngresoRecord r{ "", "Chofer de prueba", vector<Centavos>(7), 0, "" };
+	for (int i = 0; i < 20000; ++i) {
+		r.camion = to_string(rng.rango(100, 999));
+		for (auto& v : r.ingresos) v = static_cast<Centavos>(rng.rango(0, 2000000));
+		r.total = sumaSerie(r.ingresos);
+		escribirRegistroCSV(tabla, r);
 	}
-	else {
-		archivoVacio = true;
+	const string contenido = tabla.str();
+
+	auto inicio = chrono::steady_clock::now();
+	for (uint64_t i = 0; i < n; ++i) {
+		ofstream archivo(ruta, ios::out);
+		archivo << contenido;
 	}
+	double directo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+	const uint64_t escriturasAntes = escritorArchivos.escriturasRealizadas();
+	inicio = chrono::steady_clock::now();
+	for (uint64_t i = 0; i < n; ++i) escritorArchivos.reemplazar(ruta, string(contenido));
+	double espera = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	bool sincronizado = escritorArchivos.sincronizar();
+	double total = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	uint64_t escrituras = escritorArchivos.escriturasRealizadas() - escriturasAntes;
+
+	bool correcto = sincronizado && tamanoArchivo(ruta) == contenido.size();
+	cout << "\n======= BENCHMARK: GUARDADOS SEGUIDOS =======\n"
+		<< n << " guardados de " << fixed << setprecision(1) << contenido.size() / 1048576.0 << " MB\n" << setprecision(3)
+		<< "Directo:    " << directo * 1e3 / n << " ms por guardado (" << directo << " s)\n"
+		<< "Asincrono:  " << espera * 1e3 / n << " ms por guardado en el menu; " << total << " s hasta la barrera (fsync incluido)\n"
+		<< "Escrituras: " << escrituras << " de " << n << " guardados (el resto se junto con el siguiente)\n"
+		<< "Archivo final " << (correcto ? "correcto" : "INCORRECTO") << "\n";
+	filesystem::remove_all(dir);
+	return correcto ? 0 : 2;
+}
 
-	ofstream archivo(nombreArchivo, ios::app);
-	if (archivo.is_open()) {
-		if (archivoVacio) {
-			archivo << "Camion,Chofer";
-			for (size_t i = 1; i <= km.size(); ++i) archivo << ",Km_Dia_" << i;
-			archivo << ",Total\n";
+// Un escritor publica 'n' versiones mientras 'hilos' lectores recorren instantáneas completas.
+// Toda versión debe sumar lo mismo: el escritor mueve montos entre dos registros, o agrega un
+// registro en cero y en la siguiente edición lo quita.
+int benchmarkInstantaneas(uint64_t n, uint64_t semilla, size_t hilos) {
+	n = min<uint64_t>(n, 20000);
+	const size_t FILAS = 100000;
+	TablaVersionada<IngresoRecord> tabla;
+	GeneradorAleatorio rng(semilla);
+	Centavos esperado = 0;
+	{
+		vector<IngresoRecord> registros(FILAS);
+		for (auto& r : registros) {
+			r.camion = to_string(rng.rango(100, 999));
+			r.total = static_cast<Centavos>(rng.rango(0, 10000000));
+			esperado += r.total;
 		}
-		archivo << fixed << setprecision(2);
-		archivo << camion << "," << chofer;
-		for (double val : km) archivo << "," << val;
-		archivo << "," << total << "\n";
-		archivo.close();
+		tabla.reemplazarTodo(move(registros));
 	}
-	else {
-		cout << "No se pudo abrir el archivo para guardar los datos.\n";
+
+	struct alignas(64) ResultadoLector {
+		uint64_t lecturas = 0, filas = 0, inconsistentes = 0;
+	};
+	vector<ResultadoLector> resultados(hilos);
+	atomic<bool> terminado{ false };
+	vector<thread> lectores;
+	for (size_t h = 0; h < hilos; ++h) {
+		lectores.emplace_back([&, h]() {
+			ResultadoLector& res = resultados[h];
+			while (!terminado.load(memory_order_relaxed)) {
+				auto version = tabla.leer();
+				Centavos suma = 0;
+				size_t filas = 0;
+				version->recorrer([&](const IngresoRecord& r) { suma += r.total; ++filas; });
+				if (suma != esperado || filas != version->filas) ++res.inconsistentes;
+				++res.lecturas;
+				res.filas += filas;
+			}
+		});
 	}
-}
+
+	auto inicio = chrono::steady_clock::now();
+	auto nada = [](const TablaVersionada<IngresoRecord>::Version&) { return true; };
+	for (uint64_t i = 0; i < n; ++i) {
+		tabla.modificar([&](TablaVersionada<IngresoRecord>::Editor& editor) {
+			if (i % 16 == 14) { editor.agregar(IngresoRecord{ "TEMPORAL", "", {}, 0, "" }); return true; }
+			if (i % 16 == 15) return editor.eliminarSi([](const IngresoRecord& r) { return r.camion == "TEMPORAL"; }) > 0;
+			size_t sa = rng.rango(0, editor.numSegmentos() - 1), sb = rng.rango(0, editor.numSegmentos() - 1);
+			IngresoRecord& a = editor.editar(sa, rng.rango(0, editor.filasSegmento(sa) - 1));
+			IngresoRecord& b = editor.editar(sb, rng.rango(0, editor.filasSegmento(sb) - 1));
+			Centavos monto = static_cast<Centavos>(rng.rango(1, 100000));
+			a.total -= monto;
+			b.total += monto;
+			return true;
+		}, nada);
+	}
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	terminado = true;
+	for (auto& l : lectores) l.join();
+
+	uint64_t lecturas = 0, filas = 0, inconsistentes = 0;
+	for (const auto& r : resultados) { lecturas += r.lecturas; filas += r.filas; inconsistentes += r.inconsistentes; }
+	auto final = tabla.leer();
+	Centavos sumaFinal = 0;
+	final->recorrer([&sumaFinal](const IngresoRecord& r) { sumaFinal += r.total; });
+	bool correcto = inconsistentes == 0 && sumaFinal == esperado && final->filas == FILAS;
+
+	FormatoFlujo formato(cout);
+	cout << "\n======= BENCHMARK: INSTANTANEAS (MVCC) =======\n"
+		<< FILAS << " registros en segmentos de " << FILAS_POR_SEGMENTO << "; " << hilos << " lectores y 1 escritor\n"
+		<< "Escritor:  " << n << " versiones en " << fixed << setprecision(3) << segundos << " s ("
+		<< setprecision(0) << n / max(segundos, 1e-9) << " versiones/s)\n"
+		<< "Lectores:  " << lecturas << " recorridos completos (" << setprecision(1) << lecturas / max(segundos, 1e-9)
+		<< " por s, " << filas / max(segundos, 1e-9) / 1e6 << " M filas/s)\n"
+		<< "Versiones liberadas: " << tabla.versionesLiberadas() << ", aun retenidas: " << tabla.pendientesDeLiberar() << "\n"
+		<< "Inconsistencias: " << inconsistentes << (correcto ? " (correcto)" : " (INCORRECTO)") << "\n";
+	return correcto ? 0 : 2;
 }
 
-void metodoInsercion() {
-	string camion, chofer;
-	cout << "\n======= METODO INSERCION: REGISTRO DE KILOMETRAJE (ORDENAMIENTO ASCENDENTE) =======\n";
-	cout << "Ingrese el numero de camion: ";
-	cin >> camion;
-	limpiarBuffer();
-	cout << "Ingrese el nombre del chofer: ";
-	getline(cin, chofer);
+// Series de km de 17 días en tres formas (diarias al azar, ordenadas con insercionAsc y lecturas
+// de odómetro): tamaño por columna contra serie por fila, ida y vuelta exacta, y suma de km
+// desde el texto contra desde los enteros de la serie
+int benchmarkSeries(uint64_t n, uint64_t semilla) {
+	n = min<uint64_t>(n, 4 * FILAS_POR_BLOQUE);
+	const size_t DIAS = 17;
+	GeneradorAleatorio rng(semilla);
+	bool correcto = true;
+	cout << "\n======= BENCHMARK: SERIES DE KILOMETRAJE =======\n" << n << " registros de " << DIAS << " dias\n"
+		<< left << setw(12) << "FORMA" << right << setw(14) << "POR COLUMNA" << setw(14) << "POR FILA" << setw(18) << "SUMA DESDE TEXTO"
+		<< setw(20) << "SUMA DESDE SERIE" << "\n";
+	for (const char* forma : { "diaria", "ascendente", "odometro" }) {
+		const string nombre = forma;
+		FilasBloque filas;
+		vector<string> texto(DIAS + 3);
+		vector<string_view> campos(DIAS + 3);
+		vector<double> km(DIAS);
+		char buffer[24];
+		Centavos esperado = 0;
+		for (uint64_t i = 0; i < n; ++i) {
+			int64_t lectura = static_cast<int64_t>(rng.rango(0, 50000000));
+			for (auto& v : km) {
+				if (nombre == "odometro") { lectura += static_cast<int64_t>(rng.rango(20000, 40000)); v = lectura / 100.0; }
+				else v = static_cast<double>(rng.rango(0, 90000)) / 100.0;
+			}
+			if (nombre == "ascendente") insercionAsc(km);
+			texto[0] = to_string(rng.rango(100, 999));
+			texto[1] = "Chofer de prueba";
+			Centavos total = 0;
+			for (size_t d = 0; d < DIAS; ++d) {
+				Centavos c = llround(km[d] * 100.0);
+				total += c;
+				texto[2 + d].assign(buffer, formatearCentavos(buffer, c));
+			}
+			texto[DIAS + 2].assign(buffer, formatearCentavos(buffer, total));
+			esperado += total;
+			for (size_t k = 0; k < campos.size(); ++k) campos[k] = texto[k];
+			filas.agregar(campos.data(), campos.size());
+		}
 
-	int dias;
-	dias = pedirEntero("¿Cuantos dias desea registrar kilometraje?: ");
-	if (dias <= 0) {
-		cout << "El numero de dias debe ser un valor positivo.\n";
-		limpiarPantalla();
-		return;
+		size_t bytesColumna = 0;
+		vector<string> bloques;
+		for (size_t desde = 0; desde < filas.filas(); desde += FILAS_POR_BLOQUE) {
+			size_t hasta = min(filas.filas(), desde + FILAS_POR_BLOQUE);
+			bytesColumna += codificarBloque(filas, {}, desde, hasta, false).size();
+			bloques.push_back(codificarBloque(filas, {}, desde, hasta));
+		}
+		size_t bytesFila = 0;
+		for (const auto& b : bloques) bytesFila += b.size();
+
+		// Ida y vuelta: cada campo idéntico al original
+		BloqueDecodificado d;
+		size_t fila = 0;
+		for (const auto& b : bloques) {
+			correcto = decodificarBloque(b, d) && correcto;
+			for (size_t f = 0; f < d.filas() && correcto; ++f, ++fila) {
+				for (size_t k = 0; k < filas.numCampos(fila); ++k) correcto = correcto && d.campos[d.inicioFila[f] + k] == filas.campo(fila, k);
+			}
+		}
+
+		auto inicio = chrono::steady_clock::now();
+		Centavos desdeTexto = 0;
+		for (const auto& b : bloques) {
+			decodificarBloque(b, d);
+			for (size_t f = 0; f < d.filas(); ++f) {
+				for (uint32_t c = d.inicioFila[f] + 2; c + 1 < d.inicioFila[f + 1]; ++c) {
+					Centavos v = 0;
+					convertirCentavos(d.campos[c], v);
+					desdeTexto += v;
+				}
+			}
+		}
+		double segTexto = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		inicio = chrono::steady_clock::now();
+		Centavos desdeSerie = 0;
+		for (const auto& b : bloques) {
+			decodificarBloque(b, d, false);
+			desdeSerie += sumaCentavos(d.serie.data(), d.serie.size());
+		}
+		double segSerie = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		correcto = correcto && desdeTexto == esperado && desdeSerie == esperado;
+
+		cout << left << setw(12) << nombre << right << fixed << setprecision(2) << setw(11) << bytesColumna / 1048576.0 << " MB"
+			<< setw(11) << bytesFila / 1048576.0 << " MB" << setprecision(1) << setw(15) << segTexto * 1e3 << " ms"
+			<< setw(17) << segSerie * 1e3 << " ms" << "\n";
 	}
+	cout << "Ida y vuelta y sumas: " << (correcto ? "correctas" : "INCORRECTAS") << "\n";
+	return correcto ? 0 : 2;
+}
 
-	vector<double> km(dias);
-	for (size_t i = 0; i < km.size(); i++) {
-		km[i] = pedirDouble("Kilometraje del dia #" + to_string(i + 1) + ": ");
+// Órdenes mantenidos de la lista: 'n' registros de km y rondas de altas pocas a la vez, pidiendo
+// después un orden al azar. Cada resultado se compara con el ordenamiento completo desde cero.
+int benchmarkOrdenes(uint64_t n, uint64_t semilla) {
+	n = min<uint64_t>(n, 200000);
+	const size_t RONDAS = 60, ALTAS_POR_RONDA = 25;
+	GeneradorAleatorio rng(semilla);
+	auto nuevo = [&rng]() {
+		KilometrajeRecord r{ "C-" + to_string(rng.rango(100, 999)), "Chofer " + to_string(rng.rango(1, 400)), {}, 0.0 };
+		r.total = static_cast<double>(rng.rango(0, 2000000)) / 100.0;
+		return r;
+	};
+	vector<KilometrajeRecord> registros;
+	registros.reserve(n + RONDAS * ALTAS_POR_RONDA);
+	for (uint64_t i = 0; i < n; ++i) registros.push_back(nuevo());
+
+	OrdenesTabla<KilometrajeRecord> ordenes;
+	for (size_t c = 0; c < CAMPOS_ORDEN_LISTA; ++c) ordenes.orden(registros, c);
+
+	double segMantenido = 0, segCompleto = 0;
+	size_t mezcladas = 0;
+	bool correcto = true;
+	vector<uint32_t> desdeCero;
+	for (size_t ronda = 0; ronda < RONDAS; ++ronda) {
+		for (size_t a = 0; a < ALTAS_POR_RONDA; ++a) {
+			registros.push_back(nuevo());
+			ordenes.guardada(&registros.back());
+		}
+		size_t campo = rng.rango(0, CAMPOS_ORDEN_LISTA - 1);
+		auto inicio = chrono::steady_clock::now();
+		const vector<uint32_t>& mantenido = ordenes.orden(registros, campo);
+		segMantenido += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		mezcladas += ordenes.ultimasMezcladas;
+
+		// Referencia: una tabla nueva ordena todo desde cero
+		OrdenesTabla<KilometrajeRecord> referencia;
+		inicio = chrono::steady_clock::now();
+		desdeCero = referencia.orden(registros, campo);
+		segCompleto += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		correcto = correcto && !ordenes.ultimoCompleto && mantenido == desdeCero;
 	}
 
-	insercionAsc(km);
-	double total = sumaValores(km);
+	cout << "\n======= BENCHMARK: ORDENES MANTENIDOS DE LA LISTA =======\n"
+		<< n << " registros; " << RONDAS << " rondas de " << ALTAS_POR_RONDA << " altas y un orden al azar\n"
+		<< "Mantenido (mezcla de altas): " << fixed << setprecision(3) << segMantenido * 1e3 / RONDAS << " ms por consulta ("
+		<< mezcladas << " altas mezcladas en total)\n"
+		<< "Ordenamiento completo:       " << segCompleto * 1e3 / RONDAS << " ms por consulta\n"
+		<< "Ordenes " << (correcto ? "identicos" : "DISTINTOS") << "\n";
+	return correcto ? 0 : 2;
+}
 
-	cout << "\n======= KILOMETRAJE ORDENADO (MENOR A MAYOR) =======\n";
-	cout << fixed << setprecision(2);
-	cout << "Dia\tKm\n";
-	for (size_t i = 0; i < km.size(); i++) cout << (i + 1) << "\t" << km[i] << "\n";
-	cout << "---------------------------------\nTOTAL:\t" << total << "\n";
+// Casos del lector de CSV y de recorrerCSV: cada fila del archivo de prueba dice si se acepta
+// (y con qué valores), se rechaza (en qué línea) o se ignora. 'n' filas normales al final miden
+// la velocidad de lectura.
+int benchmarkCSV(uint64_t n) {
+	n = min<uint64_t>(n, 2000000);
+	enum class Esperado { Acepta, Rechaza, Ignora };
+	struct Caso {
+		string texto;             // Con su fin de línea
+		Esperado esperado;
+		string camion, chofer;
+		Centavos total;
+	};
+	const vector<Caso> casos = {
+		{ "101,Ana,2025-W01,1,2,3,4,5,6,7,28\n", Esperado::Acepta, "101", "Ana", 2800 },
+		{ "102,Beto,2025-W01,1,1,1,1,1,1,1,7\r\n", Esperado::Acepta, "102", "Beto", 700 },
+		{ "103,Caro,2025-W01,1,1,1,1,1,1,1,7,\n", Esperado::Acepta, "103", "Caro", 700 },                 // Coma final
+		{ "104,\"Perez, Juan\",2025-W01,1,1,1,1,1,1,1,7\n", Esperado::Acepta, "104", "Perez, Juan", 700 },
+		{ "105,\"Dice \"\"hola\"\"\nen dos lineas\",2025-W01,1,1,1,1,1,1,1,7\r\n", Esperado::Acepta, "105", "Dice \"hola\"\nen dos lineas", 700 },
+		{ "\n", Esperado::Ignora, "", "", 0 },
+		{ "\r\n", Esperado::Ignora, "", "", 0 },
+		{ "106,Dani,2025-W01,1,1,1,1,1,1,7\n", Esperado::Rechaza, "", "", 0 },                          // Falta un día
+		{ "107,Eva,2025-W01,1,1,1,1,1,1,1\n", Esperado::Rechaza, "", "", 0 },                            // Sin Total (el encabezado lo trae)
+		{ "108,Fer,2025-W01,1,x,1,1,1,1,1,7\n", Esperado::Rechaza, "", "", 0 },
+		{ "109,\"Gil,2025-W01,1,1,1,1,1,1,1,7\n", Esperado::Rechaza, "", "", 0 },                        // Comilla sin cerrar
+		{ "110,Hugo,2025-W01,1,1,1,1,1,1,1,7\r\n", Esperado::Acepta, "110", "Hugo", 700 },
+		{ "111,Ines\n", Esperado::Rechaza, "", "", 0 },
+		{ "112," + string(MAX_BYTES_REGISTRO_CSV + 10, 'a') + "\n", Esperado::Rechaza, "", "", 0 },      // Demasiado larga
+		{ "113,Juan,2025-W01,1,1,1,1,1,1,1,7,8\n", Esperado::Rechaza, "", "", 0 },                      // Un valor de más
+		{ "114,Lalo,2025-W01,1,1,1,1,1,1,12abc,7\n", Esperado::Rechaza, "", "", 0 },                    // Basura tras el número
+		{ "115,Memo,2025-W01,1e5,1,1,1,1,1,1,7\n", Esperado::Rechaza, "", "", 0 },                      // Exponente en un monto
+		{ "116,Nora,2025-W01, 1 ,1,1,1,1,1,1, 7 \n", Esperado::Acepta, "116", "Nora", 700 },           // Espacios a los lados
+		{ "117,Kari,2025-W01,1,1,1,1,1,1,1,7", Esperado::Acepta, "117", "Kari", 700 },                 // Sin salto final
+	};
+
+	filesystem::path dir = filesystem::temp_directory_path() / "bench_csv";
+	filesystem::remove_all(dir);
+	filesystem::create_directories(dir);
+	const string ruta = (dir / NOMBRE_ARCHIVO_INGRESOS).string();
+	vector<uint64_t> lineasRechazo;
+	{
+		ofstream archivo(ruta, ios::out | ios::binary);
+		archivo << "Camion,Chofer,Semana,Dia_1,Dia_2,Dia_3,Dia_4,Dia_5,Dia_6,Dia_7,Total\n";
+		uint64_t linea = 2;
+		for (const Caso& c : casos) {
+			if (c.esperado == Esperado::Rechaza) lineasRechazo.push_back(linea);
+			archivo << c.texto;
+			linea += static_cast<uint64_t>(count(c.texto.begin(), c.texto.end(), '\n'));
+		}
+	}
 
-	guardarKmCSV_Append(camion, chofer, km, total);
-	cout << "Registro guardado en '" << NOMBRE_ARCHIVO_KM << "'.\n";
+	vector<IngresoRecord> aceptados;
+	vector<FilaRechazada> rechazos;
+	recorrerCSV<IngresoRecord>(ruta, [&aceptados](IngresoRecord& r, size_t) { aceptados.push_back(move(r)); }, &rechazos);
+	bool correcto = true;
+	size_t k = 0;
+	for (const Caso& c : casos) {
+		if (c.esperado != Esperado::Acepta) continue;
+		const IngresoRecord* r = k < aceptados.size() ? &aceptados[k] : nullptr;
+		++k;
+		if (!r || r->camion != c.camion || r->chofer != c.chofer || r->total != c.total || r->ingresos.size() != 7) {
+			cout << "!!! ERROR: la fila del camion " << c.camion << " no se leyo como se esperaba.\n";
+			correcto = false;
+		}
+	}
+	if (aceptados.size() != k) {
+		cout << "!!! ERROR: se aceptaron " << aceptados.size() << " filas; se esperaban " << k << ".\n";
+		correcto = false;
+	}
+	vector<uint64_t> lineasLeidas;
+	for (const auto& r : rechazos) lineasLeidas.push_back(r.linea);
+	if (lineasLeidas != lineasRechazo) {
+		cout << "!!! ERROR: filas rechazadas en las lineas";
+		for (uint64_t l : lineasLeidas) cout << " " << l;
+		cout << "; se esperaban";
+		for (uint64_t l : lineasRechazo) cout << " " << l;
+		cout << ".\n";
+		correcto = false;
+	}
 
-	limpiarPantalla();
-	menuListaKilometrajeCompleto("METODO INSERCION");
+	// Campos sueltos: montos (centavos) y km (double) se aceptan solo si todo el campo es un número finito
+	struct CasoNumero { const char* texto; bool valido; double valor; };
+	const CasoNumero numeros[] = {
+		{ "12.5", true, 12.5 }, { " 12.5 ", true, 12.5 }, { "+3", true, 3.0 }, { "12.", true, 12.0 }, { "-0.75", true, -0.75 },
+		{ "12abc", false, 0 }, { "1 2", false, 0 }, { ".", false, 0 }, { "", false, 0 }, { "nan", false, 0 }, { "inf", false, 0 },
+	};
+	size_t numerosFallidos = 0;
+	for (const CasoNumero& c : numeros) {
+		Centavos centavos = 0;
+		double km = 0.0;
+		bool okCentavos = convertirCentavos(c.texto, centavos) == c.valido && (!c.valido || centavos == llround(c.valor * 100));
+		bool okKm = convertirDouble(c.texto, km) == c.valido && (!c.valido || km == c.valor);
+		if (okCentavos && okKm) continue;
+		cout << "!!! ERROR: el campo '" << c.texto << "' se " << (c.valido ? "rechazo o se leyo mal" : "acepto") << ".\n";
+		++numerosFallidos;
+	}
+	// Solo difieren en exponentes y valores no finitos: 1e5 son km válidos pero no un monto
+	Centavos centavos = 0;
+	double km = 0.0;
+	for (const char* texto : { "1e5", "-inf", "NaN", "1e999" }) {
+		bool esperadoKm = string_view(texto) == "1e5";
+		if (!convertirCentavos(texto, centavos) && convertirDouble(texto, km) == esperadoKm) continue;
+		cout << "!!! ERROR: el campo '" << texto << "' no se trato como se esperaba.\n";
+		++numerosFallidos;
+	}
+	correcto = correcto && numerosFallidos == 0;
+
+	cout << "\n======= BENCHMARK: LECTOR CSV =======\n"
+		<< casos.size() << " casos (comillas, CRLF, comas finales, filas cortas y largas, basura tras el numero): " << aceptados.size() << " aceptadas, "
+		<< rechazos.size() << " rechazadas -> " << (correcto ? "correcto" : "INCORRECTO") << "\n"
+		<< size(numeros) + 4 << " campos numericos sueltos (basura, exponentes, nan, inf): " << numerosFallidos << " fallidos\n";
+
+	// Velocidad: 'n' filas normales
+	{
+		ofstream archivo(ruta, ios::out | ios::binary);
+		archivo << "Camion,Chofer,Semana,Dia_1,Dia_2,Dia_3,Dia_4,Dia_5,Dia_6,Dia_7,Total\n";
+		for (uint64_t i = 0; i < n; ++i) archivo << (100 + i % 900) << ",Chofer de prueba,2025-W01,1000.50,2,3,4,5,6,7,1027.50\n";
+	}
+	auto inicio = chrono::steady_clock::now();
+	Centavos suma = 0;
+	uint64_t filas = recorrerCSV<IngresoRecord>(ruta, [&suma](IngresoRecord& r, size_t) { suma += r.total; });
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	bool velocidadCorrecta = filas == n && suma == static_cast<Centavos>(n) * 102750;
+	cout << filas << " filas en " << fixed << setprecision(3) << segundos << " s (" << setprecision(1)
+		<< tamanoArchivo(ruta) / 1048576.0 / max(segundos, 1e-9) << " MB/s)" << (velocidadCorrecta ? "" : " INCORRECTO") << "\n";
+	filesystem::remove_all(dir);
+	return correcto && velocidadCorrecta ? 0 : 2;
 }
 
+// Reporte cruzado por hash (agregarTabla + combinarReporteCruzado) contra un join de ciclos
+// anidados sobre los mismos registros generados: por cada clave se recorren las tres tablas
+// completas. Algunos choferes tienen 0 km y algunos camiones solo aparecen en el taller.
+int benchmarkCruce(uint64_t n, uint64_t semilla) {
+	n = min<uint64_t>(n, 20000);
+	const int CAMIONES = 150, CHOFERES = 40;
+	filesystem::path dir = filesystem::temp_directory_path() / ("bench_cruce_" + to_string(semilla));
+	filesystem::remove_all(dir);
+	filesystem::create_directories(dir);
+	const string rutaIngresos = (dir / NOMBRE_ARCHIVO_INGRESOS).string();
+	const string rutaTaller = (dir / NOMBRE_ARCHIVO_TALLER).string();
+	const string rutaKm = (dir / NOMBRE_ARCHIVO_KM).string();
+
+	GeneradorAleatorio rng(semilla);
+	auto camion = [&rng]() { return to_string(100 + rng.rango(0, CAMIONES - 1)); };
+	auto chofer = [&rng]() { return "Chofer " + to_string(rng.rango(1, CHOFERES)); };
+	vector<IngresoRecord> ingresos;
+	vector<TallerRecord> taller;
+	vector<KilometrajeRecord> km;
+	for (uint64_t i = 0; i < n; ++i) {
+		IngresoRecord r{ camion(), chofer(), vector<Centavos>(7), 0, "" };
+		for (auto& v : r.ingresos) v = static_cast<Centavos>(rng.rango(0, 2000000));
+		r.total = sumaSerie(r.ingresos);
+		ingresos.push_back(move(r));
+
+		KilometrajeRecord k{ camion(), chofer(), vector<double>(7, 0.0), 0.0 };
+		int64_t centesimas = 0;
+		if (rng.rango(0, 4) != 0) {      // Una de cada cinco semanas sin km
+			for (auto& v : k.km) { int64_t c = rng.rango(0, 60000); v = c / 100.0; centesimas += c; }
+		}
+		k.total = centesimas / 100.0;
+		km.push_back(move(k));
+	}
+	for (uint64_t i = 0; i < n / 4 + 1; ++i) {
+		// Los camiones 900..909 solo pasan por el taller (van a la fila "(sin chofer)")
+		TallerRecord r{ rng.rango(0, 19) == 0 ? to_string(900 + rng.rango(0, 9)) : camion(), "Encargado", "Taller", {}, 0 };
+		r.costos.resize(static_cast<size_t>(rng.rango(1, 4)));
+		for (auto& v : r.costos) v = static_cast<Centavos>(rng.rango(1, 900000));
+		r.total = sumaSerie(r.costos);
+		taller.push_back(move(r));
+	}
+	auto escribir = [](const string& ruta, const auto& registros, size_t columnas) {
+		using T = typename decay_t<decltype(registros)>::value_type;
+		ofstream archivo(ruta, ios::out | ios::binary);
+		archivo << fixed << setprecision(2);
+		escribirEncabezadoCSV<T>(archivo, columnas);
+		for (const auto& r : registros) escribirRegistroCSV(archivo, r);
+	};
+	escribir(rutaIngresos, ingresos, 7);
+	escribir(rutaTaller, taller, 4);
+	escribir(rutaKm, km, 7);
+
+	bool correcto = true;
+	double segHash = 0, segAnidado = 0;
+	size_t filasReporte = 0;
+	for (bool porChofer : { false, true }) {
+		auto inicio = chrono::steady_clock::now();
+		vector<FilaReporte> hash = combinarReporteCruzado(agregarTabla<IngresoRecord>(porChofer, rutaIngresos),
+			agregarTabla<TallerRecord>(false, rutaTaller), agregarTabla<KilometrajeRecord>(porChofer, rutaKm), porChofer);
+		segHash += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+		filasReporte += hash.size();
+
+		// Referencia: claves distintas y, por cada una, una vuelta completa a cada tabla
+		inicio = chrono::steady_clock::now();
+		vector<pair<string, string>> claves;
+		auto agregarClave = [&](const string& c, const string& ch) {
+			pair<string, string> clave(c, porChofer ? ch : "");
+			if (find(claves.begin(), claves.end(), clave) == claves.end()) claves.push_back(move(clave));
+		};
+		for (const auto& r : ingresos) agregarClave(r.camion, r.chofer);
+		for (const auto& r : km) agregarClave(r.camion, r.chofer);
+		vector<FilaReporte> anidado;
+		for (const auto& clave : claves) {
+			FilaReporte f;
+			f.camion = clave.first;
+			f.chofer = clave.second;
+			for (const auto& r : ingresos) {
+				if (r.camion == f.camion && (!porChofer || r.chofer == f.chofer)) { f.ingresos += r.total; ++f.registrosIngreso; }
+			}
+			for (const auto& r : km) {
+				if (r.camion == f.camion && (!porChofer || r.chofer == f.chofer)) { f.km += r.total; ++f.registrosKm; }
+			}
+			anidado.push_back(move(f));
+		}
+		vector<string> camionesTaller;
+		for (const auto& r : taller) {
+			if (find(camionesTaller.begin(), camionesTaller.end(), r.camion) == camionesTaller.end()) camionesTaller.push_back(r.camion);
+		}
+		vector<pair<Centavos, uint64_t>> costoCamion;   // Costo y visitas de cada camionesTaller[i]
+		for (const string& c : camionesTaller) {
+			pair<Centavos, uint64_t> costo(0, 0);
+			for (const auto& r : taller) if (r.camion == c) { costo.first += r.total; ++costo.second; }
+			costoCamion.push_back(costo);
+		}
+		segAnidado += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+		// Ingresos, km y conteos deben coincidir por clave
+		auto buscar = [&hash](const string& c, const string& ch) -> const FilaReporte* {
+			for (const auto& f : hash) if (f.camion == c && f.chofer == ch) return &f;
+			return nullptr;
+		};
+		for (const auto& f : anidado) {
+			const FilaReporte* h = buscar(f.camion, f.chofer);
+			if (!h || h->ingresos != f.ingresos || h->registrosIngreso != f.registrosIngreso || h->registrosKm != f.registrosKm
+				|| fabs(h->km - f.km) > 1e-6 * max(1.0, f.km)) {
+				cout << "!!! ERROR: la clave " << f.camion << (porChofer ? " / " + f.chofer : "") << " no coincide con el join anidado.\n";
+				correcto = false;
+			}
+		}
+		// Costos: por camion, iguales; por chofer, las partes suman el costo del camion, ninguna
+		// es negativa y cada una queda a menos de un centavo de su cuota exacta por km
+		size_t filasEsperadas = anidado.size();
+		for (size_t i = 0; i < camionesTaller.size(); ++i) {
+			const string& c = camionesTaller[i];
+			const Centavos costo = costoCamion[i].first;
+			vector<const FilaReporte*> delCamion;
+			double kmCamion = 0.0;
+			for (const auto& f : hash) {
+				if (f.camion != c) continue;
+				delCamion.push_back(&f);
+				kmCamion += f.km;
+			}
+			bool sinChofer = none_of(anidado.begin(), anidado.end(), [&c](const FilaReporte& f) { return f.camion == c; });
+			if (sinChofer) ++filasEsperadas;
+			Centavos suma = 0;
+			uint64_t visitas = 0;
+			bool partesValidas = !delCamion.empty();
+			for (const FilaReporte* f : delCamion) {
+				suma += f->costos;
+				visitas += f->visitasTaller;
+				double cuota = kmCamion > 0.0 ? costo * (f->km / kmCamion) : static_cast<double>(costo) / delCamion.size();
+				if (f->costos < 0 || fabs(f->costos - cuota) >= 1.0 + 1e-6) partesValidas = false;
+			}
+			if (suma != costo || visitas != costoCamion[i].second || !partesValidas
+				|| (sinChofer && porChofer && (delCamion.size() != 1 || delCamion[0]->chofer != "(sin chofer)"))) {
+				cout << "!!! ERROR: el costo de taller del camion " << c << " no se reparte bien" << (porChofer ? " entre sus choferes" : "") << ".\n";
+				correcto = false;
+			}
+		}
+		if (hash.size() != filasEsperadas) {
+			cout << "!!! ERROR: el join por hash tiene " << hash.size() << " filas; se esperaban " << filasEsperadas << ".\n";
+			correcto = false;
+		}
+	}
 
-// ======================= MENÚ PRINCIPAL Y ORDENAMIENTO =======================
+	cout << "\n======= BENCHMARK: REPORTE CRUZADO (JOIN POR HASH) =======\n"
+		<< n << " ingresos, " << n << " km y " << taller.size() << " visitas de taller; " << filasReporte << " filas (por camion y por chofer)\n"
+		<< "Hash (lee los CSV):   " << fixed << setprecision(3) << segHash * 1e3 << " ms\n"
+		<< "Ciclos anidados:      " << segAnidado * 1e3 << " ms\n"
+		<< "Reportes " << (correcto ? "identicos" : "DISTINTOS") << "\n";
+	filesystem::remove_all(dir);
+	return correcto ? 0 : 2;
+}
 
-void menuOrdenamientoYLista() {
-	int opcion = 0;
-	while (opcion != 4) {
-		// system("cls"); // Descomentar para limpiar
-		cout << "\n======== METODOS DE ORDENAMIENTO Y MANIPULACION DE LISTAS ========\n";
-		cout << "1. Metodo Burbuja (Ingresos) - C/ Menu de Listas Completo" << endl;
-		cout << "2. Metodo Seleccion (Costos de Taller) - C/ Menu de Listas Completo" << endl;
-		cout << "3. Metodo Insercion (Kilometraje) - C/ Menu de Listas Completo" << endl;
-		cout << "4. Regresar al menu principal" << endl;
-		cout << "Seleccione una opcion: ";
-		cin >> opcion;
-		limpiarBuffer();
-		// system("cls"); // Descomentar para limpiar
+// Carga una tabla generada y cuenta las asignaciones: leer y convertir las filas no debe
+// asignar más que lo que los registros guardan (su vector y sus textos largos), medido
+// copiando los registros ya cargados. Solo la lectura en sí (buffers, mapa de columnas) sobra.
+int benchmarkAsignaciones(uint64_t n, uint64_t semilla) {
+#if !CONTAR_ASIGNACIONES
+	(void)n; (void)semilla;
+	cout << "(Conteo de asignaciones deshabilitado en compilacion: CONTAR_ASIGNACIONES=0)\n";
+	return 0;
+#else
+	n = min<uint64_t>(n, 200000);
+	const uint64_t HOLGURA = 256;    // Asignaciones fijas de una carga, sin importar las filas
+	filesystem::path dir = filesystem::temp_directory_path() / ("bench_asignaciones_" + to_string(semilla));
+	filesystem::remove_all(dir);
+	filesystem::create_directories(dir);
+	const string ruta = (dir / NOMBRE_ARCHIVO_INGRESOS).string();
+	{
+		GeneradorAleatorio rng(semilla);
+		ofstream archivo(ruta, ios::out);
+		escribirEncabezadoCSV<IngresoRecord>(archivo, 7);
+		IngresoRecord r{ "", "", vector<Centavos>(7), 0, "2025-W01" };
+		for (uint64_t i = 0; i < n; ++i) {
+			r.camion = to_string(rng.rango(100, 999));
+			r.chofer = "Chofer de prueba numero " + to_string(rng.rango(1, 400)); // Más largo que el SSO
+			for (auto& v : r.ingresos) v = static_cast<Centavos>(rng.rango(0, 2000000));
+			r.total = sumaSerie(r.ingresos);
+			escribirRegistroCSV(archivo, r);
+		}
+	}
 
-		switch (opcion) {
-		case 1:
-			metodoBurbuja();
-			break;
-		case 2:
-			metodoSeleccion();
-			break;
-		case 3:
-			metodoInsercion();
-			break;
-		case 4:
-			cout << "Regresando al menu principal..." << endl;
-			break;
-		default:
-			cout << "Opcion invalida. Intente de nuevo." << endl;
-			limpiarPantalla();
-			break;
+	vector<IngresoRecord> registros;
+	registros.reserve(n);
+	uint64_t antes = asignacionesDelHilo;
+	auto inicio = chrono::steady_clock::now();
+	uint64_t filas = recorrerCSV<IngresoRecord>(ruta, [&registros](IngresoRecord& r, size_t) { registros.push_back(move(r)); });
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	const uint64_t enCarga = asignacionesDelHilo - antes;
+
+	antes = asignacionesDelHilo;
+	vector<IngresoRecord> copia(registros);
+	const uint64_t enRegistros = asignacionesDelHilo - antes;
+
+	bool correcto = filas == n && enCarga <= enRegistros + HOLGURA;
+	cout << "\n======= BENCHMARK: ASIGNACIONES AL CARGAR =======\n"
+		<< filas << " filas en " << fixed << setprecision(3) << segundos << " s\n" << setprecision(2)
+		<< "Carga:     " << enCarga << " asignaciones (" << static_cast<double>(enCarga) / max<uint64_t>(filas, 1) << " por fila)\n"
+		<< "Registros: " << enRegistros << " asignaciones (" << static_cast<double>(enRegistros) / max<uint64_t>(filas, 1) << " por fila)\n"
+		<< "Lectura " << (correcto ? "sin asignaciones por fila" : "CON ASIGNACIONES POR FILA") << " (limite: registros + " << HOLGURA << ")\n";
+	filesystem::remove_all(dir);
+	return correcto ? 0 : 2;
+#endif
+}
+
+// Búsquedas con el índice (rango y filtros de Bloom) contra recorrer toda la tabla: deben dar
+// las mismas filas. La tabla se arma con un .bloq de versión 2 (se actualiza al agregar), un
+// segundo agregado ya en versión 3 y filas que se quedan en el CSV.
+int benchmarkFiltros(uint64_t n, uint64_t semilla) {
+	n = max<uint64_t>(min<uint64_t>(n, 200000), 10);
+	const uint64_t CHOFERES = 5000;
+	const size_t FILAS_BLOQUE = 1000;
+	filesystem::path dir = filesystem::temp_directory_path() / ("bench_filtros_" + to_string(semilla));
+	filesystem::remove_all(dir);
+	filesystem::create_directories(dir);
+	const string ruta = (dir / NOMBRE_ARCHIVO_INGRESOS).string();
+	const string rutaBloq = rutaBloques(ruta);
+
+	GeneradorAleatorio rng(semilla);
+	IngresoRecord r{ "", "", vector<Centavos>(7), 0, "2025-W01" };
+	auto escribirFilas = [&](uint64_t cuantas, bool conEncabezado) {
+		ofstream archivo(ruta, conEncabezado ? ios::out : ios::app);
+		if (conEncabezado) escribirEncabezadoCSV<IngresoRecord>(archivo, 7);
+		archivo << fixed << setprecision(2);
+		for (uint64_t i = 0; i < cuantas; ++i) {
+			r.camion = to_string(rng.rango(100, 999));
+			r.chofer = "Chofer " + to_string(rng.rango(1, CHOFERES));
+			for (auto& v : r.ingresos) v = static_cast<Centavos>(rng.rango(0, 2000000));
+			r.total = sumaSerie(r.ingresos);
+			escribirRegistroCSV(archivo, r);
+		}
+	};
+
+	cout << "\n======= BENCHMARK: BUSQUEDAS CON FILTROS DEL INDICE =======\n";
+	bool correcto = true;
+	string error;
+	ResultadoCompactacion compactacion;
+	escribirFilas(n / 2, true);
+	{
+		ostringstream encabezado;
+		escribirEncabezadoCSV<IngresoRecord>(encabezado, 7);
+		string texto = encabezado.str();
+		texto.pop_back();
+		fstream bloq;
+		if (ArchivoBloques::crear(rutaBloq, texto)) bloq.open(rutaBloq, ios::binary | ios::in | ios::out);
+		uint32_t versionAnterior = 2;
+		bloq.seekp(sizeof(FIRMA_BLOQUES));
+		bloq.write(reinterpret_cast<const char*>(&versionAnterior), sizeof(versionAnterior));
+		if (!bloq) { cout << "!!! ERROR: No se pudo crear '" << rutaBloq << "'.\n"; filesystem::remove_all(dir); return 2; }
+	}
+	ArchivoBloques bloques;
+	bool actualizado = compactarTabla(ruta, false, FILAS_BLOQUE, compactacion, error) && bloques.abrir(rutaBloq, error)
+		&& bloques.versionArchivo() == VERSION_BLOQUES;
+	cout << "Version 2 -> " << VERSION_BLOQUES << " al agregar " << compactacion.bloques << " bloques: "
+		<< (actualizado ? "correcta" : "FALLO (" + error + ")") << "\n";
+	correcto = actualizado && correcto;
+	escribirFilas(n / 2, false);
+	bool agregado = compactarTabla(ruta, true, FILAS_BLOQUE, compactacion, error) && bloques.abrir(rutaBloq, error);
+	cout << "Segundo agregado (" << compactacion.bloques << " bloques, agrupados): " << (agregado ? "correcto" : "FALLO (" + error + ")") << "\n";
+	correcto = agregado && correcto;
+	escribirFilas(FILAS_BLOQUE / 2, false); // Se quedan en el CSV
+
+	struct Consulta { int campo; bool cualquierCampo; string valor; };
+	vector<Consulta> consultas;
+	for (int i = 0; i < 10; ++i) consultas.push_back({ 0, false, to_string(rng.rango(100, 999)) });
+	for (int i = 0; i < 10; ++i) consultas.push_back({ 1, false, "Chofer " + to_string(rng.rango(1, CHOFERES)) });
+	for (int i = 0; i < 5; ++i) consultas.push_back({ -1, true, "Chofer " + to_string(rng.rango(1, CHOFERES)) });
+	consultas.push_back({ 0, false, "50" });             // Fuera del rango de todos los bloques
+	consultas.push_back({ 1, false, "Nadie" });
+	consultas.push_back({ -1, true, "2025-W01" });       // En todas las filas (columna sin filtro)
+
+	using Clave = tuple<string, string, Centavos>;
+	vector<Clave> conIndice, todas;
+	double segundosIndice = 0, segundosTodas = 0;
+	uint64_t filasEncontradas = 0;
+	for (const auto& c : consultas) {
+		FiltroRegistros<IngresoRecord> filtro;
+		filtro.campo = c.campo;
+		filtro.cualquierCampo = c.cualquierCampo;
+		filtro.valor = c.valor;
+		conIndice.clear();
+		todas.clear();
+		auto inicio = chrono::steady_clock::now();
+		recorrerCSV<IngresoRecord>(ruta, [&](IngresoRecord& x, size_t) { conIndice.emplace_back(x.camion, x.chofer, x.total); }, nullptr, filtro);
+		auto medio = chrono::steady_clock::now();
+		recorrerCSV<IngresoRecord>(ruta, [&](IngresoRecord& x, size_t) {
+			bool coincide = c.cualquierCampo ? (x.camion == c.valor || x.chofer == c.valor || x.semana == c.valor)
+				: (c.campo == 0 ? x.camion : x.chofer) == c.valor;
+			if (coincide) todas.emplace_back(x.camion, x.chofer, x.total);
+		});
+		auto fin = chrono::steady_clock::now();
+		segundosIndice += chrono::duration<double>(medio - inicio).count();
+		segundosTodas += chrono::duration<double>(fin - medio).count();
+		filasEncontradas += todas.size();
+		if (conIndice != todas) {
+			cout << "!!! DIFERENCIA en " << (c.cualquierCampo ? string("cualquier campo") : string(EsquemaRegistro<IngresoRecord>::camposTexto[c.campo].columna)) << " = '" << c.valor << "': "
+				<< conIndice.size() << " filas con el indice, " << todas.size() << " recorriendo todo\n";
+			correcto = false;
 		}
 	}
+	cout << consultas.size() << " busquedas en " << bloques.indice().size() << " bloques (" << filasEncontradas << " filas encontradas)\n"
+		<< fixed << setprecision(3) << "Con el indice:   " << segundosIndice << " s\n"
+		<< "Recorriendo todo: " << segundosTodas << " s\n"
+		<< "Resultados " << (correcto ? "identicos" : "DISTINTOS") << "\n";
+	filesystem::remove_all(dir);
+	return correcto ? 0 : 2;
 }
 
+void mostrarUsoBenchmark() {
+	cout << "Uso: Proyecto7.0 --benchmark <nombre> [opciones]\n"
+		<< "  suma [--n <valores>] [--semilla <n>]   Exactitud y velocidad de sumaValores/sumaMontos\n"
+		<< "  ventas [--n <boletos>] [--semilla <n>] Lote de boletos contra un libro de ventas temporal\n"
+		<< "  terminales [--n <boletos>] [--hilos <n>] Escalamiento de ventas concurrentes (1..n terminales)\n"
+		<< "  nomina [--n <sueldos>] [--hilos <n>]   Acumulados de nomina secuencial contra paralelo\n"
+		<< "  guardado [--n <guardados>]            Guardados seguidos: escritura directa contra el escritor asincrono\n"
+		<< "  instantaneas [--n <versiones>] [--hilos <n>] Lectores de instantaneas contra un escritor (MVCC)\n"
+		<< "  series [--n <registros>]              Series de km: codificacion por columna contra por fila\n"
+		<< "  ordenes [--n <registros>]             Ordenes de la lista mantenidos con altas contra ordenar todo\n"
+		<< "  csv [--n <filas>]                     Casos del lector CSV y velocidad de lectura\n"
+		<< "  cruce [--n <filas>]                   Reporte cruzado por hash contra un join de ciclos anidados\n"
+		<< "  asignaciones [--n <filas>]            Asignaciones por fila al cargar una tabla (sin contar los registros)\n"
+		<< "  filtros [--n <filas>]                 Busquedas con el indice de bloques contra recorrer toda la tabla\n";
+}
 
+int ejecutarBenchmark(int argc, char* argv[]) {
+	if (argc < 3) { mostrarUsoBenchmark(); return 1; }
+	string nombre = argv[2];
+	uint64_t n = 10000000, semilla = 1;
+	size_t hilos = max(1u, thread::hardware_concurrency());
+	for (int i = 3; i < argc; ++i) {
+		string arg = argv[i];
+		bool tieneValor = i + 1 < argc;
+		if (arg == "--n" && tieneValor) n = max<uint64_t>(1, strtoull(argv[++i], nullptr, 10));
+		else if (arg == "--semilla" && tieneValor) semilla = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--hilos" && tieneValor) hilos = max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+		else { mostrarUsoBenchmark(); return 1; }
+	}
+	if (nombre == "suma") return benchmarkSuma(n, semilla);
+	if (nombre == "ventas") return benchmarkVentas(n, semilla);
+	if (nombre == "terminales") return benchmarkTerminales(n, semilla, hilos);
+	if (nombre == "nomina") return benchmarkNomina(n, semilla, hilos);
+	if (nombre == "guardado") return benchmarkGuardado(n, semilla);
+	if (nombre == "instantaneas") return benchmarkInstantaneas(n, semilla, hilos);
+	if (nombre == "series") return benchmarkSeries(n, semilla);
+	if (nombre == "ordenes") return benchmarkOrdenes(n, semilla);
+	if (nombre == "csv") return benchmarkCSV(n);
+	if (nombre == "cruce") return benchmarkCruce(n, semilla);
+	if (nombre == "asignaciones") return benchmarkAsignaciones(n, semilla);
+	if (nombre == "filtros") return benchmarkFiltros(n, semilla);
+	mostrarUsoBenchmark();
+	return 1;
+}
 
-// ======================= VENTAS CON PUNTEROS =======================
-void menuVentasPunteros() {
-	cout << "\n======= MODULO DE VENTAS (USO DE PUNTEROS) =======" << endl;
-	cout << "Bienvenido al sistema de venta de boletos." << endl;
 
-	// 1. Declaración de variables locales
-	string vendedor;
-	int numVenta = 0;
-	double totalVenta = 0.0;
-	double porcentajeDescuento = 0.0;
-	double montoFinal = 0.0;
+// ======================= ARRANQUE (MÓDULOS PEREZOSOS Y PRECARGA) =======================
+// El menú se muestra sin cargar nada: cada módulo se inicia la primera vez que se usa
+// (asegurarModulo) y, mientras el usuario lee el menú, un hilo de precarga los va iniciando
+// en orden. Un módulo lo inicia solo uno de los dos: si el usuario llega mientras la precarga
+// lo está armando, espera a que termine. Los acumulados de ingresos, taller y km no se
+// comparten con la precarga: al entrar al menú que los usa se reclaman (reclamarModulo); si
+// la precarga los está armando se interrumpe su pasada, y quedan para armarse al consultarlos,
+// como antes. Al salir, detenerPrecarga() también interrumpe el módulo en curso. Un módulo
+// que falla (los registros no abren) no queda listo: se reintenta en el siguiente uso.
+// La nómina y el patio no tienen nada que precargar (la nómina se lee del archivo que se elige
+// y el patio empieza vacío). Los tiempos se ven en Diagnosticos y con --perfil-arranque.
+
+class ArranqueModulos {
+	enum class EstadoModulo { Pendiente, EnCurso, Listo, Reclamado, Fallido };
+
+	struct EntradaModulo {
+		const char* nombre;
+		bool (*iniciar)(const atomic<bool>* detener); // false si no quedó listo (falló o se interrumpió)
+		EstadoModulo estado = EstadoModulo::Pendiente;
+		bool enPrecarga = false;      // Lo inició el hilo de precarga (no el primer uso)
+		atomic<bool> interrumpir{ false }; // Corta la pasada que lleva la precarga
+		double milisegundos = 0.0;
+		double desdeInicio = 0.0;     // ms desde el arranque del programa hasta que quedó listo
+	};
+
+	array<EntradaModulo, static_cast<size_t>(Modulo::Total)> modulos = { {
+		{ "ventas (descuentos y libro)", [](const atomic<bool>*) { iniciarMotorVentas(); return true; } },
+		{ "registros (choferes y unidades)", [](const atomic<bool>*) { return cargarRegistros(); } },
+		{ "ingresos (rollups)", [](const atomic<bool>* detener) { return rollupIngresos.asegurarVigente(detener); } },
+		{ "taller (anomalias)", [](const atomic<bool>* detener) { return anomaliasTabla<TallerRecord>.asegurarVigente(detener); } },
+		{ "kilometraje (anomalias)", [](const atomic<bool>* detener) { return anomaliasTabla<KilometrajeRecord>.asegurarVigente(detener); } },
+	} };
+	mutex candado;
+	condition_variable terminado;
+	double msPrimerMenu = -1.0;
+	atomic<bool> detener{ false };
+	thread precarga;
+
+	double msDesdeInicio() const { return chrono::duration<double, milli>(chrono::steady_clock::now() - INICIO_PROGRAMA).count(); }
+
+	// Con el candado tomado (se suelta mientras corre la inicialización). Solo la precarga se
+	// puede interrumpir: el primer uso necesita el módulo completo
+	void iniciar(unique_lock<mutex>& guardia, EntradaModulo& m, bool desdePrecarga) {
+		m.estado = EstadoModulo::EnCurso;
+		m.enPrecarga = desdePrecarga;
+		m.interrumpir = false;
+		guardia.unlock();
+		auto inicio = chrono::steady_clock::now();
+		bool listo = m.iniciar(desdePrecarga ? &m.interrumpir : nullptr);
+		double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+		guardia.lock();
+		m.milisegundos = ms;
+		m.desdeInicio = msDesdeInicio();
+		m.estado = listo ? EstadoModulo::Listo : m.interrumpir ? EstadoModulo::Pendiente : EstadoModulo::Fallido;
+		terminado.notify_all();
+	}
 
-	// 2. Declaración de PUNTEROS
-	string* pVendedor = &vendedor;
-	int* pNumVenta = &numVenta;
-	double* pTotalVenta = &totalVenta;
-	double* pPorcentaje = &porcentajeDescuento;
-	double* pFinal = &montoFinal;
+public:
+	~ArranqueModulos() { detenerPrecarga(); }
 
-	// 3. Solicitar datos usando punteros (Requisito de imagen)
-	cout << "Ingrese el nombre del vendedor (Taquillero): ";
-	// Usamos getline con el contenido apuntado por pVendedor
-	getline(cin, *pVendedor);
+	// @return false si el módulo falló (se vuelve a intentar en la siguiente llamada)
+	bool asegurar(Modulo modulo) {
+		EntradaModulo& m = modulos[static_cast<size_t>(modulo)];
+		unique_lock<mutex> guardia(candado);
+		terminado.wait(guardia, [&m]() { return m.estado != EstadoModulo::EnCurso; });
+		if (m.estado != EstadoModulo::Listo) iniciar(guardia, m, false);
+		return m.estado == EstadoModulo::Listo;
+	}
 
-	cout << "Ingrese el numero de venta (ID de Boleto): ";
-	cin >> *pNumVenta;
-	limpiarBuffer();
+	void reclamar(Modulo modulo) {
+		EntradaModulo& m = modulos[static_cast<size_t>(modulo)];
+		unique_lock<mutex> guardia(candado);
+		if (m.estado == EstadoModulo::EnCurso && m.enPrecarga) m.interrumpir = true;
+		terminado.wait(guardia, [&m]() { return m.estado != EstadoModulo::EnCurso; });
+		if (m.estado == EstadoModulo::Pendiente) m.estado = EstadoModulo::Reclamado;
+	}
 
-	cout << "Ingrese el total de la venta (Costo del Boleto): $";
-	cin >> *pTotalVenta;
-	limpiarBuffer();
+	// Inicia en un hilo los módulos que sigan pendientes, en orden
+	void iniciarPrecarga() {
+		precarga = thread([this]() {
+			for (EntradaModulo& m : modulos) {
+				unique_lock<mutex> guardia(candado);
+				if (detener) return;
+				if (m.estado == EstadoModulo::Pendiente) iniciar(guardia, m, true);
+			}
+		});
+	}
 
-	// 4. Definir porcentaje de descuento (Requisito: DEFINIR EL PORCENTAJE)
-	cout << "\n--- Seleccione tipo de descuento ---" << endl;
-	cout << "1. Estudiante (50%)" << endl;
-	cout << "2. INAPAM / Tercera Edad (20%)" << endl;
-	cout << "3. General / Sin Descuento (0%)" << endl;
-	cout << "4. Otro porcentaje personalizado" << endl;
-	cout << "Opcion: ";
-
-	int opcDesc;
-	cin >> opcDesc;
-	limpiarBuffer();
+	// No empieza módulos nuevos e interrumpe el que esté en curso (queda pendiente)
+	void detenerPrecarga() {
+		{
+			lock_guard<mutex> guardia(candado);
+			detener = true;
+			for (EntradaModulo& m : modulos) if (m.estado == EstadoModulo::EnCurso && m.enPrecarga) m.interrumpir = true;
+		}
+		if (precarga.joinable()) precarga.join();
+	}
 
-	switch (opcDesc) {
-	case 1: *pPorcentaje = 0.50; break; // 50%
-	case 2: *pPorcentaje = 0.20; break; // 20%
-	case 3: *pPorcentaje = 0.00; break; // 0%
-	case 4:
-		cout << "Ingrese el porcentaje manual (ej. 10 para 10%): ";
-		cin >> *pPorcentaje;
-		*pPorcentaje = *pPorcentaje / 100.0; // Convertir a decimal
-		limpiarBuffer();
-		break;
-	default:
-		cout << "Opcion no valida. Se aplicara 0% descuento." << endl;
-		*pPorcentaje = 0.0;
+	void esperarPrecarga() {
+		if (precarga.joinable()) precarga.join();
 	}
 
-	// 5. Calcular total usando punteros
-	// Descuento = Total * Porcentaje
-	double descuentoAplicado = (*pTotalVenta) * (*pPorcentaje);
+	// Se llama justo antes de mostrar el primer menú
+	void menuListo() {
+		lock_guard<mutex> guardia(candado);
+		if (msPrimerMenu < 0.0) msPrimerMenu = msDesdeInicio();
+	}
 
-	// Total Final = Total - Descuento
-	*pFinal = *pTotalVenta - descuentoAplicado;
+	void reporte(ostream& out) {
+		lock_guard<mutex> guardia(candado);
+		out << "======= PERFIL DE ARRANQUE =======\n" << fixed << setprecision(2);
+		if (msPrimerMenu >= 0.0) out << "Primer menu listo a los " << msPrimerMenu << " ms\n";
+		out << left << setw(34) << "MODULO" << setw(14) << "ESTADO" << right << setw(12) << "DURACION" << setw(14) << "LISTO A LOS" << "\n";
+		for (const EntradaModulo& m : modulos) {
+			out << left << setw(34) << m.nombre;
+			if (m.estado == EstadoModulo::Listo) {
+				out << setw(14) << (m.enPrecarga ? "precarga" : "primer uso") << right << setw(9) << m.milisegundos << " ms"
+					<< setw(11) << m.desdeInicio << " ms\n";
+			}
+			else {
+				out << (m.estado == EstadoModulo::EnCurso ? "en curso" : m.estado == EstadoModulo::Reclamado ? "al consultarse"
+					: m.estado == EstadoModulo::Fallido ? "fallo (se reintenta al usarlo)" : "sin iniciar") << "\n";
+			}
+		}
+		out << right;
+	}
+};
 
-	// 6. Mostrar resultados
-	cout << "\n========== TICKET DE VENTA ==========" << endl;
-	cout << "Vendedor: " << *pVendedor << endl;
-	cout << "Folio Venta: " << *pNumVenta << endl;
-	cout << "Subtotal: $" << fixed << setprecision(2) << *pTotalVenta << endl;
-	cout << "Descuento aplicado (" << (*pPorcentaje * 100) << "%): -$" << descuentoAplicado << endl;
-	cout << "TOTAL A PAGAR: $" << *pFinal << endl;
-	cout << "=====================================" << endl;
+ArranqueModulos arranque;
 
-	// Pausa para que el usuario pueda leer
-	cout << "\nVenta registrada correctamente." << endl;
+bool asegurarModulo(Modulo modulo) { return arranque.asegurar(modulo); }
+void reclamarModulo(Modulo modulo) { arranque.reclamar(modulo); }
+void mostrarPerfilArranque() { arranque.reporte(cout); }
+
+// Modo de linea de comandos: Proyecto7.0 --perfil-arranque
+// Arranca como el menú (sin mostrarlo), espera a la precarga y muestra los tiempos
+int ejecutarPerfilArranque() {
+	arranque.iniciarPrecarga();
+	arranque.menuListo();
+	arranque.esperarPrecarga();
+	arranque.reporte(cout);
+	return 0;
 }
 
 
 // ======================= MAIN =======================
-int main() {
+int main(int argc, char* argv[]) {
+	// Modos de linea de comandos (sin menu interactivo)
+	if (argc > 1 && string(argv[1]) == "--generar-datos") {
+		return ejecutarGeneradorDatos(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--benchmark") {
+		return ejecutarBenchmark(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--ventas") {
+		return ejecutarLoteVentas(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--nomina") {
+		return ejecutarNomina(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--reporte") {
+		return ejecutarReporte(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--validar") {
+		return ejecutarValidacion(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--series") {
+		return ejecutarSeries(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--anomalias") {
+		return ejecutarAnomalias(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--exportar") {
+		return ejecutarExportacion(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--consulta") {
+		return ejecutarConsulta(argc, argv);
+	}
+	if (argc > 1 && string(argv[1]) == "--servidor") {
+		return ejecutarServidor(argc, argv);
+	}
+	if (argc > 1 && (string(argv[1]) == "--cliente" || string(argv[1]) == "--carga-servidor")) {
+		return ejecutarClienteServidor(argc, argv);
+	}
+	if (argc > 1 && (string(argv[1]) == "--comprimir" || string(argv[1]) == "--descomprimir" || string(argv[1]) == "--bloques")) {
+		return ejecutarBloques(argc, argv);
+	}
+
+	if (argc > 1 && string(argv[1]) == "--perfil-arranque") {
+		return ejecutarPerfilArranque();
+	}
+
+	// Nada se carga antes del menú: los módulos se precargan en otro hilo (ver ARRANQUE)
+	arranque.iniciarPrecarga();
+
 	int opcion = 0;
 
 	// Usamos los datos por defecto creados globalmente
 	DatosEmpresa miEmpresa = datosDefault;
 
-	while (opcion != 8) {
+	while (opcion != 9) {
+		arranque.menuListo();
+		reportarFallosEscritura();
 		cout << "\n======= MENU PRINCIPAL =======" << endl;
 		cout << "1. Datos de la Empresa (Funciones y Estructuras)" << endl;
-		cout << "2. Registrar y mostrar chofer (Funciones y Estructuras)" << endl;
-		cout << "3. Registrar y mostrar Unidad de Transporte (Funciones y Estructuras)" << endl;
-		cout << "4. Ventas (Punteros)" << endl;
-		cout << "5. Calculo de sueldo acumulado (Recursividad)" << endl;
+		cout << "2. Choferes: registrar, buscar y listar (Estructuras y archivo)" << endl;
+		cout << "3. Unidades de Transporte: registrar, buscar y listar (Estructuras y archivo)" << endl;
+		cout << "4. Ventas de boletos (Punteros y lotes)" << endl;
+		cout << "5. Calculo de sueldo acumulado (Recursividad y nomina)" << endl;
 		cout << "6. Metodos de busqueda" << endl;
 		cout << "7. Registro de Entradas y Salidas de Camiones (Pilas)" << endl;
-		cout << "8. Salir" << endl;
+		cout << "8. Diagnosticos (Metricas de rendimiento)" << endl;
+		cout << "9. Salir" << endl;
 		cout << "Seleccione una opcion: ";
 		cin >> opcion;
 		limpiarBuffer();
@@ -1642,42 +9553,20 @@ int main() {
 			pausaYLimpiar();
 			break;
 
-		case 2: {
-			Chofer nuevoChofer;
-			cout << "======= INGRESO DE DATOS DEL CHOFER =======" << endl;
-			nuevoChofer.nombre = pedirTexto("Ingrese nombre del chofer: ");
-			nuevoChofer.id = pedirEntero("Ingrese numero de chofer: ");
-			int anioNacimiento = pedirEntero("Ingrese anio de nacimiento del chofer: ");
-			nuevoChofer.edad = 2025 - anioNacimiento;
-			nuevoChofer.telefono = pedirTexto("Ingrese telefono del chofer: ");
-			nuevoChofer.codigoPostal = pedirEntero("Ingrese codigo postal del chofer: ");
-			mostrarChofer(nuevoChofer);
-			pausaYLimpiar();
+		case 2:
+			menuChoferes();
 			break;
-		}
 
-		case 3: {
-			UnidadTransporte nuevaUnidad;
-			cout << "======= INGRESO DE DATOS DE LA UNIDAD =======" << endl;
-			nuevaUnidad.idCamion = pedirEntero("Ingrese ID del camion: ");
-			nuevaUnidad.placas = pedirEntero("Ingrese numero de placas (solo numeros): ");
-			nuevaUnidad.color = pedirTexto("Ingrese color del camion: ");
-			nuevaUnidad.anio = pedirEntero("Ingrese anio del camion: ");
-			nuevaUnidad.choferAsignado = pedirTexto("Ingrese nombre del chofer asignado: ");
-			nuevaUnidad.aniosEnEmpresa = pedirEntero("Ingrese anios en la empresa del chofer: ");
-			mostrarUnidad(nuevaUnidad);
-			pausaYLimpiar();
+		case 3:
+			menuUnidades();
 			break;
-		}
 
 		case 4:
-			menuVentasPunteros();
-			pausaYLimpiar();
+			menuVentas();
 			break;
 
 		case 5:
-			menuCalculoSueldoRecursivo();
-			pausaYLimpiar();
+			menuNomina();
 			break;
 
 		case 6:
@@ -1689,6 +9578,16 @@ int main() {
 			break;
 
 		case 8:
+			menuDiagnosticos();
+			break;
+
+		case 9:
+			arranque.detenerPrecarga();
+			// Lo guardado debe quedar en disco antes de salir
+			if (!escritorArchivos.sincronizar()) {
+				reportarFallosEscritura();
+				cout << "!!! ERROR: Algunos cambios no se pudieron escribir en disco.\n";
+			}
 			cout << "Saliendo del programa. ¡Hasta pronto!" << endl;
 			break;
 